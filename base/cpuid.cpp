@@ -0,0 +1,74 @@
+
+#include "base/cpuid.hpp"
+
+#include <cstdint>
+
+#include "base/macros.hpp"
+
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace principia {
+namespace base {
+
+namespace {
+
+struct CPUIDResult {
+  std::uint32_t eax;
+  std::uint32_t ebx;
+  std::uint32_t ecx;
+  std::uint32_t edx;
+};
+
+CPUIDResult CPUID(std::uint32_t const eax, std::uint32_t const ecx) {
+  CPUIDResult result;
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+  int registers[4];
+  __cpuidex(registers, eax, ecx);
+  result.eax = registers[0];
+  result.ebx = registers[1];
+  result.ecx = registers[2];
+  result.edx = registers[3];
+#else
+  __cpuid_count(eax, ecx, result.eax, result.ebx, result.ecx, result.edx);
+#endif
+  return result;
+}
+
+// The extended control register XCR0, which tells us which register files the
+// operating system preserves.  Must only be called if OSXSAVE is set.
+std::uint64_t XCR0() {
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+  return _xgetbv(0);
+#else
+  std::uint32_t eax;
+  std::uint32_t edx;
+  __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+constexpr std::uint32_t osxsave_bit = 1 << 27;
+constexpr std::uint32_t avx_bit = 1 << 28;
+
+// The XMM and YMM state.
+constexpr std::uint64_t xcr0_avx_mask = 0x06;
+
+bool OSSavesState(std::uint64_t const mask) {
+  return (CPUID(1, 0).ecx & osxsave_bit) != 0 && (XCR0() & mask) == mask;
+}
+
+}  // namespace
+
+bool HasAVX() {
+  static bool const has_avx =
+      (CPUID(1, 0).ecx & avx_bit) != 0 && OSSavesState(xcr0_avx_mask);
+  return has_avx;
+}
+
+}  // namespace base
+}  // namespace principia
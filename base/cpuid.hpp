@@ -0,0 +1,11 @@
+#pragma once
+
+namespace principia {
+namespace base {
+
+// Returns true if the processor supports the AVX instructions and the operating
+// system saves the YMM registers on context switches.
+bool HasAVX();
+
+}  // namespace base
+}  // namespace principia
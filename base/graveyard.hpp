@@ -4,7 +4,7 @@
 #include <cstdint>
 #include <memory>
 
-#include "base/thread_pool.hpp"
+#include "base/task_scheduler.hpp"
 
 namespace principia {
 namespace base {
@@ -17,7 +17,7 @@ class Graveyard {
   void Bury(std::unique_ptr<T> t);
 
  private:
-  ThreadPool<void> gravedigger_;
+  TaskScheduler gravedigger_;
 };
 
 }  // namespace base
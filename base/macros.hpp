@@ -126,6 +126,15 @@ inline void noreturn() { std::exit(0); }
 // 64-bit architectures.
 #define PRINCIPIA_USE_SSE3_INTRINSICS !_DEBUG
 
+// Used to compile a function for an instruction set extension that is not
+// enabled for the entire build.  Such a function must only be called after
+// checking for processor support using base/cpuid.hpp.
+#if PRINCIPIA_COMPILER_MSVC
+#  define PRINCIPIA_TARGET(features)
+#else
+#  define PRINCIPIA_TARGET(features) __attribute__((target(features)))
+#endif
+
 // Thread-safety analysis.
 #if PRINCIPIA_COMPILER_CLANG || PRINCIPIA_COMPILER_CLANG_CL
 #  define THREAD_ANNOTATION_ATTRIBUTE__(x) __attribute__((x))
@@ -0,0 +1,134 @@
+#include "base/mapped_file.hpp"
+
+#include "base/macros.hpp"
+#include "glog/logging.h"
+
+#if OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+// In both implementations, the handles of the file and of the mapping are
+// closed as soon as the view exists: the view keeps the file alive.
+#if OS_WIN
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+  HANDLE const file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                  /*lpSecurityAttributes=*/nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  /*hTemplateFile=*/nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    LOG(ERROR) << "Cannot open " << path << " " << GetLastError();
+    return;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    LOG(ERROR) << "Cannot get the size of " << path << " " << GetLastError();
+    CloseHandle(file);
+    return;
+  }
+  // Windows refuses to map empty files.
+  if (size.QuadPart > 0) {
+    HANDLE const mapping =
+        CreateFileMappingW(file,
+                           /*lpFileMappingAttributes=*/nullptr,
+                           PAGE_READONLY,
+                           /*dwMaximumSizeHigh=*/0,
+                           /*dwMaximumSizeLow=*/0,
+                           /*lpName=*/nullptr);
+    if (mapping == nullptr) {
+      LOG(ERROR) << "Cannot map " << path << " " << GetLastError();
+      CloseHandle(file);
+      return;
+    }
+    void const* const data = MapViewOfFile(mapping,
+                                           FILE_MAP_READ,
+                                           /*dwFileOffsetHigh=*/0,
+                                           /*dwFileOffsetLow=*/0,
+                                           /*dwNumberOfBytesToMap=*/0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+      LOG(ERROR) << "Cannot map " << path << " " << GetLastError();
+      CloseHandle(file);
+      return;
+    }
+    bytes_ = Array<std::uint8_t const>(
+        static_cast<std::uint8_t const*>(data), size.QuadPart);
+  }
+  CloseHandle(file);
+  ok_ = true;
+}
+
+MappedFile::~MappedFile() {
+  if (bytes_.data != nullptr && !UnmapViewOfFile(bytes_.data)) {
+    LOG(ERROR) << "Cannot unmap file " << GetLastError();
+  }
+}
+
+#else
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+  int const file = open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    PLOG(ERROR) << "Cannot open " << path;
+    return;
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0) {
+    PLOG(ERROR) << "Cannot get the size of " << path;
+    close(file);
+    return;
+  }
+  // POSIX refuses to map empty files.
+  if (status.st_size > 0) {
+    void* const data = mmap(/*addr=*/nullptr,
+                            status.st_size,
+                            PROT_READ,
+                            MAP_SHARED,
+                            file,
+                            /*offset=*/0);
+    if (data == MAP_FAILED) {
+      PLOG(ERROR) << "Cannot map " << path;
+      close(file);
+      return;
+    }
+    bytes_ = Array<std::uint8_t const>(static_cast<std::uint8_t const*>(data),
+                                       status.st_size);
+  }
+  // The mapping, if any, is valid even if closing fails.
+  PLOG_IF(ERROR, close(file) != 0) << "Cannot close " << path;
+  ok_ = true;
+}
+
+MappedFile::~MappedFile() {
+  if (bytes_.data != nullptr) {
+    PLOG_IF(ERROR,
+            munmap(const_cast<std::uint8_t*>(bytes_.data), bytes_.size) != 0)
+        << "Cannot unmap file";
+  }
+}
+
+#endif
+
+bool MappedFile::ok() const {
+  return ok_;
+}
+
+Array<std::uint8_t const> MappedFile::bytes() const {
+  return bytes_;
+}
+
+}  // namespace internal_mapped_file
+}  // namespace base
+}  // namespace principia
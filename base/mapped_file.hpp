@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "base/array.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+// A read-only mapping of a file in memory.  The pages are loaded lazily by the
+// operating system and are shared with the other processes that map the same
+// file.  The file must not be modified while it is mapped.  Note that on
+// Windows a mapped file cannot be deleted or replaced.
+class MappedFile final {
+ public:
+  // Maps the entire file at |path|.  If this fails, e.g., because the file
+  // doesn't exist or cannot be read, the error is logged and |ok| returns
+  // false.
+  explicit MappedFile(std::filesystem::path const& path);
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+
+  // Whether the file was mapped.
+  bool ok() const;
+
+  // The contents of the file, valid for the lifetime of this object.  Empty if
+  // the file could not be mapped.
+  Array<std::uint8_t const> bytes() const;
+
+ private:
+  bool ok_ = false;
+  Array<std::uint8_t const> bytes_;
+};
+
+}  // namespace internal_mapped_file
+
+using internal_mapped_file::MappedFile;
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,55 @@
+#include "base/mapped_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+class MappedFileTest : public ::testing::Test {
+ protected:
+  MappedFileTest()
+      : path_(std::filesystem::temp_directory_path() /
+              "principia_mapped_file_test") {}
+
+  ~MappedFileTest() override {
+    std::filesystem::remove(path_);
+  }
+
+  void WriteFile(std::string const& contents) {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file << contents;
+  }
+
+  std::filesystem::path const path_;
+};
+
+TEST_F(MappedFileTest, Contents) {
+  std::string const contents = std::string("a\0b", 3) + std::string(10000, 'c');
+  WriteFile(contents);
+  MappedFile const file(path_);
+  EXPECT_TRUE(file.ok());
+  EXPECT_EQ(contents.size(), file.bytes().size);
+  EXPECT_EQ(contents,
+            std::string(reinterpret_cast<char const*>(file.bytes().data),
+                        file.bytes().size));
+}
+
+TEST_F(MappedFileTest, Empty) {
+  WriteFile("");
+  MappedFile const file(path_);
+  EXPECT_TRUE(file.ok());
+  EXPECT_EQ(0, file.bytes().size);
+}
+
+TEST_F(MappedFileTest, Missing) {
+  MappedFile const file(path_);
+  EXPECT_FALSE(file.ok());
+  EXPECT_EQ(0, file.bytes().size);
+}
+
+}  // namespace base
+}  // namespace principia
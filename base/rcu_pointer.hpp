@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace principia {
+namespace base {
+namespace internal_rcu_pointer {
+
+// The number of |RCUPointer| reads that a thread may have outstanding at the
+// same time, e.g., for nested lookups in different trajectories.
+constexpr int max_nested_reads = 4;
+
+// A slot in which a thread announces the objects that it is reading.  Each
+// slot is owned by a single thread and occupies its own cache line, so
+// announcing doesn't cause contention with other threads.
+struct alignas(64) HazardSlot final {
+  std::atomic<void const*> pointers[max_nested_reads] = {};
+  std::atomic_bool in_use = false;
+  // The number of reads outstanding on the owning thread, i.e., the index of
+  // the next free element of |pointers|.  Only accessed by the owning thread.
+  int depth = 0;
+  // Immutable once the slot has been added to the list of slots.
+  HazardSlot* next = nullptr;
+};
+
+// Returns the hazard slot of the current thread.  Slots are recycled when
+// threads exit.
+HazardSlot& ThisThreadHazardSlot();
+
+// Calls |f| on the pointer announced in each slot.
+template<typename F>
+void ForEachHazardPointer(F const& f);
+
+// A read-copy-update pointer to an immutable object of type |T|.  The pointee
+// may be replaced by a writer while any number of threads are reading the
+// previous one without locking.  The replaced objects are destroyed by the
+// writer once no reader refers to them anymore.
+// Reading is wait-free if there are no concurrent writes, and involves no
+// read-modify-write operation on shared memory.  The writers must be
+// synchronized externally.  A thread may have at most |max_nested_reads|
+// reads outstanding at a time; the reads must be nested.
+template<typename T>
+class RCUPointer final {
+ public:
+  // An RAII object that keeps the pointee alive while it is being read.
+  class ReadLock final {
+   public:
+    explicit ReadLock(RCUPointer const& rcu_pointer);
+    ~ReadLock();
+
+    ReadLock(ReadLock const&) = delete;
+    ReadLock(ReadLock&&) = delete;
+    ReadLock& operator=(ReadLock const&) = delete;
+    ReadLock& operator=(ReadLock&&) = delete;
+
+    // May return null if nothing was ever published.
+    T const* get() const;
+    T const& operator*() const;
+    T const* operator->() const;
+
+   private:
+    HazardSlot& slot_;
+    std::atomic<void const*>& hazard_pointer_;
+    T const* pointee_;
+  };
+
+  RCUPointer() = default;
+  ~RCUPointer();
+
+  RCUPointer(RCUPointer const&) = delete;
+  RCUPointer(RCUPointer&&) = delete;
+  RCUPointer& operator=(RCUPointer const&) = delete;
+  RCUPointer& operator=(RCUPointer&&) = delete;
+
+  // Replaces the pointee with |value|.  Must be synchronized with the other
+  // writer functions.
+  void Publish(std::unique_ptr<T const> value);
+
+  // Returns the current pointee, or null if nothing was ever published.  Must
+  // be synchronized with the other writer functions; readers must use a
+  // |ReadLock|.
+  T const* writer_get() const;
+
+ private:
+  // Destroys the retired objects that are not being read.
+  void Reclaim();
+
+  std::atomic<T const*> pointee_ = nullptr;
+  std::vector<std::unique_ptr<T const>> retired_;
+};
+
+}  // namespace internal_rcu_pointer
+
+using internal_rcu_pointer::RCUPointer;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/rcu_pointer_body.hpp"
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "base/rcu_pointer.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_rcu_pointer {
+
+// The head of the list of all the slots ever created.  Slots are never
+// deallocated, so the list only grows, up to the maximum number of threads
+// that have been reading simultaneously.
+inline std::atomic<HazardSlot*>& HazardSlots() {
+  static std::atomic<HazardSlot*> head = nullptr;
+  return head;
+}
+
+// Acquires a slot for the lifetime of a thread.
+class HazardSlotOwner final {
+ public:
+  HazardSlotOwner();
+  ~HazardSlotOwner();
+
+  HazardSlot& slot() const;
+
+ private:
+  HazardSlot* slot_ = nullptr;
+};
+
+inline HazardSlotOwner::HazardSlotOwner() {
+  auto& head = HazardSlots();
+  // Try to recycle a slot released by a thread that exited.
+  for (HazardSlot* slot = head.load(std::memory_order_acquire);
+       slot != nullptr;
+       slot = slot->next) {
+    bool expected = false;
+    if (slot->in_use.compare_exchange_strong(expected,
+                                             true,
+                                             std::memory_order_acquire)) {
+      slot_ = slot;
+      return;
+    }
+  }
+  slot_ = new HazardSlot;
+  slot_->in_use.store(true, std::memory_order_relaxed);
+  slot_->next = head.load(std::memory_order_relaxed);
+  while (!head.compare_exchange_weak(slot_->next,
+                                     slot_,
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {}
+}
+
+inline HazardSlotOwner::~HazardSlotOwner() {
+  for (auto& pointer : slot_->pointers) {
+    pointer.store(nullptr, std::memory_order_release);
+  }
+  slot_->depth = 0;
+  slot_->in_use.store(false, std::memory_order_release);
+}
+
+inline HazardSlot& HazardSlotOwner::slot() const {
+  return *slot_;
+}
+
+inline HazardSlot& ThisThreadHazardSlot() {
+  thread_local HazardSlotOwner const owner;
+  return owner.slot();
+}
+
+// Returns the next free hazard pointer of |slot|, which must belong to the
+// current thread.
+inline std::atomic<void const*>& PushHazardPointer(HazardSlot& slot) {
+  CHECK_LT(slot.depth, max_nested_reads) << "Too many nested reads";
+  return slot.pointers[slot.depth++];
+}
+
+template<typename F>
+void ForEachHazardPointer(F const& f) {
+  for (HazardSlot const* slot = HazardSlots().load(std::memory_order_acquire);
+       slot != nullptr;
+       slot = slot->next) {
+    for (auto const& pointer : slot->pointers) {
+      f(pointer.load(std::memory_order_seq_cst));
+    }
+  }
+}
+
+template<typename T>
+RCUPointer<T>::ReadLock::ReadLock(RCUPointer const& rcu_pointer)
+    : slot_(ThisThreadHazardSlot()),
+      hazard_pointer_(PushHazardPointer(slot_)),
+      pointee_(rcu_pointer.pointee_.load(std::memory_order_acquire)) {
+  // Announce the pointee, and check that it was not replaced (and possibly
+  // reclaimed) before the announcement became visible to the writer.  The
+  // sequential consistency of the store and of the load ensures that the
+  // writer either sees our announcement or publishes its replacement before
+  // our load.
+  for (;;) {
+    hazard_pointer_.store(pointee_, std::memory_order_seq_cst);
+    T const* const pointee =
+        rcu_pointer.pointee_.load(std::memory_order_seq_cst);
+    if (pointee == pointee_) {
+      break;
+    }
+    pointee_ = pointee;
+  }
+}
+
+template<typename T>
+RCUPointer<T>::ReadLock::~ReadLock() {
+  --slot_.depth;
+  CHECK_EQ(&slot_.pointers[slot_.depth], &hazard_pointer_)
+      << "Reads not nested";
+  hazard_pointer_.store(nullptr, std::memory_order_release);
+}
+
+template<typename T>
+T const* RCUPointer<T>::ReadLock::get() const {
+  return pointee_;
+}
+
+template<typename T>
+T const& RCUPointer<T>::ReadLock::operator*() const {
+  return *pointee_;
+}
+
+template<typename T>
+T const* RCUPointer<T>::ReadLock::operator->() const {
+  return pointee_;
+}
+
+template<typename T>
+RCUPointer<T>::~RCUPointer() {
+  // No reader may exist at this point, so |retired_| may be destroyed with
+  // the current pointee.
+  delete pointee_.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+void RCUPointer<T>::Publish(std::unique_ptr<T const> value) {
+  std::unique_ptr<T const> previous(
+      pointee_.exchange(value.release(), std::memory_order_seq_cst));
+  if (previous != nullptr) {
+    retired_.push_back(std::move(previous));
+  }
+  Reclaim();
+}
+
+template<typename T>
+T const* RCUPointer<T>::writer_get() const {
+  return pointee_.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+void RCUPointer<T>::Reclaim() {
+  std::vector<void const*> hazard_pointers;
+  ForEachHazardPointer([&hazard_pointers](void const* const pointer) {
+    if (pointer != nullptr) {
+      hazard_pointers.push_back(pointer);
+    }
+  });
+  std::sort(hazard_pointers.begin(),
+            hazard_pointers.end(),
+            std::less<void const*>());
+  std::vector<std::unique_ptr<T const>> still_read;
+  for (auto& retired : retired_) {
+    if (std::binary_search(hazard_pointers.begin(),
+                           hazard_pointers.end(),
+                           static_cast<void const*>(retired.get()),
+                           std::less<void const*>())) {
+      still_read.push_back(std::move(retired));
+    }
+  }
+  // The objects that are not being read are destroyed here.
+  retired_ = std::move(still_read);
+}
+
+}  // namespace internal_rcu_pointer
+}  // namespace base
+}  // namespace principia
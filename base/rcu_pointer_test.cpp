@@ -0,0 +1,167 @@
+
+#include "base/rcu_pointer.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+class RCUPointerTest : public ::testing::Test {
+ protected:
+  // An object that counts the live instances and detects use after
+  // destruction.
+  class Tracked {
+   public:
+    explicit Tracked(int const value) : value_(value), alive_(true) {
+      ++live_instances;
+    }
+    ~Tracked() {
+      alive_ = false;
+      --live_instances;
+    }
+
+    int value() const {
+      CHECK(alive_);
+      return value_;
+    }
+
+    static std::atomic_int live_instances;
+
+   private:
+    int const value_;
+    bool alive_;
+  };
+};
+
+std::atomic_int RCUPointerTest::Tracked::live_instances = 0;
+
+using RCUPointerDeathTest = RCUPointerTest;
+
+TEST_F(RCUPointerTest, Basics) {
+  {
+    RCUPointer<Tracked> rcu_pointer;
+    EXPECT_EQ(nullptr, rcu_pointer.writer_get());
+    {
+      RCUPointer<Tracked>::ReadLock const l(rcu_pointer);
+      EXPECT_EQ(nullptr, l.get());
+    }
+
+    rcu_pointer.Publish(std::make_unique<Tracked>(1));
+    {
+      RCUPointer<Tracked>::ReadLock const l(rcu_pointer);
+      EXPECT_EQ(1, l->value());
+    }
+    EXPECT_EQ(1, Tracked::live_instances);
+
+    // Nobody is reading, the previous object is destroyed immediately.
+    rcu_pointer.Publish(std::make_unique<Tracked>(2));
+    EXPECT_EQ(2, rcu_pointer.writer_get()->value());
+    EXPECT_EQ(1, Tracked::live_instances);
+  }
+  EXPECT_EQ(0, Tracked::live_instances);
+}
+
+TEST_F(RCUPointerTest, DeferredReclamation) {
+  {
+    RCUPointer<Tracked> rcu_pointer;
+    rcu_pointer.Publish(std::make_unique<Tracked>(1));
+    {
+      RCUPointer<Tracked>::ReadLock const l(rcu_pointer);
+      rcu_pointer.Publish(std::make_unique<Tracked>(2));
+      rcu_pointer.Publish(std::make_unique<Tracked>(3));
+      // The object being read is still alive, the other one was destroyed.
+      EXPECT_EQ(1, l->value());
+      EXPECT_EQ(2, Tracked::live_instances);
+    }
+    rcu_pointer.Publish(std::make_unique<Tracked>(4));
+    EXPECT_EQ(1, Tracked::live_instances);
+  }
+  EXPECT_EQ(0, Tracked::live_instances);
+}
+
+TEST_F(RCUPointerTest, NestedReads) {
+  {
+    RCUPointer<Tracked> rcu_pointer1;
+    RCUPointer<Tracked> rcu_pointer2;
+    rcu_pointer1.Publish(std::make_unique<Tracked>(1));
+    rcu_pointer2.Publish(std::make_unique<Tracked>(2));
+    {
+      RCUPointer<Tracked>::ReadLock const l1(rcu_pointer1);
+      {
+        RCUPointer<Tracked>::ReadLock const l2(rcu_pointer2);
+        rcu_pointer1.Publish(std::make_unique<Tracked>(3));
+        rcu_pointer2.Publish(std::make_unique<Tracked>(4));
+        // Both objects being read are still alive.
+        EXPECT_EQ(1, l1->value());
+        EXPECT_EQ(2, l2->value());
+        EXPECT_EQ(4, Tracked::live_instances);
+      }
+      // The inner read is over, but not the outer one.
+      rcu_pointer2.Publish(std::make_unique<Tracked>(5));
+      EXPECT_EQ(1, l1->value());
+      EXPECT_EQ(3, Tracked::live_instances);
+    }
+    rcu_pointer1.Publish(std::make_unique<Tracked>(6));
+    EXPECT_EQ(2, Tracked::live_instances);
+  }
+  EXPECT_EQ(0, Tracked::live_instances);
+}
+
+TEST_F(RCUPointerDeathTest, TooManyNestedReads) {
+  EXPECT_DEATH({
+    RCUPointer<Tracked> rcu_pointer;
+    std::vector<std::unique_ptr<RCUPointer<Tracked>::ReadLock>> locks;
+    for (int i = 0; i <= internal_rcu_pointer::max_nested_reads; ++i) {
+      locks.push_back(
+          std::make_unique<RCUPointer<Tracked>::ReadLock>(rcu_pointer));
+    }
+  }, "Too many nested reads");
+}
+
+// Readers check that they never see a destroyed object, and that the values
+// that they see are increasing.
+TEST_F(RCUPointerTest, ConcurrentReadersAndWriter) {
+#if defined(_DEBUG)
+  constexpr int number_of_publications = 10'000;
+#else
+  constexpr int number_of_publications = 100'000;
+#endif
+  constexpr int number_of_readers = 4;
+  {
+    RCUPointer<Tracked> rcu_pointer;
+    rcu_pointer.Publish(std::make_unique<Tracked>(0));
+    std::atomic_bool done = false;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < number_of_readers; ++i) {
+      readers.emplace_back([&done, &rcu_pointer]() {
+        int last_value = 0;
+        while (!done) {
+          RCUPointer<Tracked>::ReadLock const l(rcu_pointer);
+          int const value = l->value();
+          EXPECT_LE(last_value, value);
+          last_value = value;
+        }
+      });
+    }
+    for (int i = 1; i <= number_of_publications; ++i) {
+      rcu_pointer.Publish(std::make_unique<Tracked>(i));
+    }
+    done = true;
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    rcu_pointer.Publish(std::make_unique<Tracked>(number_of_publications + 1));
+    EXPECT_EQ(1, Tracked::live_instances);
+  }
+  EXPECT_EQ(0, Tracked::live_instances);
+}
+
+}  // namespace base
+}  // namespace principia
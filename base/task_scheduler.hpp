@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace principia {
+namespace base {
+namespace internal_task_scheduler {
+
+// The scheduler always executes the pending tasks of the highest priority
+// first.  Tasks are never interrupted, so a long background task delays the
+// critical tasks only if all the workers are busy.
+enum class TaskPriority {
+  // Work that is needed for the current frame, e.g., catching up the vessels.
+  Critical = 0,
+  // Work that may be delayed, e.g., destroying objects.
+  Background = 1,
+};
+
+// A pool of worker threads which execute tasks, with a work-stealing
+// discipline: each worker has its own deque of tasks for each priority, pushes
+// and pops at the back of its deques, and steals at the front of the deques of
+// the other workers when its own are empty.  There is no lock shared by all the
+// workers, except for putting idle workers to sleep.  This class is
+// thread-safe.
+class TaskScheduler final {
+ public:
+  using Task = std::function<void()>;
+
+  // Constructs a scheduler with the given number of workers, which must be
+  // positive.
+  explicit TaskScheduler(std::int64_t number_of_workers);
+
+  // Executes the tasks that are still pending and joins the workers.  No task
+  // may be spawned by another thread during destruction.
+  ~TaskScheduler();
+
+  TaskScheduler(TaskScheduler const&) = delete;
+  TaskScheduler(TaskScheduler&&) = delete;
+  TaskScheduler& operator=(TaskScheduler const&) = delete;
+  TaskScheduler& operator=(TaskScheduler&&) = delete;
+
+  // Schedules |task| for asynchronous execution.  If called from a worker of
+  // this scheduler, the task goes to the deque of that worker, otherwise the
+  // tasks are distributed among the workers in a round-robin manner.  Use a
+  // |TaskGroup| to wait for the completion of tasks.
+  void Spawn(TaskPriority priority, Task task);
+
+  std::int64_t number_of_workers() const;
+
+ private:
+  static constexpr int number_of_priorities = 2;
+
+  // Each worker is on its own cache line to avoid false sharing of the locks.
+  struct alignas(64) Worker final {
+    std::int64_t index = 0;
+    absl::Mutex lock;
+    // Indexed by priority.
+    std::array<std::deque<Task>, number_of_priorities> lanes GUARDED_BY(lock);
+  };
+
+  // The scheduler and the worker running on the current thread, if any.
+  static std::pair<TaskScheduler const*, Worker*>& ThisThreadIdentity();
+
+  // Returns the worker of this scheduler running on the current thread, or
+  // null if the current thread is not a worker of this scheduler.
+  Worker* ThisThreadWorker() const;
+
+  // Tries to find a task with a priority at least as high as |lowest_priority|,
+  // first in the deques of |self| (which may be null) and then by stealing from
+  // the other workers.  Returns true and sets |task| if one was found.
+  bool TryDequeue(Worker* self, TaskPriority lowest_priority, Task& task);
+
+  // Pops the most recent task of the given |priority| of |self|.
+  bool TryPop(Worker& self, int priority, Task& task);
+
+  // Steals the oldest task of the given |priority| of a worker other than
+  // |self| (which may be null).
+  bool TrySteal(Worker const* self, int priority, Task& task);
+
+  // The loop executed by each worker.
+  void Work(Worker* self);
+
+  bool has_pending_tasks_or_shutdown() const;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  // The index of the worker that receives the next task spawned by a thread
+  // other than a worker.
+  std::atomic<std::uint64_t> next_worker_ = 0;
+
+  // The number of tasks in the deques.
+  std::atomic<std::int64_t> pending_tasks_ = 0;
+
+  // Idle workers sleep on |sleep_lock_| until |pending_tasks_| becomes
+  // positive.  |sleeping_workers_| is used to avoid taking the lock when
+  // spawning if no worker is sleeping.
+  absl::Mutex sleep_lock_;
+  std::atomic<std::int64_t> sleeping_workers_ = 0;
+  std::atomic_bool shutdown_ = false;
+
+  friend class TaskGroup;
+};
+
+// A set of tasks executed by a |TaskScheduler|, whose completion may be
+// awaited.  This replaces a future per task.  This class is thread-safe.
+class TaskGroup final {
+ public:
+  // All the tasks of this group are spawned with |priority|.
+  TaskGroup(TaskScheduler& scheduler, TaskPriority priority);
+
+  // Waits for the completion of the tasks of this group.
+  ~TaskGroup();
+
+  TaskGroup(TaskGroup const&) = delete;
+  TaskGroup(TaskGroup&&) = delete;
+  TaskGroup& operator=(TaskGroup const&) = delete;
+  TaskGroup& operator=(TaskGroup&&) = delete;
+
+  void Spawn(TaskScheduler::Task task) EXCLUDES(lock_);
+
+  // Blocks until all the tasks spawned in this group have completed.  When
+  // called from a task, the worker executes its own pending tasks with a
+  // priority at least as high as that of this group while waiting, so tasks
+  // may wait for other tasks without exhausting the workers.
+  void Wait() EXCLUDES(lock_);
+
+ private:
+  bool done() const EXCLUDES(lock_);
+  bool done_locked() const REQUIRES_SHARED(lock_);
+
+  TaskScheduler& scheduler_;
+  TaskPriority const priority_;
+
+  mutable absl::Mutex lock_;
+  std::int64_t outstanding_tasks_ GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace internal_task_scheduler
+
+using internal_task_scheduler::TaskGroup;
+using internal_task_scheduler::TaskPriority;
+using internal_task_scheduler::TaskScheduler;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/task_scheduler_body.hpp"
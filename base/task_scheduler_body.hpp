@@ -0,0 +1,223 @@
+#pragma once
+
+#include "base/task_scheduler.hpp"
+
+#include <utility>
+
+#include "absl/time/time.h"
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_task_scheduler {
+
+inline TaskScheduler::TaskScheduler(std::int64_t const number_of_workers) {
+  CHECK_LT(0, number_of_workers);
+  for (std::int64_t i = 0; i < number_of_workers; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+    workers_.back()->index = i;
+  }
+  // Start the threads once all the workers exist, since they steal from each
+  // other.
+  for (auto const& worker : workers_) {
+    threads_.emplace_back(&TaskScheduler::Work, this, worker.get());
+  }
+}
+
+inline TaskScheduler::~TaskScheduler() {
+  {
+    absl::MutexLock l(&sleep_lock_);
+    shutdown_ = true;
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+inline void TaskScheduler::Spawn(TaskPriority const priority, Task task) {
+  Worker* worker = ThisThreadWorker();
+  if (worker == nullptr) {
+    worker = workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                      workers_.size()].get();
+  }
+  {
+    absl::MutexLock l(&worker->lock);
+    worker->lanes[static_cast<int>(priority)].push_back(std::move(task));
+    ++pending_tasks_;
+  }
+  // The increment of |pending_tasks_| and the load of |sleeping_workers_| are
+  // sequentially consistent, so either a worker going to sleep sees the new
+  // task, or we see that worker and wake it up.
+  if (sleeping_workers_ > 0) {
+    // Releasing the lock causes the sleeping workers to reevaluate their
+    // condition.
+    absl::MutexLock l(&sleep_lock_);
+  }
+}
+
+inline std::int64_t TaskScheduler::number_of_workers() const {
+  return workers_.size();
+}
+
+inline std::pair<TaskScheduler const*, TaskScheduler::Worker*>&
+TaskScheduler::ThisThreadIdentity() {
+  thread_local std::pair<TaskScheduler const*, Worker*> identity = {nullptr,
+                                                                    nullptr};
+  return identity;
+}
+
+inline TaskScheduler::Worker* TaskScheduler::ThisThreadWorker() const {
+  auto const& [scheduler, worker] = ThisThreadIdentity();
+  return scheduler == this ? worker : nullptr;
+}
+
+inline bool TaskScheduler::TryDequeue(Worker* const self,
+                                      TaskPriority const lowest_priority,
+                                      Task& task) {
+  for (int priority = 0;
+       priority <= static_cast<int>(lowest_priority);
+       ++priority) {
+    if ((self != nullptr && TryPop(*self, priority, task)) ||
+        TrySteal(self, priority, task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool TaskScheduler::TryPop(Worker& self,
+                                  int const priority,
+                                  Task& task) {
+  absl::MutexLock l(&self.lock);
+  auto& lane = self.lanes[priority];
+  if (lane.empty()) {
+    return false;
+  }
+  task = std::move(lane.back());
+  lane.pop_back();
+  --pending_tasks_;
+  return true;
+}
+
+inline bool TaskScheduler::TrySteal(Worker const* const self,
+                                    int const priority,
+                                    Task& task) {
+  std::int64_t const n = workers_.size();
+  // Spread the thefts: a worker starts with its neighbour, other threads start
+  // at an arbitrary worker.
+  std::int64_t const first_victim =
+      self == nullptr ? next_worker_.load(std::memory_order_relaxed) % n
+                      : self->index + 1;
+  for (std::int64_t i = 0; i < n; ++i) {
+    Worker& victim = *workers_[(first_victim + i) % n];
+    if (&victim == self) {
+      continue;
+    }
+    absl::MutexLock l(&victim.lock);
+    auto& lane = victim.lanes[priority];
+    if (!lane.empty()) {
+      task = std::move(lane.front());
+      lane.pop_front();
+      --pending_tasks_;
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void TaskScheduler::Work(Worker* const self) {
+  ThisThreadIdentity() = {this, self};
+  Task task;
+  for (;;) {
+    if (TryDequeue(self, TaskPriority::Background, task)) {
+      task();
+      // Destroy the captures now rather than when the next task is found.
+      task = nullptr;
+      continue;
+    }
+    if (shutdown_ && pending_tasks_ == 0) {
+      return;
+    }
+    // Nothing to do, sleep until a task is spawned or the scheduler is
+    // destroyed.
+    ++sleeping_workers_;
+    {
+      absl::MutexLock l(&sleep_lock_);
+      sleep_lock_.Await(absl::Condition(
+          this, &TaskScheduler::has_pending_tasks_or_shutdown));
+    }
+    --sleeping_workers_;
+  }
+}
+
+inline bool TaskScheduler::has_pending_tasks_or_shutdown() const {
+  return pending_tasks_ > 0 || shutdown_;
+}
+
+inline TaskGroup::TaskGroup(TaskScheduler& scheduler,
+                            TaskPriority const priority)
+    : scheduler_(scheduler),
+      priority_(priority) {}
+
+inline TaskGroup::~TaskGroup() {
+  Wait();
+}
+
+inline void TaskGroup::Spawn(TaskScheduler::Task task) {
+  {
+    absl::MutexLock l(&lock_);
+    ++outstanding_tasks_;
+  }
+  scheduler_.Spawn(priority_, [this, task = std::move(task)]() {
+    task();
+    // The decrement must happen under the lock, so that |Wait| doesn't return
+    // (and this object isn't destroyed) before the lock is released.
+    absl::MutexLock l(&lock_);
+    --outstanding_tasks_;
+  });
+}
+
+inline void TaskGroup::Wait() {
+  TaskScheduler::Worker* const self = scheduler_.ThisThreadWorker();
+  if (self == nullptr) {
+    absl::MutexLock l(&lock_);
+    lock_.Await(absl::Condition(this, &TaskGroup::done_locked));
+    return;
+  }
+  // When called from a task, help by executing the tasks of this worker, which
+  // ensures progress if our tasks are stuck in its deques.  We don't steal, as
+  // this could nest arbitrarily large tasks on the stack; popping from the back
+  // only nests the tasks that we spawned, most recent first.
+  TaskScheduler::Task task;
+  while (!done()) {
+    bool found = false;
+    for (int priority = 0;
+         !found && priority <= static_cast<int>(priority_);
+         ++priority) {
+      found = scheduler_.TryPop(*self, priority, task);
+    }
+    if (found) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    // Nothing to help with, our tasks are executing.  The timeout ensures that
+    // we help with the tasks that they might spawn in our deques.
+    absl::MutexLock l(&lock_);
+    lock_.AwaitWithTimeout(absl::Condition(this, &TaskGroup::done_locked),
+                           absl::Milliseconds(1));
+  }
+}
+
+inline bool TaskGroup::done() const {
+  absl::ReaderMutexLock l(&lock_);
+  return done_locked();
+}
+
+inline bool TaskGroup::done_locked() const {
+  return outstanding_tasks_ == 0;
+}
+
+}  // namespace internal_task_scheduler
+}  // namespace base
+}  // namespace principia
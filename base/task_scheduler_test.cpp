@@ -0,0 +1,130 @@
+
+#include "base/task_scheduler.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "glog/logging.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+class TaskSchedulerTest : public ::testing::Test {
+ protected:
+  TaskSchedulerTest() : scheduler_(std::thread::hardware_concurrency()) {
+    LOG(ERROR) << "Concurrency is " << std::thread::hardware_concurrency();
+  }
+
+  // Computes the Fibonacci numbers the silly way, to exercise nested groups.
+  std::int64_t Fibonacci(int const n) {
+    if (n < 2) {
+      return n;
+    }
+    std::int64_t f1;
+    std::int64_t f2;
+    {
+      TaskGroup group(scheduler_, TaskPriority::Critical);
+      group.Spawn([this, n, &f1]() { f1 = Fibonacci(n - 1); });
+      group.Spawn([this, n, &f2]() { f2 = Fibonacci(n - 2); });
+    }
+    return f1 + f2;
+  }
+
+  TaskScheduler scheduler_;
+};
+
+// Check that execution occurs in parallel.  If things were sequential, the
+// integers in |numbers| would be monotonically increasing.
+TEST_F(TaskSchedulerTest, ParallelExecution) {
+#if defined(_DEBUG)
+  constexpr int number_of_calls = 100'000;
+#else
+  constexpr int number_of_calls = 1'000'000;
+#endif
+
+  absl::Mutex lock;
+  std::vector<std::int64_t> numbers;
+  TaskGroup group(scheduler_, TaskPriority::Critical);
+  for (std::int64_t i = 0; i < number_of_calls; ++i) {
+    group.Spawn([i, &lock, &numbers]() {
+      absl::MutexLock l(&lock);
+      numbers.push_back(i);
+    });
+  }
+  group.Wait();
+
+  EXPECT_EQ(number_of_calls, numbers.size());
+  bool monotonically_increasing = true;
+  for (std::int64_t i = 1; i < numbers.size(); ++i) {
+    if (numbers[i] < numbers[i - 1]) {
+      monotonically_increasing = false;
+    }
+  }
+  if (std::thread::hardware_concurrency() > 1) {
+    EXPECT_FALSE(monotonically_increasing);
+  }
+}
+
+// Check that the pending critical tasks are executed before the background
+// ones.
+TEST_F(TaskSchedulerTest, Priorities) {
+  TaskScheduler scheduler(/*number_of_workers=*/1);
+  absl::Notification blocked;
+  absl::Notification unblock;
+  absl::Mutex lock;
+  std::vector<TaskPriority> executed;
+  {
+    TaskGroup background(scheduler, TaskPriority::Background);
+    TaskGroup critical(scheduler, TaskPriority::Critical);
+    // Keep the only worker busy while we spawn.
+    background.Spawn([&blocked, &unblock]() {
+      blocked.Notify();
+      unblock.WaitForNotification();
+    });
+    blocked.WaitForNotification();
+    for (int i = 0; i < 10; ++i) {
+      background.Spawn([&executed, &lock]() {
+        absl::MutexLock l(&lock);
+        executed.push_back(TaskPriority::Background);
+      });
+      critical.Spawn([&executed, &lock]() {
+        absl::MutexLock l(&lock);
+        executed.push_back(TaskPriority::Critical);
+      });
+    }
+    unblock.Notify();
+    critical.Wait();
+    background.Wait();
+  }
+  ASSERT_EQ(20, executed.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(TaskPriority::Critical, executed[i]);
+    EXPECT_EQ(TaskPriority::Background, executed[i + 10]);
+  }
+}
+
+// Check that tasks may wait on groups without deadlocking, even with more
+// groups than workers.
+TEST_F(TaskSchedulerTest, NestedGroups) {
+  EXPECT_EQ(6765, Fibonacci(20));
+}
+
+// Check that the destructor executes the pending tasks.
+TEST_F(TaskSchedulerTest, Destruction) {
+  std::atomic<int> count = 0;
+  {
+    TaskScheduler scheduler(/*number_of_workers=*/2);
+    for (int i = 0; i < 1000; ++i) {
+      scheduler.Spawn(TaskPriority::Background, [&count]() { ++count; });
+    }
+  }
+  EXPECT_EQ(1000, count);
+}
+
+}  // namespace base
+}  // namespace principia
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <type_traits>
 #include <vector>
 
@@ -198,6 +199,50 @@ void SolveHarmonicOscillatorAndComputeError3D(
   state.ResumeTiming();
 }
 
+// Solves the harmonic oscillator over many short intervals with the same
+// instance, the way predictions are computed.  This is dominated by the
+// overhead of |Solve| rather than by the steps.
+template<typename Integrator>
+void SolveHarmonicOscillatorIncrementally3D(Integrator const& integrator) {
+  using ODE = SpecialSecondOrderDifferentialEquation<Position<World>>;
+
+  Displacement<World> const q_initial({1 * Metre, 0 * Metre, 0 * Metre});
+  Velocity<World> const v_initial;
+  Instant const t_initial;
+  Length const length_tolerance = 1e-6 * Metre;
+  Speed const speed_tolerance = 1e-6 * Metre / Second;
+
+  std::int64_t steps = 0;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration3D<World>,
+                _1, _2, _3, /*evaluations=*/nullptr);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  problem.initial_state = {{World::origin + q_initial}, {v_initial}, t_initial};
+  auto const append_state = [&steps](ODE::SystemState const& state) {
+    ++steps;
+  };
+
+  typename Integrator::Parameters const parameters(
+      /*first_time_step=*/1 * Second,
+      /*safety_factor=*/0.9,
+      /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+      /*last_step_is_exact=*/false);
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio3D<ODE>,
+                _1, _2, length_tolerance, speed_tolerance);
+
+  auto const instance = integrator.NewInstance(problem,
+                                               append_state,
+                                               tolerance_to_error_ratio,
+                                               parameters);
+  for (int i = 1; i <= 1000; ++i) {
+    instance->Solve(t_initial + i * Second);
+  }
+  benchmark::DoNotOptimize(steps);
+}
+
 template<typename Method, typename Position>
 void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D(
     benchmark::State& state) {
@@ -232,6 +277,15 @@ void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
   state.SetLabel(ss.str());
 }
 
+template<typename Method, typename Position>
+void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillatorIncrementally3D(  // NOLINT(whitespace/line_length)
+    benchmark::State& state) {
+  while (state.KeepRunning()) {
+    SolveHarmonicOscillatorIncrementally3D(
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>());
+  }
+}
+
 // Keep each argument on a single line below, lest it breaks benchmark parsing.
 
 BENCHMARK_TEMPLATE2(
@@ -242,5 +296,9 @@ BENCHMARK_TEMPLATE2(
     BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D,
     methods::DormandالمكاوىPrince1986RKN434FM, Position<World>);
 
+BENCHMARK_TEMPLATE2(
+    BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillatorIncrementally3D,  // NOLINT(whitespace/line_length)
+    methods::DormandالمكاوىPrince1986RKN434FM, Position<World>);
+
 }  // namespace integrators
 }  // namespace principia
@@ -10,8 +10,9 @@
 
 #include "astronomy/frames.hpp"
 #include "astronomy/stabilize_ksp.hpp"
+#include "base/cpuid.hpp"
 #include "base/not_null.hpp"
-#include "base/thread_pool.hpp"
+#include "base/task_scheduler.hpp"
 #include "benchmark/benchmark.h"
 #include "geometry/frame.hpp"
 #include "geometry/named_quantities.hpp"
@@ -27,6 +28,7 @@
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/massless_body.hpp"
+#include "physics/n_body_kernel.hpp"
 #include "quantities/astronomy.hpp"
 #include "quantities/bipm.hpp"
 #include "quantities/elementary_functions.hpp"
@@ -38,9 +40,12 @@
 namespace principia {
 
 using astronomy::ICRS;
+using base::HasAVX;
 using base::make_not_null_unique;
 using base::not_null;
-using base::ThreadPool;
+using base::TaskGroup;
+using base::TaskPriority;
+using base::TaskScheduler;
 using geometry::Bivector;
 using geometry::DefinesFrame;
 using geometry::Displacement;
@@ -63,7 +68,9 @@ using integrators::methods::QuinlanTremaine1990Order12;
 using ksp_plugin::Barycentric;
 using quantities::DebugString;
 using quantities::Frequency;
+using quantities::GravitationalParameter;
 using quantities::Length;
+using quantities::SIUnit;
 using quantities::Speed;
 using quantities::Sqrt;
 using quantities::Time;
@@ -181,6 +188,39 @@ void BM_EphemerisSolarSystem(benchmark::State& state) {
   state.SetLabel(quantities::DebugString(error / AstronomicalUnit) + " ua");
 }
 
+// The interactions between the massive bodies of |BM_EphemerisSolarSystem|,
+// computed by the given |kernel|.
+template<SolarSystemFactory::Accuracy accuracy, NBodyKernel kernel>
+void BM_EphemerisSolarSystemNBodyKernel(benchmark::State& state) {
+  if (kernel == NBodyKernel::AVX && !HasAVX()) {
+    state.SkipWithError("Instruction set not supported");
+    return;
+  }
+  auto const at_спутник_1_launch = SolarSystemAtСпутник1Launch(accuracy);
+  auto const& names = at_спутник_1_launch->names();
+  int const size = names.size();
+  NBodyArrays arrays(size);
+  for (int i = 0; i < size; ++i) {
+    auto const position =
+        (at_спутник_1_launch->degrees_of_freedom(names[i]).position() -
+         Barycentric::origin).coordinates();
+    arrays.x[i] = position.x / Metre;
+    arrays.y[i] = position.y / Metre;
+    arrays.z[i] = position.z / Metre;
+    arrays.μ[i] = at_спутник_1_launch->gravitational_parameter(names[i]) /
+                  SIUnit<GravitationalParameter>();
+  }
+  while (state.KeepRunning()) {
+    AccumulateNewtonianAccelerations(/*b1_begin=*/0,
+                                     /*b_end=*/size,
+                                     arrays,
+                                     kernel);
+    benchmark::DoNotOptimize(arrays.ax.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size * (size - 1) / 2);
+  state.SetLabel(std::to_string(size) + " bodies");
+}
+
 template<SolarSystemFactory::Accuracy accuracy, Flow* flow>
 void BM_EphemerisLEOProbe(benchmark::State& state) {
   Length sun_error;
@@ -356,7 +396,7 @@ void BM_EphemerisMultithreadingBenchmark(benchmark::State& state) {
                       earth_degrees_of_freedom + orbit.StateVectors(epoch));
   }
 
-  ThreadPool<void> pool(/*pool_size=*/state.range(1));
+  TaskScheduler scheduler(/*number_of_workers=*/state.range(1));
   static constexpr int warp_factor = 6E6;
   static constexpr Frequency refresh_frequency = 50 * Hertz;
   static constexpr Time step = warp_factor / refresh_frequency;
@@ -378,15 +418,13 @@ void BM_EphemerisMultithreadingBenchmark(benchmark::State& state) {
     final_time += step;
     state.ResumeTiming();
 
-    std::vector<std::future<void>> futures;
+    TaskGroup group(scheduler, TaskPriority::Critical);
     for (auto& instance : instances) {
-      futures.push_back(pool.Add([&ephemeris, &instance, final_time]() {
+      group.Spawn([&ephemeris, &instance, final_time]() {
         ephemeris->FlowWithFixedStep(final_time, *instance);
-      }));
-    }
-    for (auto const& future : futures) {
-      future.wait();
+      });
     }
+    group.Wait();
   }
 
   std::stringstream ss;
@@ -598,6 +636,12 @@ BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
 BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
                    SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness)
     ->Arg(-3);
+BENCHMARK_TEMPLATE(BM_EphemerisSolarSystemNBodyKernel,
+                   SolarSystemFactory::Accuracy::MinorAndMajorBodies,
+                   NBodyKernel::Scalar);
+BENCHMARK_TEMPLATE(BM_EphemerisSolarSystemNBodyKernel,
+                   SolarSystemFactory::Accuracy::MinorAndMajorBodies,
+                   NBodyKernel::AVX);
 BENCHMARK_TEMPLATE(BM_EphemerisL4Probe,
                    SolarSystemFactory::Accuracy::MajorBodiesOnly,
                    &FlowEphemerisWithAdaptiveStep)
@@ -27,6 +27,22 @@ using Segment = std::pair<Position<Frame>, Position<Frame>>;
 template<typename Frame>
 using Segments = std::vector<Segment<Frame>>;
 
+// A sphere together with the cone under which it is seen from the camera of
+// some perspective.  This is used to quickly eliminate the spheres that cannot
+// hide a segment.
+template<typename Frame>
+struct SphereCone final {
+  Sphere<Frame> sphere;
+  // The unit vector from the camera to the centre of the sphere.
+  Vector<double, Frame> axis;
+  // The half-angle of the cone.
+  double cos_half_angle;
+  double sin_half_angle;
+  // True if the camera is within the sphere, in which case everything is
+  // hidden.
+  bool contains_camera;
+};
+
 // A perspective using the pinhole camera model.  It project a point of
 // |FromFrame| to an element of ℝP².  |ToFrame| is the frame of the camera.  In
 // that frame the camera is located at the origin and looking at the positive
@@ -43,6 +59,9 @@ class Perspective final {
 
   Length const& focal() const;
 
+  // The position of the camera.
+  Position<FromFrame> const& camera() const;
+
   // Returns the ℝP² element resulting from the projection of |point|.  This
   // is properly defined for all points other than the camera origin.
   RP2Point<Length, ToFrame> operator()(Position<FromFrame> const& point) const;
@@ -78,7 +97,27 @@ class Perspective final {
       Segment<FromFrame> const& segment,
       std::vector<Sphere<FromFrame>> const& spheres) const;
 
+  // Returns the cones under which the |spheres| are seen in this perspective.
+  // This should be called once for a set of spheres that hide many segments.
+  std::vector<SphereCone<FromFrame>> ComputeSphereCones(
+      std::vector<Sphere<FromFrame>> const& spheres) const;
+
+  // Same as above, but the spheres whose cone doesn't intersect the cone under
+  // which |segment| is seen are skipped cheaply.  The |sphere_cones| must have
+  // been computed by this perspective.
+  Segments<FromFrame> VisibleSegments(
+      Segment<FromFrame> const& segment,
+      std::vector<SphereCone<FromFrame>> const& sphere_cones) const;
+
  private:
+  // Applies the hiding by the spheres returned by |sphere_if_may_hide|, which
+  // returns null for the |occluders| that cannot hide |segment|.
+  template<typename Occluder, typename SphereIfMayHide>
+  Segments<FromFrame> VisibleSegments(
+      Segment<FromFrame> const& segment,
+      std::vector<Occluder> const& occluders,
+      SphereIfMayHide const& sphere_if_may_hide) const;
+
   RigidTransformation<ToFrame, FromFrame> const from_camera_;
   RigidTransformation<FromFrame, ToFrame> const to_camera_;
   Position<FromFrame> const camera_;
@@ -99,6 +138,7 @@ std::ostream& operator<<(
 using internal_perspective::Perspective;
 using internal_perspective::Segment;
 using internal_perspective::Segments;
+using internal_perspective::SphereCone;
 
 }  // namespace geometry
 }  // namespace principia
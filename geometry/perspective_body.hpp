@@ -10,6 +10,7 @@
 
 #include "geometry/barycentre_calculator.hpp"
 #include "numerics/root_finders.hpp"
+#include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
 
 namespace principia {
@@ -17,9 +18,11 @@ namespace geometry {
 namespace internal_perspective {
 
 using geometry::InnerProduct;
+using geometry::Normalize;
 using numerics::SolveQuadraticEquation;
 using quantities::Pow;
 using quantities::Product;
+using quantities::Sqrt;
 using quantities::Square;
 
 template<typename FromFrame, typename ToFrame>
@@ -45,6 +48,11 @@ Length const& Perspective<FromFrame, ToFrame>::focal() const {
   return focal_;
 }
 
+template<typename FromFrame, typename ToFrame>
+Position<FromFrame> const& Perspective<FromFrame, ToFrame>::camera() const {
+  return camera_;
+}
+
 template<typename FromFrame, typename ToFrame>
 RP2Point<Length, ToFrame> Perspective<FromFrame, ToFrame>::
 operator()(Position<FromFrame> const& point) const {
@@ -359,6 +367,89 @@ template<typename FromFrame, typename ToFrame>
 Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
     Segment<FromFrame> const& segment,
     std::vector<Sphere<FromFrame>> const& spheres) const {
+  return VisibleSegments(
+      segment,
+      spheres,
+      [](Sphere<FromFrame> const& sphere) { return &sphere; });
+}
+
+template<typename FromFrame, typename ToFrame>
+std::vector<SphereCone<FromFrame>>
+Perspective<FromFrame, ToFrame>::ComputeSphereCones(
+    std::vector<Sphere<FromFrame>> const& spheres) const {
+  std::vector<SphereCone<FromFrame>> sphere_cones;
+  sphere_cones.reserve(spheres.size());
+  for (auto const& sphere : spheres) {
+    Displacement<FromFrame> const KC = sphere.centre() - camera_;
+    auto const KC² = KC.Norm²();
+    if (KC² <= sphere.radius²()) {
+      sphere_cones.push_back({sphere,
+                              Vector<double, FromFrame>(),
+                              /*cos_half_angle=*/-1,
+                              /*sin_half_angle=*/0,
+                              /*contains_camera=*/true});
+    } else {
+      double const sin²_half_angle = sphere.radius²() / KC²;
+      sphere_cones.push_back({sphere,
+                              Normalize(KC),
+                              Sqrt(1 - sin²_half_angle),
+                              Sqrt(sin²_half_angle),
+                              /*contains_camera=*/false});
+    }
+  }
+  return sphere_cones;
+}
+
+template<typename FromFrame, typename ToFrame>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
+    Segment<FromFrame> const& segment,
+    std::vector<SphereCone<FromFrame>> const& sphere_cones) const {
+  // The points of the segment are seen in directions that lie on the arc of
+  // great circle between a and b.  That arc is contained in the cone of axis
+  // a + b and of half-angle θ, where 2θ is the angle between a and b.  A sphere
+  // seen under the half-angle ρ in the direction c may only hide the segment
+  // if the angle between a + b and c is less than θ + ρ.  Since θ and ρ are at
+  // most π/2, this is equivalent to:
+  //   (a + b)·c ≥ |a + b| cos(θ + ρ) = (1 + a·b) cos ρ - sin 2θ sin ρ
+  // where we used |a + b| = 2 cos θ.
+  Displacement<FromFrame> const KA = segment.first - camera_;
+  Displacement<FromFrame> const KB = segment.second - camera_;
+  if (KA == Displacement<FromFrame>() || KB == Displacement<FromFrame>()) {
+    // The segment is seen in all directions.
+    return VisibleSegments(
+        segment,
+        sphere_cones,
+        [](SphereCone<FromFrame> const& sphere_cone) {
+          return &sphere_cone.sphere;
+        });
+  }
+  Vector<double, FromFrame> const a = Normalize(KA);
+  Vector<double, FromFrame> const b = Normalize(KB);
+  double const cos_2θ = InnerProduct(a, b);
+  double const sin_2θ = Sqrt(std::max(0.0, 1 - cos_2θ * cos_2θ));
+  Vector<double, FromFrame> const a_plus_b = a + b;
+  return VisibleSegments(
+      segment,
+      sphere_cones,
+      [&a_plus_b, cos_2θ, sin_2θ](SphereCone<FromFrame> const& sphere_cone)
+          -> Sphere<FromFrame> const* {
+        if (sphere_cone.contains_camera ||
+            InnerProduct(a_plus_b, sphere_cone.axis) >=
+                (1 + cos_2θ) * sphere_cone.cos_half_angle -
+                    sin_2θ * sphere_cone.sin_half_angle) {
+          return &sphere_cone.sphere;
+        } else {
+          return nullptr;
+        }
+      });
+}
+
+template<typename FromFrame, typename ToFrame>
+template<typename Occluder, typename SphereIfMayHide>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
+    Segment<FromFrame> const& segment,
+    std::vector<Occluder> const& occluders,
+    SphereIfMayHide const& sphere_if_may_hide) const {
   // This algorithm takes the input segment, applies the hiding by the first
   // sphere (which can result in 0, 1, or 2 segments), applies the hiding by the
   // second sphere to the resulting segments, and so on.  To reduce memory
@@ -366,7 +457,7 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   // reserve the maximum possible size.  As hiding proceeds, segments are taken
   // from the vector and replaced or appended as needed.
   Segments<FromFrame> segments;
-  segments.reserve(spheres.size() + 1);
+  segments.reserve(occluders.size() + 1);
   segments.push_back(segment);
 
   // The range [in_begin, in_end[ contains the segments that have been produced
@@ -389,10 +480,15 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   // are stored in a contiguous slice of the vector segments.  That slice
   // doesn't start at 0 iff at least one call to VisibleSegments returned 0
   // segments.
-  for (auto const& sphere : spheres) {
+  for (auto const& occluder : occluders) {
+    Sphere<FromFrame> const* const sphere = sphere_if_may_hide(occluder);
+    if (sphere == nullptr) {
+      continue;
+    }
     for (int i = in_end - 1; i >= in_begin; --i) {
       auto const& old_segment = segments[i];
-      auto const new_segments_for_sphere = VisibleSegments(old_segment, sphere);
+      auto const new_segments_for_sphere =
+          VisibleSegments(old_segment, *sphere);
       int const new_segments_for_sphere_size = new_segments_for_sphere.size();
       if (new_segments_for_sphere_size >= 1) {
         segments[--out_begin] = std::move(new_segments_for_sphere.front());
@@ -1,5 +1,7 @@
 ﻿
 #include <limits>
+#include <random>
+#include <vector>
 
 #include "geometry/affine_map.hpp"
 #include "geometry/frame.hpp"
@@ -618,6 +620,35 @@ TEST_F(VisibleSegmentsTest, MultipleSpheres) {
               SizeIs(3));
 }
 
+TEST_F(VisibleSegmentsTest, SphereCones) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> coordinate_distribution(-20.0, 20.0);
+  std::uniform_real_distribution<> radius_distribution(0.1, 5.0);
+  auto random_position = [&coordinate_distribution, &random]() {
+    return World::origin +
+           Displacement<World>({coordinate_distribution(random) * Metre,
+                                coordinate_distribution(random) * Metre,
+                                coordinate_distribution(random) * Metre});
+  };
+
+  // Some of the spheres contain the camera.
+  std::vector<Sphere<World>> spheres;
+  for (int i = 0; i < 10; ++i) {
+    spheres.emplace_back(random_position(),
+                         radius_distribution(random) * Metre);
+  }
+  auto const sphere_cones = perspective_.ComputeSphereCones(spheres);
+  ASSERT_THAT(sphere_cones, SizeIs(spheres.size()));
+
+  // Skipping the spheres whose cone is away from the segment doesn't change
+  // the result.
+  for (int i = 0; i < 1000; ++i) {
+    Segment<World> const segment{random_position(), random_position()};
+    EXPECT_EQ(perspective_.VisibleSegments(segment, spheres),
+              perspective_.VisibleSegments(segment, sphere_cones));
+  }
+}
+
 }  // namespace internal_perspective
 }  // namespace geometry
 }  // namespace principia
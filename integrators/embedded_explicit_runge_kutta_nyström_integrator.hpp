@@ -9,6 +9,7 @@
 #ifndef PRINCIPIA_INTEGRATORS_EMBEDDED_EXPLICIT_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_  // NOLINT(whitespace/line_length)
 #define PRINCIPIA_INTEGRATORS_EMBEDDED_EXPLICIT_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_  // NOLINT(whitespace/line_length)
 
+#include <array>
 #include <functional>
 #include <vector>
 
@@ -107,7 +108,22 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
              Parameters const& adaptive_step_size,
              EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator);
 
+    using Displacement = typename ODE::Displacement;
+    using Velocity = typename ODE::Velocity;
+    using Acceleration = typename ODE::Acceleration;
+
     EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator_;
+
+    // The scratch state of |Solve|.  It is kept across calls so that |Solve|
+    // doesn't allocate once the vectors have reached the dimension of the
+    // problem.
+    std::vector<Displacement> Δq̂_;
+    std::vector<Velocity> Δv̂_;
+    typename ODE::SystemStateError error_estimate_;
+    std::vector<Position> q_stage_;
+    std::array<std::vector<Acceleration>, Method::stages> g_;
+    typename ODE::SystemState final_state_;
+
     friend class EmbeddedExplicitRungeKuttaNyströmIntegrator;
   };
 
@@ -4,9 +4,9 @@
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <ctime>
-#include <optional>
 #include <vector>
 
 #include "geometry/sign.hpp"
@@ -44,10 +44,6 @@ EmbeddedExplicitRungeKuttaNyströmIntegrator() {
 template<typename Method, typename Position>
 Status EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 Instance::Solve(Instant const& t_final) {
-  using Displacement = typename ODE::Displacement;
-  using Velocity = typename ODE::Velocity;
-  using Acceleration = typename ODE::Acceleration;
-
   auto const& a = integrator_.a_;
   auto const& b̂ = integrator_.b̂_;
   auto const& b̂ʹ = integrator_.b̂ʹ_;
@@ -65,7 +61,8 @@ Instance::Solve(Instant const& t_final) {
   // restartability.
 
   // State before the last, truncated step.
-  std::optional<typename ODE::SystemState> final_state;
+  typename ODE::SystemState& final_state = final_state_;
+  bool has_final_state = false;
 
   // Argument checks.
   int const dimension = current_state.positions.size();
@@ -88,9 +85,11 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment (high-order).
-  std::vector<Displacement> Δq̂(dimension);
+  std::vector<Displacement>& Δq̂ = Δq̂_;
+  Δq̂.resize(dimension);
   // Velocity increment (high-order).
-  std::vector<Velocity> Δv̂(dimension);
+  std::vector<Velocity>& Δv̂ = Δv̂_;
+  Δv̂.resize(dimension);
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q̂ = current_state.positions;
@@ -99,15 +98,15 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v̂ = current_state.velocities;
 
   // Difference between the low- and high-order approximations.
-  typename ODE::SystemStateError error_estimate;
+  typename ODE::SystemStateError& error_estimate = error_estimate_;
   error_estimate.position_error.resize(dimension);
   error_estimate.velocity_error.resize(dimension);
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
+  q_stage.resize(dimension);
   // Accelerations at each stage.
-  // TODO(egg): this is a rectangular container, use something more appropriate.
-  std::vector<std::vector<Acceleration>> g(stages_);
+  std::array<std::vector<Acceleration>, stages_>& g = g_;
   for (auto& g_stage : g) {
     g_stage.resize(dimension);
   }
@@ -169,6 +168,7 @@ Instance::Solve(Instant const& t_final) {
           // last stage below.
           h = time_to_end;
           final_state = current_state;
+          has_final_state = true;
         }
       }
 
@@ -223,6 +223,7 @@ Instance::Solve(Instant const& t_final) {
     if (!parameters.last_step_is_exact && t.value + (t.error + h) > t_final) {
       // We did overshoot.  Drop the point that we just computed and exit.
       final_state = current_state;
+      has_final_state = true;
       break;
     }
 
@@ -250,8 +251,8 @@ Instance::Solve(Instant const& t_final) {
     }
   }
   // The resolution is restartable from the last non-truncated state.
-  CHECK(final_state);
-  current_state = *final_state;
+  CHECK(has_final_state);
+  current_state = final_state;
   return status;
 }
 
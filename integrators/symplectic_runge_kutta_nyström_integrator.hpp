@@ -9,6 +9,8 @@
 #ifndef PRINCIPIA_INTEGRATORS_SYMPLECTIC_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_
 #define PRINCIPIA_INTEGRATORS_SYMPLECTIC_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_
 
+#include <vector>
+
 #include "base/status.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
@@ -102,7 +104,20 @@ class SymplecticRungeKuttaNyströmIntegrator
              Time const& step,
              SymplecticRungeKuttaNyströmIntegrator const& integrator);
 
+    using Displacement = typename ODE::Displacement;
+    using Velocity = typename ODE::Velocity;
+    using Acceleration = typename ODE::Acceleration;
+
     SymplecticRungeKuttaNyströmIntegrator const& integrator_;
+
+    // The scratch state of |Solve|.  It is kept across calls so that |Solve|
+    // doesn't allocate once the vectors have reached the dimension of the
+    // problem.
+    std::vector<Displacement> Δq_;
+    std::vector<Velocity> Δv_;
+    std::vector<Position> q_stage_;
+    std::vector<Acceleration> g_;
+
     friend class SymplecticRungeKuttaNyströmIntegrator;
   };
 
@@ -23,10 +23,6 @@ using quantities::Abs;
 template<typename Method, typename Position>
 Status SymplecticRungeKuttaNyströmIntegrator<Method, Position>::
 Instance::Solve(Instant const& t_final) {
-  using Displacement = typename ODE::Displacement;
-  using Velocity = typename ODE::Velocity;
-  using Acceleration = typename ODE::Acceleration;
-
   auto const& a = integrator_.a_;
   auto const& b = integrator_.b_;
   auto const& c = integrator_.c_;
@@ -59,9 +55,11 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment.
-  std::vector<Displacement> Δq(dimension);
+  std::vector<Displacement>& Δq = Δq_;
+  Δq.resize(dimension);
   // Velocity increment.
-  std::vector<Velocity> Δv(dimension);
+  std::vector<Velocity>& Δv = Δv_;
+  Δv.resize(dimension);
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q = current_state.positions;
@@ -70,9 +68,11 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v = current_state.velocities;
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
+  q_stage.resize(dimension);
   // Accelerations at the current stage.
-  std::vector<Acceleration> g(dimension);
+  std::vector<Acceleration>& g = g_;
+  g.resize(dimension);
 
   // The first full stage of the step, i.e. the first stage where
   // exp(bᵢ h B) exp(aᵢ h A) must be entirely computed.
@@ -1,14 +1,20 @@
 ﻿
 #include "journal/player.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/array.hpp"
 #include "base/get_line.hpp"
 #include "base/hexadecimal.hpp"
 #include "journal/profiles.hpp"
+#include "journal/recorder.hpp"
 #include "glog/logging.h"
 
 namespace principia {
@@ -21,9 +27,18 @@ using interface::principia__ActivatePlayer;
 namespace journal {
 
 Player::Player(std::filesystem::path const& path)
-    : stream_(path, std::ios::in) {
+    : stream_(path, std::ios::in | std::ios::binary) {
   principia__ActivatePlayer();
-  CHECK(!stream_.fail());
+  CHECK(!stream_.fail()) << path;
+  if (GetLine(stream_) == binary_journal_header) {
+    binary_ = true;
+    compressor_ = NewJournalCompressor(GetLine(stream_));
+  } else {
+    // A text journal: reopen it in text mode to get the line ends right.
+    stream_.close();
+    stream_.open(path, std::ios::in);
+    CHECK(!stream_.fail()) << path;
+  }
 }
 
 bool Player::Play(int const index) {
@@ -67,7 +82,85 @@ serialization::Method const& Player::last_method_out_return() const {
   return *last_method_out_return_;
 }
 
+void Player::CollectStatistics(AllocationCounter allocation_counter) {
+  collect_statistics_ = true;
+  allocation_counter_ = std::move(allocation_counter);
+}
+
+void Player::WriteStatistics(std::ostream& out) const {
+  out << "method\tcalls\ttotal_ns\tp50_ns\tp99_ns\tmax_ns\t"
+      << "allocations_per_call\n";
+  for (auto const& [name, statistics] : statistics_) {
+    out << name << "\t"
+        << statistics.calls() << "\t"
+        << statistics.total_latency().count() << "\t"
+        << statistics.Percentile(50).count() << "\t"
+        << statistics.Percentile(99).count() << "\t"
+        << statistics.max_latency().count() << "\t";
+    if (allocation_counter_ == nullptr) {
+      out << "NA";
+    } else {
+      out << static_cast<double>(statistics.allocations()) /
+                 statistics.calls();
+    }
+    out << "\n";
+  }
+}
+
+void Player::MethodStatistics::Add(std::chrono::nanoseconds const latency,
+                                   std::int64_t const allocations) {
+  ++calls_;
+  allocations_ += allocations;
+  total_latency_ += latency;
+  max_latency_ = std::max(max_latency_, latency);
+  // Latencies below 1 ns go to the first bucket.
+  int const bucket =
+      latency.count() <= 1
+          ? 0
+          : static_cast<int>(buckets_per_octave *
+                             std::log2(static_cast<double>(latency.count())));
+  ++histogram_[std::min(bucket, number_of_buckets - 1)];
+}
+
+std::int64_t Player::MethodStatistics::calls() const {
+  return calls_;
+}
+
+std::int64_t Player::MethodStatistics::allocations() const {
+  return allocations_;
+}
+
+std::chrono::nanoseconds Player::MethodStatistics::total_latency() const {
+  return total_latency_;
+}
+
+std::chrono::nanoseconds Player::MethodStatistics::max_latency() const {
+  return max_latency_;
+}
+
+std::chrono::nanoseconds Player::MethodStatistics::Percentile(
+    double const p) const {
+  // The number of calls that must be at or below the percentile.
+  double const rank = std::ceil(p / 100 * calls_);
+  std::int64_t cumulative_calls = 0;
+  for (int bucket = 0; bucket < number_of_buckets; ++bucket) {
+    cumulative_calls += histogram_[bucket];
+    if (cumulative_calls >= rank) {
+      // The upper bound of the bucket, which may not exceed the maximum.
+      std::chrono::nanoseconds const upper_bound(static_cast<std::int64_t>(
+          std::ceil(std::exp2(static_cast<double>(bucket + 1) /
+                              buckets_per_octave))));
+      return std::min(upper_bound, max_latency_);
+    }
+  }
+  return max_latency_;
+}
+
 std::unique_ptr<serialization::Method> Player::Read() {
+  return binary_ ? ReadBinary() : ReadHexadecimal();
+}
+
+std::unique_ptr<serialization::Method> Player::ReadHexadecimal() {
   std::string const line = GetLine(stream_);
   if (line.empty()) {
     return nullptr;
@@ -81,5 +174,58 @@ std::unique_ptr<serialization::Method> Player::Read() {
   return method;
 }
 
+std::unique_ptr<serialization::Method> Player::ReadBinary() {
+  std::uint8_t size[sizeof(std::uint32_t)];
+  if (!ReadRecordBytes(sizeof(size), size)) {
+    return nullptr;
+  }
+  std::vector<std::uint8_t> bytes(DecodeJournalSize(size));
+  if (!ReadRecordBytes(bytes.size(), bytes.data())) {
+    // The process recording the journal probably died.
+    LOG(ERROR) << "Truncated record at end of journal";
+    return nullptr;
+  }
+
+  auto method = std::make_unique<serialization::Method>();
+  CHECK(method->ParseFromArray(bytes.data(), static_cast<int>(bytes.size())));
+
+  return method;
+}
+
+bool Player::ReadRecordBytes(std::int64_t size, std::uint8_t* bytes) {
+  while (size > 0) {
+    if (block_index_ == block_.size() && !ReadBlock()) {
+      return false;
+    }
+    std::int64_t const count =
+        std::min<std::int64_t>(size, block_.size() - block_index_);
+    std::memcpy(bytes, &block_[block_index_], count);
+    bytes += count;
+    size -= count;
+    block_index_ += count;
+  }
+  return true;
+}
+
+bool Player::ReadBlock() {
+  std::uint8_t size[sizeof(std::uint32_t)];
+  if (!stream_.read(reinterpret_cast<char*>(size), sizeof(size))) {
+    return false;
+  }
+  std::string bytes(DecodeJournalSize(size), '\0');
+  if (!stream_.read(bytes.data(), bytes.size())) {
+    LOG(ERROR) << "Truncated block at end of journal";
+    return false;
+  }
+  if (compressor_ == nullptr) {
+    block_ = std::move(bytes);
+  } else {
+    block_.clear();
+    CHECK(compressor_->Uncompress(bytes, &block_));
+  }
+  block_index_ = 0;
+  return true;
+}
+
 }  // namespace journal
 }  // namespace principia
@@ -1,11 +1,18 @@
 ﻿
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <memory>
+#include <ostream>
+#include <string>
 
+#include "gipfeli/compression.h"
 #include "serialization/journal.pb.h"
 
 namespace principia {
@@ -14,7 +21,10 @@ namespace journal {
 class Player final {
  public:
   using PointerMap = std::map<std::uint64_t, void*>;
+  // Returns the number of memory allocations performed so far by the process.
+  using AllocationCounter = std::function<std::int64_t()>;
 
+  // Replays the journal at |path|, which may be a text or a binary journal.
   explicit Player(std::filesystem::path const& path);
 
   // Replays the next message in the journal.  Returns false at end of journal.
@@ -25,9 +35,56 @@ class Player final {
   serialization::Method const& last_method_in() const;
   serialization::Method const& last_method_out_return() const;
 
+  // Makes the subsequent calls to |Play| collect the latency of each method.
+  // If |allocation_counter| is not null, the allocations performed while
+  // running each method are counted too; note that this includes the
+  // allocations of the background threads.
+  void CollectStatistics(AllocationCounter allocation_counter = nullptr);
+
+  // Writes the statistics collected so far, as tab-separated values with a
+  // header line and one line per method, sorted by name, so that the reports
+  // of two builds may be diffed.  The latencies are in nanoseconds; the
+  // percentiles are accurate to 10%.
+  void WriteStatistics(std::ostream& out) const;
+
  private:
+  // The statistics of the calls to one method, with the latencies in a
+  // histogram having 8 buckets per octave.
+  class MethodStatistics final {
+   public:
+    void Add(std::chrono::nanoseconds latency, std::int64_t allocations);
+
+    std::int64_t calls() const;
+    std::int64_t allocations() const;
+    std::chrono::nanoseconds total_latency() const;
+    std::chrono::nanoseconds max_latency() const;
+    // Returns an upper bound of the |p|th percentile of the latency.
+    std::chrono::nanoseconds Percentile(double p) const;
+
+   private:
+    static constexpr int buckets_per_octave = 8;
+    // Enough for latencies up to 2⁴⁸ ns, i.e., 3 days.
+    static constexpr int number_of_buckets = 48 * buckets_per_octave;
+
+    std::int64_t calls_ = 0;
+    std::int64_t allocations_ = 0;
+    std::chrono::nanoseconds total_latency_{};
+    std::chrono::nanoseconds max_latency_{};
+    std::array<std::int64_t, number_of_buckets> histogram_{};
+  };
+
   // Reads one message from the stream.  Returns a |nullptr| at end of stream.
   std::unique_ptr<serialization::Method> Read();
+  std::unique_ptr<serialization::Method> ReadHexadecimal();
+  std::unique_ptr<serialization::Method> ReadBinary();
+
+  // Reads |size| bytes of the records of a binary journal to |bytes|.  Returns
+  // false if the journal ends before.
+  bool ReadRecordBytes(std::int64_t size, std::uint8_t* bytes);
+
+  // Reads the next block of a binary journal to |block_|.  Returns false at end
+  // of stream.
+  bool ReadBlock();
 
   template<typename Profile>
   bool RunIfAppropriate(serialization::Method const& method_in,
@@ -36,6 +93,18 @@ class Player final {
   PointerMap pointer_map_;
   std::ifstream stream_;
 
+  // The following members are only used for binary journals.
+  bool binary_ = false;
+  std::unique_ptr<google::compression::Compressor> compressor_;
+  // The uncompressed block being read, and the index of the next byte to read.
+  std::string block_;
+  std::int64_t block_index_ = 0;
+
+  bool collect_statistics_ = false;
+  AllocationCounter allocation_counter_;
+  // Indexed by the name of the method, e.g., "AdvanceTime".
+  std::map<std::string, MethodStatistics> statistics_;
+
   std::unique_ptr<serialization::Method> last_method_in_;
   std::unique_ptr<serialization::Method> last_method_out_return_;
 
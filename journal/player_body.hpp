@@ -3,6 +3,7 @@
 
 #include "journal/player.hpp"
 
+#include <chrono>
 #include <list>
 
 #include "glog/logging.h"
@@ -20,8 +21,23 @@ bool Player::RunIfAppropriate(serialization::Method const& method_in,
         << method_out_return.DebugString();
     serialization::Method merged_method = method_in;
     merged_method.MergeFrom(method_out_return);
-    Profile::Run(merged_method.GetExtension(Profile::Message::extension),
-                 pointer_map_);
+    auto const& message =
+        merged_method.GetExtension(Profile::Message::extension);
+    if (collect_statistics_) {
+      // Look up the statistics before starting the clock to avoid measuring
+      // the lookup.
+      auto& statistics = statistics_[Profile::Message::descriptor()->name()];
+      std::int64_t const allocations_before =
+          allocation_counter_ == nullptr ? 0 : allocation_counter_();
+      auto const before = std::chrono::steady_clock::now();
+      Profile::Run(message, pointer_map_);
+      auto const after = std::chrono::steady_clock::now();
+      std::int64_t const allocations_after =
+          allocation_counter_ == nullptr ? 0 : allocation_counter_();
+      statistics.Add(after - before, allocations_after - allocations_before);
+    } else {
+      Profile::Run(message, pointer_map_);
+    }
     return true;
   }
   return false;
@@ -1,12 +1,19 @@
 ﻿
 #include "journal/player.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <list>
+#include <new>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "benchmark/benchmark.h"
 #include "glog/logging.h"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "journal/method.hpp"
 #include "journal/profiles.hpp"
@@ -14,9 +21,32 @@
 #include "ksp_plugin/interface.hpp"
 #include "serialization/journal.pb.h"
 
+namespace {
+
+// The number of calls to the global |operator new| in this process, to
+// attribute allocations to the methods that are replayed.
+std::atomic<std::int64_t> allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t const size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* const pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* const pointer) noexcept {
+  std::free(pointer);
+}
+
 namespace principia {
 namespace journal {
 
+using ::testing::HasSubstr;
+using ::testing::StartsWith;
+
 void BM_PlayForReal(benchmark::State& state) {
   while (state.KeepRunning()) {
     Player player(
@@ -80,6 +110,67 @@ TEST_F(PlayerTest, PlayTiny) {
   EXPECT_EQ(2, count);
 }
 
+TEST_F(PlayerTest, Statistics) {
+  {
+    Recorder* const r(new Recorder(test_name_ + ".journal.hex"));
+    Recorder::Activate(r);
+
+    for (int i = 0; i < 10; ++i) {
+      {
+        Method<NewPlugin> m({"MJD1", "MJD2", 3});
+        m.Return(plugin_.get());
+      }
+      {
+        const ksp_plugin::Plugin* plugin = plugin_.get();
+        Method<DeletePlugin> m({&plugin}, {&plugin});
+        m.Return();
+      }
+    }
+    Recorder::Deactivate();
+  }
+
+  Player player(test_name_ + ".journal.hex");
+  player.CollectStatistics(
+      []() { return allocations.load(std::memory_order_relaxed); });
+  int count = 0;
+  while (player.Play(count)) {
+    ++count;
+  }
+  EXPECT_EQ(20, count);
+
+  std::stringstream report;
+  player.WriteStatistics(report);
+  EXPECT_THAT(report.str(), StartsWith("method\tcalls\t"));
+  EXPECT_THAT(report.str(), HasSubstr("\nDeletePlugin\t10\t"));
+  EXPECT_THAT(report.str(), HasSubstr("\nNewPlugin\t10\t"));
+}
+
+// Replays a journal as fast as possible and writes the latency and allocation
+// statistics of each method next to it.  Comparing the reports produced by two
+// builds is a way to find performance regressions on realistic workloads.  You
+// must set |path|.
+TEST_F(PlayerTest, DISABLED_SECULAR_Replay) {
+  std::string const path =
+      R"(P:\Public Mockingbird\Principia\Journals\JOURNAL.20180311-192733)";
+  Player player(path);
+  player.CollectStatistics(
+      []() { return allocations.load(std::memory_order_relaxed); });
+  int count = 0;
+  auto const before = std::chrono::steady_clock::now();
+  while (player.Play(count)) {
+    ++count;
+    LOG_IF(ERROR, (count % 100'000) == 0)
+        << count << " journal entries replayed";
+  }
+  auto const after = std::chrono::steady_clock::now();
+  LOG(ERROR) << count << " journal entries replayed in "
+             << std::chrono::duration<double>(after - before).count() << " s";
+
+  std::ofstream report(path + ".replay.tsv");
+  CHECK(report.good());
+  player.WriteStatistics(report);
+}
+
 TEST_F(PlayerTest, DISABLED_SECULAR_Benchmarks) {
   benchmark::RunSpecifiedBenchmarks();
 }
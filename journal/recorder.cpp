@@ -1,13 +1,25 @@
 ﻿
 #include "journal/recorder.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 
+#include "absl/time/clock.h"
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
+#include "base/macros.hpp"
+#include "gipfeli/gipfeli.h"
 #include "glog/logging.h"
 #include "base/serialization.hpp"
 
+// glog doesn't expose the current failure function, but exports the variable
+// that holds it; its own tests declare it the same way.
+namespace google {
+extern GOOGLE_GLOG_DLL_DECL void (*g_logging_fail_func)();
+}  // namespace google
+
 namespace principia {
 
 using base::HexadecimalEncoder;
@@ -16,11 +28,71 @@ using base::UniqueArray;
 
 namespace journal {
 
+namespace {
+
+constexpr char gipfeli_compressor[] = "gipfeli";
+
+// The time that the background thread waits between two blocks, unless the
+// buffer is getting full.  This determines the size of the batches.
+constexpr absl::Duration writer_period = absl::Milliseconds(20);
+
+// The time that a fatal error waits for the buffer to be written.
+constexpr absl::Duration flush_timeout = absl::Seconds(5);
+
+}  // namespace
+
+std::unique_ptr<google::compression::Compressor> NewJournalCompressor(
+    std::string_view const name) {
+  if (name.empty()) {
+    return nullptr;
+  } else if (name == gipfeli_compressor) {
+    return google::compression::NewGipfeliCompressor();
+  } else {
+    LOG(FATAL) << "Unknown compressor " << name;
+    base::noreturn();
+  }
+}
+
+void EncodeJournalSize(std::uint32_t const size, std::uint8_t* const bytes) {
+  for (int i = 0; i < 4; ++i) {
+    bytes[i] = static_cast<std::uint8_t>(size >> (8 * i));
+  }
+}
+
+std::uint32_t DecodeJournalSize(std::uint8_t const* const bytes) {
+  std::uint32_t size = 0;
+  for (int i = 0; i < 4; ++i) {
+    size |= static_cast<std::uint32_t>(bytes[i]) << (8 * i);
+  }
+  return size;
+}
+
 Recorder::Recorder(std::filesystem::path const& path)
     : stream_(path, std::ios::out) {
   CHECK(!stream_.fail()) << path;
 }
 
+Recorder::Recorder(std::filesystem::path const& path,
+                   std::string_view const compressor,
+                   std::int64_t const buffer_size)
+    : stream_(path, std::ios::out | std::ios::binary),
+      binary_(true),
+      compressor_(NewJournalCompressor(compressor)),
+      ring_buffer_(buffer_size) {
+  CHECK(!stream_.fail()) << path;
+  CHECK_LT(0, buffer_size);
+  stream_ << binary_journal_header << "\n" << compressor << "\n";
+  stream_.flush();
+  writer_ = std::thread(&Recorder::RepeatedlyWriteBlocks, this);
+}
+
+Recorder::~Recorder() {
+  if (writer_.joinable()) {
+    shutdown_.store(true, std::memory_order_release);
+    writer_.join();
+  }
+}
+
 void Recorder::WriteAtConstruction(serialization::Method const& method) {
   lock_.Lock();
   WriteLocked(method);
@@ -34,10 +106,18 @@ void Recorder::WriteAtDestruction(serialization::Method const& method) {
 void Recorder::Activate(base::not_null<Recorder*> const recorder) {
   CHECK(active_recorder_ == nullptr);
   active_recorder_ = recorder;
+  if (recorder->binary_) {
+    previous_failure_function_ = google::g_logging_fail_func;
+    google::InstallFailureFunction(&FlushAndAbort);
+  }
 }
 
 void Recorder::Deactivate() {
   CHECK(active_recorder_ != nullptr);
+  if (active_recorder_->binary_) {
+    google::InstallFailureFunction(previous_failure_function_);
+    previous_failure_function_ = nullptr;
+  }
   delete active_recorder_;
   active_recorder_ = nullptr;
 }
@@ -47,14 +127,127 @@ bool Recorder::IsActivated() {
 }
 
 void Recorder::WriteLocked(serialization::Method const& method) {
-  static auto* const encoder = new HexadecimalEncoder</*null_terminated=*/true>;
-  CHECK_LT(0, method.ByteSize()) << method.DebugString();
-  auto const hexadecimal = encoder->Encode(SerializeAsBytes(method).get());
-  stream_ << hexadecimal.data.get() << "\n";
+  std::int64_t const size = method.ByteSizeLong();
+  CHECK_LT(0, size) << method.DebugString();
+  if (binary_) {
+    // Serialize to a reused buffer to avoid allocating for each method.
+    record_.resize(sizeof(std::uint32_t) + size);
+    EncodeJournalSize(size, record_.data());
+    method.SerializeWithCachedSizesToArray(&record_[sizeof(std::uint32_t)]);
+    Push(record_.data(), record_.size());
+  } else {
+    static auto* const encoder =
+        new HexadecimalEncoder</*null_terminated=*/true>;
+    auto const hexadecimal = encoder->Encode(SerializeAsBytes(method).get());
+    stream_ << hexadecimal.data.get() << "\n";
+    stream_.flush();
+  }
+}
+
+void Recorder::Push(std::uint8_t const* bytes, std::int64_t size) {
+  std::int64_t const capacity = ring_buffer_.size();
+  std::int64_t pushed_bytes = pushed_bytes_.load(std::memory_order_relaxed);
+  while (size > 0) {
+    std::int64_t const free_bytes =
+        capacity -
+        (pushed_bytes - drained_bytes_.load(std::memory_order_acquire));
+    if (free_bytes == 0) {
+      // The buffer is full, which only happens for huge methods.  The writer
+      // will drain it shortly.
+      std::this_thread::yield();
+      continue;
+    }
+    // The bytes that can be copied without wrapping around.
+    std::int64_t const begin = pushed_bytes % capacity;
+    std::int64_t const count = std::min({size, free_bytes, capacity - begin});
+    std::memcpy(&ring_buffer_[begin], bytes, count);
+    bytes += count;
+    size -= count;
+    pushed_bytes += count;
+    // Publishing a partial record is harmless, the writer doesn't care about
+    // the boundaries of the records.
+    pushed_bytes_.store(pushed_bytes, std::memory_order_release);
+  }
+}
+
+void Recorder::RepeatedlyWriteBlocks() {
+  std::int64_t const capacity = ring_buffer_.size();
+  std::string batch;
+  for (;;) {
+    // Load |shutdown_| first to be sure to see all the methods written before
+    // the shutdown.
+    bool const shutdown = shutdown_.load(std::memory_order_acquire);
+    std::int64_t const drained_bytes =
+        drained_bytes_.load(std::memory_order_relaxed);
+    std::int64_t const pushed_bytes =
+        pushed_bytes_.load(std::memory_order_acquire);
+    if (pushed_bytes == drained_bytes) {
+      if (shutdown) {
+        return;
+      }
+      absl::SleepFor(writer_period);
+      continue;
+    }
+
+    // Copy the bytes out of the buffer so that the producer may reuse it while
+    // we compress and write.
+    std::int64_t const begin = drained_bytes % capacity;
+    std::int64_t const end = begin + (pushed_bytes - drained_bytes);
+    char const* const data =
+        reinterpret_cast<char const*>(ring_buffer_.data());
+    batch.assign(data + begin, data + std::min(end, capacity));
+    if (end > capacity) {
+      batch.append(data, data + end - capacity);
+    }
+    drained_bytes_.store(pushed_bytes, std::memory_order_release);
+
+    WriteBlock(batch);
+    flushed_bytes_.store(pushed_bytes, std::memory_order_release);
+
+    if (!shutdown && end - begin < capacity / 2) {
+      absl::SleepFor(writer_period);
+    }
+  }
+}
+
+void Recorder::WriteBlock(std::string const& batch) {
+  std::string compressed;
+  std::string const* block = &batch;
+  if (compressor_ != nullptr) {
+    compressor_->Compress(batch, &compressed);
+    block = &compressed;
+  }
+  std::uint8_t size[sizeof(std::uint32_t)];
+  EncodeJournalSize(block->size(), size);
+  stream_.write(reinterpret_cast<char const*>(size), sizeof(size));
+  stream_.write(block->data(), block->size());
   stream_.flush();
+  CHECK(!stream_.fail());
+}
+
+void Recorder::FlushAndAbort() {
+  // This may run on any thread, possibly one that holds |lock_|, so it must not
+  // lock anything.
+  if (Recorder const* const recorder = active_recorder_;
+      recorder != nullptr &&
+      std::this_thread::get_id() != recorder->writer_.get_id()) {
+    std::int64_t const pushed_bytes =
+        recorder->pushed_bytes_.load(std::memory_order_acquire);
+    absl::Time const deadline = absl::Now() + flush_timeout;
+    while (recorder->flushed_bytes_.load(std::memory_order_acquire) <
+               pushed_bytes &&
+           absl::Now() < deadline) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+  }
+  if (previous_failure_function_ != nullptr) {
+    previous_failure_function_();
+  }
+  std::abort();
 }
 
 Recorder* Recorder::active_recorder_ = nullptr;
+void (*Recorder::previous_failure_function_)() = nullptr;
 
 }  // namespace journal
 }  // namespace principia
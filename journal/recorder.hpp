@@ -1,11 +1,19 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
+#include "gipfeli/compression.h"
 #include "serialization/journal.pb.h"
 
 namespace principia {
@@ -13,10 +21,42 @@ namespace journal {
 
 FORWARD_DECLARE_FROM(method, template<typename Profile> class, Method);
 
+// A binary journal starts with a line containing |binary_journal_header|,
+// followed by a line containing the name of its compressor, which may be
+// empty.  It continues with blocks, each made of a 32-bit size followed by that
+// many (possibly compressed) bytes.  Once uncompressed and concatenated, the
+// blocks form a sequence of records, each made of a 32-bit size followed by
+// that many bytes of a serialized |serialization::Method|.  A record may
+// straddle blocks.  All the sizes are little-endian.  A text journal cannot
+// start with |binary_journal_header| since it is hexadecimal.
+constexpr char binary_journal_header[] = "Principia binary journal";
+
+// Returns the compressor named |name|, or null if |name| is empty.
+std::unique_ptr<google::compression::Compressor> NewJournalCompressor(
+    std::string_view name);
+
+// The encoding of the sizes in a binary journal.
+void EncodeJournalSize(std::uint32_t size, std::uint8_t* bytes);
+std::uint32_t DecodeJournalSize(std::uint8_t const* bytes);
+
 class Recorder final {
  public:
+  // Records a text journal, with one hexadecimal method per line.  The methods
+  // are written and flushed on the calling thread.
   explicit Recorder(std::filesystem::path const& path);
 
+  // Records a binary journal.  The methods are serialized to a lock-free ring
+  // buffer of |buffer_size| bytes and written by a background thread, in
+  // batches compressed with the compressor named |compressor|.  While this
+  // recorder is active, a fatal error waits for the buffer to be written before
+  // aborting.
+  Recorder(std::filesystem::path const& path,
+           std::string_view compressor,
+           std::int64_t buffer_size = default_buffer_size);
+
+  // Writes the rest of the buffer and joins the background thread.
+  ~Recorder();
+
   // Locking is used to ensure that the pairs of writes don't get intermixed.
   void WriteAtConstruction(serialization::Method const& method);
   void WriteAtDestruction(serialization::Method const& method);
@@ -26,12 +66,45 @@ class Recorder final {
   static bool IsActivated();
 
  private:
+  static constexpr std::int64_t default_buffer_size = 16 << 20;
+
   void WriteLocked(serialization::Method const& method);
 
+  // Copies |size| bytes to the ring buffer, waiting for the writer if the
+  // buffer is full.  Only called with |lock_| held, so there is a single
+  // producer.
+  void Push(std::uint8_t const* bytes, std::int64_t size);
+
+  // The loop of the background thread, the single consumer of the ring buffer.
+  void RepeatedlyWriteBlocks();
+  void WriteBlock(std::string const& batch);
+
+  // Waits for the buffer to be written and calls the failure function that
+  // was installed before the recorder was activated.
+  [[noreturn]] static void FlushAndAbort();
+
   absl::Mutex lock_;
   std::ofstream stream_;
 
+  // The following members are only used for binary journals.
+  bool const binary_ = false;
+  std::unique_ptr<google::compression::Compressor> const compressor_;
+  // Only accessed with |lock_| held.
+  std::vector<std::uint8_t> record_;
+  std::vector<std::uint8_t> ring_buffer_;
+  // The byte at index i of the journal is at index i % |ring_buffer_.size()|
+  // in the buffer.  The bytes in [drained_bytes_, pushed_bytes_[ are in the
+  // buffer, and the bytes before |flushed_bytes_| are in the file.
+  std::atomic<std::int64_t> pushed_bytes_ = 0;
+  std::atomic<std::int64_t> drained_bytes_ = 0;
+  std::atomic<std::int64_t> flushed_bytes_ = 0;
+  std::atomic<bool> shutdown_ = false;
+  std::thread writer_;
+
   static Recorder* active_recorder_;
+  // The glog failure function to restore when the active recorder is
+  // deactivated, if it is binary.
+  static void (*previous_failure_function_)();
 
   template<typename>
   friend class Method;
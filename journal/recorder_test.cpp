@@ -8,6 +8,7 @@
 
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "journal/method.hpp"
 #include "journal/profiles.hpp"
@@ -18,6 +19,8 @@
 namespace principia {
 namespace journal {
 
+using ::testing::SizeIs;
+
 class RecorderTest : public testing::Test {
  protected:
   RecorderTest()
@@ -126,5 +129,32 @@ TEST_F(RecorderTest, Recording) {
   }
 }
 
+TEST_F(RecorderTest, BinaryRecording) {
+  Recorder::Deactivate();
+  for (std::string const compressor : {"", "gipfeli"}) {
+    std::string const path = test_name_ + compressor + ".journal.bin";
+    // A tiny buffer, so that the records wrap around and straddle blocks.
+    Recorder::Activate(new Recorder(path, compressor, /*buffer_size=*/16));
+    for (int i = 0; i < 100; ++i) {
+      Method<NewPlugin> m({"1 s", "2 s", static_cast<double>(i)});
+      m.Return(plugin_.get());
+    }
+    Recorder::Deactivate();
+
+    std::vector<serialization::Method> const methods = ReadAll(path);
+    ASSERT_THAT(methods, SizeIs(200));
+    for (int i = 0; i < 100; ++i) {
+      auto const& in =
+          methods[2 * i].GetExtension(serialization::NewPlugin::extension);
+      EXPECT_EQ("1 s", in.in().game_epoch());
+      EXPECT_EQ(i, in.in().planetarium_rotation_in_degrees());
+      auto const& return_ = methods[2 * i + 1].GetExtension(
+          serialization::NewPlugin::extension);
+      EXPECT_TRUE(return_.has_return_());
+    }
+  }
+  Recorder::Activate(new Recorder(test_name_ + ".journal.hex"));
+}
+
 }  // namespace journal
 }  // namespace principia
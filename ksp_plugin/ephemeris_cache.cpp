@@ -0,0 +1,257 @@
+#include "ksp_plugin/ephemeris_cache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "base/fingerprint2011.hpp"
+#include "base/mapped_file.hpp"
+#include "glog/logging.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/ksp_plugin.pb.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_ephemeris_cache {
+
+using base::Fingerprint2011;
+using base::MappedFile;
+using quantities::Time;
+using quantities::si::Day;
+
+// More than the time between checkpoints of the ephemeris, so that an update
+// finds a checkpoint more recent than the one in the cache.
+constexpr Time min_time_between_updates = 365 * Day;
+
+namespace {
+
+// Returns false, after logging a warning, if |file| cannot be parsed by
+// protocol buffers.
+bool IsReadable(MappedFile const& file, std::filesystem::path const& path) {
+  if (!file.ok()) {
+    LOG(WARNING) << "Cannot map ephemeris cache " << path;
+    return false;
+  }
+  if (file.bytes().size > std::numeric_limits<int>::max()) {
+    LOG(WARNING) << "Ephemeris cache " << path << " is too large";
+    return false;
+  }
+  return true;
+}
+
+// Reads the header of the cache file from |stream|, leaving the stream at the
+// beginning of the ephemeris.  Returns false if the file is malformed.
+bool ReadHeader(google::protobuf::io::CodedInputStream& stream,
+                serialization::EphemerisCacheHeader& header) {
+  std::uint32_t header_size;
+  if (!stream.ReadVarint32(&header_size)) {
+    return false;
+  }
+  auto const limit = stream.PushLimit(header_size);
+  if (!header.ParseFromCodedStream(&stream) ||
+      !stream.ConsumedEntireMessage()) {
+    return false;
+  }
+  stream.PopLimit(limit);
+  return true;
+}
+
+}  // namespace
+
+EphemerisCache::EphemerisCache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {}
+
+not_null<std::unique_ptr<Ephemeris<Barycentric>>>
+EphemerisCache::ReadEphemeris(serialization::Ephemeris const& message) {
+  std::uint64_t const fingerprint = Fingerprint(message);
+  std::filesystem::path const path = Path(fingerprint);
+  std::error_code error;
+  if (!message.has_checkpoint_time() ||
+      !std::filesystem::is_regular_file(path, error)) {
+    return Ephemeris<Barycentric>::ReadFromMessage(message);
+  }
+
+  // Only the header is parsed if the cache doesn't extend beyond the save,
+  // which is the common case early in a campaign.  Otherwise the ephemeris is
+  // parsed directly from the mapped pages, without first copying the file to a
+  // buffer.
+  MappedFile const file(path);
+  if (!IsReadable(file, path)) {
+    return Ephemeris<Barycentric>::ReadFromMessage(message);
+  }
+  auto const bytes = file.bytes();
+  google::protobuf::io::CodedInputStream stream(bytes.data,
+                                                static_cast<int>(bytes.size));
+  stream.SetTotalBytesLimit(std::numeric_limits<int>::max(),
+                            std::numeric_limits<int>::max());
+  serialization::EphemerisCacheHeader header;
+  if (!ReadHeader(stream, header) || header.fingerprint() != fingerprint) {
+    LOG(WARNING) << "Malformed ephemeris cache " << path;
+    return Ephemeris<Barycentric>::ReadFromMessage(message);
+  }
+  Instant const checkpoint_time =
+      Instant::ReadFromMessage(message.checkpoint_time());
+  cached_checkpoint_time_ = Instant::ReadFromMessage(header.checkpoint_time());
+  if (*cached_checkpoint_time_ <= checkpoint_time) {
+    return Ephemeris<Barycentric>::ReadFromMessage(message);
+  }
+
+  serialization::Ephemeris cached_message;
+  if (!cached_message.ParseFromCodedStream(&stream) ||
+      !stream.ConsumedEntireMessage()) {
+    LOG(WARNING) << "Malformed ephemeris cache " << path;
+    return Ephemeris<Barycentric>::ReadFromMessage(message);
+  }
+  if (!Agrees(cached_message, message)) {
+    LOG(WARNING) << "Ephemeris cache " << path
+                 << " doesn't agree with the save";
+    return Ephemeris<Barycentric>::ReadFromMessage(message);
+  }
+  LOG(INFO) << "Reading the ephemeris from " << path << " up to "
+            << *cached_checkpoint_time_ << " instead of " << checkpoint_time;
+  return Ephemeris<Barycentric>::ReadFromMessage(cached_message);
+}
+
+void EphemerisCache::Update(Ephemeris<Barycentric> const& ephemeris) {
+  if (cached_checkpoint_time_.has_value() &&
+      ephemeris.t_max() - *cached_checkpoint_time_ < min_time_between_updates) {
+    return;
+  }
+
+  serialization::Ephemeris message;
+  ephemeris.WriteToMessageUpToNewestCheckpoint(&message);
+  std::uint64_t const fingerprint = Fingerprint(message);
+  Instant const checkpoint_time =
+      Instant::ReadFromMessage(message.checkpoint_time());
+  std::filesystem::path const path = Path(fingerprint);
+
+  // Another game may have written a more recent cache in the meantime.
+  std::error_code error;
+  if (std::filesystem::is_regular_file(path, error)) {
+    MappedFile const file(path);
+    if (IsReadable(file, path)) {
+      auto const bytes = file.bytes();
+      google::protobuf::io::CodedInputStream stream(
+          bytes.data, static_cast<int>(bytes.size));
+      serialization::EphemerisCacheHeader header;
+      if (ReadHeader(stream, header) && header.fingerprint() == fingerprint) {
+        Instant const cached_checkpoint_time =
+            Instant::ReadFromMessage(header.checkpoint_time());
+        if (checkpoint_time <= cached_checkpoint_time) {
+          cached_checkpoint_time_ = cached_checkpoint_time;
+          return;
+        }
+      }
+    }
+  }
+
+  serialization::EphemerisCacheHeader header;
+  header.set_fingerprint(fingerprint);
+  checkpoint_time.WriteToMessage(header.mutable_checkpoint_time());
+
+  // Write to a temporary file and rename it, so that the readers never see a
+  // partial file.  The name of the temporary file is random so that concurrent
+  // writers don't collide.
+  // The cache is an optimization: if it cannot be written, we'll just
+  // reintegrate at the next load.
+  std::filesystem::create_directories(directory_, error);
+  std::filesystem::path temporary_path = path;
+  temporary_path += "." + std::to_string(std::random_device()()) + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    if (!file.good()) {
+      LOG(WARNING) << "Cannot create ephemeris cache " << temporary_path;
+      return;
+    }
+    {
+      google::protobuf::io::OstreamOutputStream output_stream(&file);
+      google::protobuf::io::CodedOutputStream coded_stream(&output_stream);
+      coded_stream.WriteVarint32(header.ByteSize());
+      CHECK(header.SerializeToCodedStream(&coded_stream));
+      CHECK(message.SerializeToCodedStream(&coded_stream));
+    }
+    file.close();
+    if (file.fail()) {
+      LOG(WARNING) << "Cannot write ephemeris cache " << temporary_path;
+      std::filesystem::remove(temporary_path, error);
+      return;
+    }
+  }
+  std::filesystem::rename(temporary_path, path, error);
+  if (error) {
+    // On Windows, this happens if another game has the cache file mapped.  The
+    // cache will be updated later.
+    LOG(WARNING) << "Cannot replace ephemeris cache " << path << ": "
+                 << error.message();
+    std::filesystem::remove(temporary_path, error);
+    return;
+  }
+  LOG(INFO) << "Wrote the ephemeris to " << path << " up to "
+            << checkpoint_time;
+  cached_checkpoint_time_ = checkpoint_time;
+}
+
+std::filesystem::path const& EphemerisCache::directory() const {
+  return directory_;
+}
+
+std::uint64_t EphemerisCache::Fingerprint(
+    serialization::Ephemeris const& message) {
+  serialization::Ephemeris model;
+  *model.mutable_body() = message.body();
+  *model.mutable_accuracy_parameters() = message.accuracy_parameters();
+  *model.mutable_fixed_step_parameters() = message.fixed_step_parameters();
+  // The model is not initialized since it has no instance.
+  std::string const bytes = model.SerializePartialAsString();
+  return Fingerprint2011(bytes.data(), bytes.size());
+}
+
+bool EphemerisCache::Agrees(serialization::Ephemeris const& cached,
+                            serialization::Ephemeris const& message) {
+  if (cached.trajectory_size() != message.trajectory_size()) {
+    return false;
+  }
+  for (int i = 0; i < message.trajectory_size(); ++i) {
+    auto const& pairs = message.trajectory(i).instant_polynomial_pair();
+    auto const& cached_pairs = cached.trajectory(i).instant_polynomial_pair();
+    if (pairs.empty()) {
+      return false;
+    }
+    for (auto const* const pair : {&pairs[0], &pairs[pairs.size() - 1]}) {
+      Instant const t_max = Instant::ReadFromMessage(pair->t_max());
+      auto const it = std::partition_point(
+          cached_pairs.begin(),
+          cached_pairs.end(),
+          [&t_max](serialization::ContinuousTrajectory::
+                       InstantPolynomialPair const& cached_pair) {
+            return Instant::ReadFromMessage(cached_pair.t_max()) < t_max;
+          });
+      if (it == cached_pairs.end() ||
+          it->SerializeAsString() != pair->SerializeAsString()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::filesystem::path EphemerisCache::Path(
+    std::uint64_t const fingerprint) const {
+  std::stringstream name;
+  name << "ephemeris." << std::hex << std::uppercase << fingerprint
+       << ".cache";
+  return directory_ / name.str();
+}
+
+}  // namespace internal_ephemeris_cache
+}  // namespace ksp_plugin
+}  // namespace principia
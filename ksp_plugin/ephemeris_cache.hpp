@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "physics/ephemeris.hpp"
+#include "serialization/physics.pb.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_ephemeris_cache {
+
+using base::not_null;
+using geometry::Instant;
+using physics::Ephemeris;
+
+// A cache of the ephemeris on disk, which avoids reintegrating the solar system
+// from the oldest checkpoint of the save when loading a game late in a
+// campaign.  There is one file per set of bodies and ephemeris parameters,
+// identified by their fingerprint, so the cache is shared by all the games that
+// use the same solar system.  The file contains an ephemeris written up to its
+// newest checkpoint; it is mapped in memory when read, and replaced atomically
+// when written, so that concurrent games see a consistent file.
+// The cache is only used if its trajectories agree exactly with those of the
+// save: a stale or unrelated cache file is harmless.
+class EphemerisCache final {
+ public:
+  explicit EphemerisCache(std::filesystem::path directory);
+
+  // Reads the ephemeris from the cache if the cache agrees with |message| and
+  // extends further in the future, otherwise from |message|.  In both cases,
+  // the ephemeris must be prolonged by the caller as with
+  // |Ephemeris::ReadFromMessage|.
+  not_null<std::unique_ptr<Ephemeris<Barycentric>>> ReadEphemeris(
+      serialization::Ephemeris const& message);
+
+  // Writes |ephemeris| to the cache if its newest checkpoint is more recent
+  // than that of the cache.  The ephemeris is only serialized if it has been
+  // prolonged sufficiently since the last update.
+  void Update(Ephemeris<Barycentric> const& ephemeris);
+
+  std::filesystem::path const& directory() const;
+
+ private:
+  // The fingerprint of the bodies and of the parameters in |message|.
+  static std::uint64_t Fingerprint(serialization::Ephemeris const& message);
+
+  // Returns true if the trajectories in |cached| contain the first and last
+  // segments of the corresponding trajectories in |message|.  Since the
+  // integration is deterministic, this means that both messages describe the
+  // same ephemeris.
+  static bool Agrees(serialization::Ephemeris const& cached,
+                     serialization::Ephemeris const& message);
+
+  std::filesystem::path Path(std::uint64_t fingerprint) const;
+
+  std::filesystem::path const directory_;
+
+  // The time of the newest checkpoint in the cache file for our ephemeris, if
+  // known.
+  std::optional<Instant> cached_checkpoint_time_;
+};
+
+}  // namespace internal_ephemeris_cache
+
+using internal_ephemeris_cache::EphemerisCache;
+
+}  // namespace ksp_plugin
+}  // namespace principia
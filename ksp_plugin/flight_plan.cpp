@@ -2,6 +2,10 @@
 #include "ksp_plugin/flight_plan.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -9,6 +13,8 @@
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 #include "integrators/methods.hpp"
 #include "ksp_plugin/integrators.hpp"
+#include "physics/apsides.hpp"
+#include "serialization/physics.pb.h"
 #include "testing_utilities/make_not_null.hpp"
 
 namespace principia {
@@ -18,6 +24,8 @@ namespace internal_flight_plan {
 using base::Error;
 using base::make_not_null_unique;
 using base::Status;
+using base::TaskGroup;
+using base::TaskPriority;
 using geometry::Position;
 using geometry::Vector;
 using geometry::Velocity;
@@ -25,10 +33,24 @@ using integrators::EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator;
 using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
 using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
 using integrators::methods::Fine1987RKNG34;
+using physics::ComputeApsides;
 using quantities::Acceleration;
 using quantities::si::Metre;
 using quantities::si::Second;
 
+// The maximum number of slices of a coast.  It doesn't depend on the number of
+// workers so that a flight plan, or the replay of a journal, is the same on all
+// machines.
+constexpr int parareal_max_slices = 16;
+// The coarse integrations use tolerances that are larger than those of the
+// fine integrations by this factor.
+constexpr double parareal_coarse_tolerance_factor = 1e4;
+// Parareal is exact after as many iterations as there are slices, but it is
+// then much more expensive than a sequential integration, so after this many
+// iterations we keep the slices that are exact and integrate the rest of the
+// coast sequentially.
+constexpr int parareal_max_iterations = 5;
+
 inline Status const BadDesiredFinalTime() {
   return Status(FlightPlan::bad_desired_final_time, "Bad desired final time");
 }
@@ -41,6 +63,17 @@ inline Status const Singular() {
   return Status(FlightPlan::singular, "Singular");
 }
 
+// Returns true if |left| and |right| have the same serialization, i.e., if
+// they result in the same integrations.
+template<typename Parameters>
+bool SameParameters(Parameters const& left, Parameters const& right) {
+  serialization::Ephemeris::AdaptiveStepParameters left_message;
+  serialization::Ephemeris::AdaptiveStepParameters right_message;
+  left.WriteToMessage(&left_message);
+  right.WriteToMessage(&right_message);
+  return left_message.SerializeAsString() == right_message.SerializeAsString();
+}
+
 FlightPlan::FlightPlan(
     Mass const& initial_mass,
     Instant const& initial_time,
@@ -50,7 +83,9 @@ FlightPlan::FlightPlan(
     Ephemeris<Barycentric>::AdaptiveStepParameters const&
         adaptive_step_parameters,
     Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
-        generalized_adaptive_step_parameters)
+        generalized_adaptive_step_parameters,
+    TaskScheduler* const coast_scheduler,
+    Time const& coast_minimum_slice_duration)
     : initial_mass_(initial_mass),
       initial_time_(initial_time),
       initial_degrees_of_freedom_(initial_degrees_of_freedom),
@@ -59,7 +94,9 @@ FlightPlan::FlightPlan(
       ephemeris_(ephemeris),
       adaptive_step_parameters_(adaptive_step_parameters),
       generalized_adaptive_step_parameters_(
-          generalized_adaptive_step_parameters) {
+          generalized_adaptive_step_parameters),
+      coast_scheduler_(coast_scheduler),
+      coast_minimum_slice_duration_(coast_minimum_slice_duration) {
   CHECK(desired_final_time_ >= initial_time_);
 
   // Set the (single) point of the root.
@@ -67,6 +104,7 @@ FlightPlan::FlightPlan(
 
   // Create a fork for the first coasting trajectory.
   segments_.emplace_back(root_->NewForkWithoutCopy(initial_time_));
+  segments_.back()->EnableLevelOfDetail();
   CHECK(manœuvres_.empty());
   ComputeSegments(manœuvres_.begin(), manœuvres_.end());
 }
@@ -107,10 +145,10 @@ Status FlightPlan::Append(NavigationManœuvre::Burn const& burn) {
   if (!manœuvre.FitsBetween(start_of_last_coast(), desired_final_time_)) {
     return DoesNotFit();
   }
-  // Reset the last coast and integrate it followed by a burn followed by a new
-  // last coast;
+  // Reset the last coast unless it already ends where the burn starts, and
+  // integrate it followed by a burn followed by a new last coast;
   manœuvres_.push_back(manœuvre);
-  ResetLastSegment();
+  ReuseOrResetLastSegment(manœuvre.initial_time());
   return ComputeSegments(manœuvres_.begin() + manœuvres_.size() - 1,
                          manœuvres_.end());
 }
@@ -193,13 +231,46 @@ Status FlightPlan::Replace(NavigationManœuvre::Burn const& burn,
     PopLastSegment();  // Last burn.
   }
 
-  // TODO(phl): Recompute as late as possible.
   // At this point the last coast is the one to which |manœuvre| gets attached.
-  // Clear it and recompute everything that follows.
-  ResetLastSegment();
+  // It only depends on the initial time of |manœuvre|, so it is kept if that
+  // time is unchanged.  Recompute everything that follows.
+  ReuseOrResetLastSegment(manœuvre.initial_time());
   return ComputeSegments(manœuvres_.begin() + index, manœuvres_.end());
 }
 
+std::vector<FlightPlan::Evaluation> FlightPlan::EvaluateReplacements(
+    int const index,
+    std::vector<NavigationManœuvre::Burn> const& burns,
+    Trajectory<Barycentric> const* const reference,
+    TaskScheduler& scheduler) const {
+  CHECK_LE(0, index);
+  CHECK_LT(index, number_of_manœuvres());
+  std::vector<Evaluation> evaluations(burns.size());
+
+  // If the coast that precedes the manœuvre is anomalous, so are all the
+  // evaluations.
+  if (2 * index >= number_of_segments() - anomalous_segments_) {
+    for (auto& evaluation : evaluations) {
+      evaluation.status = anomalous_status_;
+    }
+    return evaluations;
+  }
+
+  // Prolong the ephemeris beforehand, otherwise the evaluations would contend
+  // for its lock to prolong it step by step.
+  ephemeris_->Prolong(desired_final_time_);
+  {
+    TaskGroup group(scheduler, TaskPriority::Critical);
+    for (int i = 0; i < burns.size(); ++i) {
+      group.Spawn([this, index, &burn = burns[i], reference,
+                   &evaluation = evaluations[i]]() {
+        evaluation = EvaluateReplacement(index, burn, reference);
+      });
+    }
+  }
+  return evaluations;
+}
+
 Status FlightPlan::SetDesiredFinalTime(Instant const& desired_final_time) {
   if (desired_final_time < start_of_last_coast()) {
     return BadDesiredFinalTime();
@@ -215,9 +286,39 @@ Status FlightPlan::SetAdaptiveStepParameters(
         adaptive_step_parameters,
     Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
         generalized_adaptive_step_parameters) {
+  bool const adaptive_step_parameters_changed =
+      !SameParameters(adaptive_step_parameters_, adaptive_step_parameters);
+  bool const generalized_adaptive_step_parameters_changed =
+      !SameParameters(generalized_adaptive_step_parameters_,
+                      generalized_adaptive_step_parameters);
   adaptive_step_parameters_ = adaptive_step_parameters;
   generalized_adaptive_step_parameters_ = generalized_adaptive_step_parameters;
-  return RecomputeAllSegments();
+  if (adaptive_step_parameters_changed) {
+    return RecomputeAllSegments();
+  }
+
+  // The generalized parameters are only used by the burns that are not
+  // inertially fixed: the segments that precede the first of them are
+  // unaffected.
+  std::optional<int> first_to_recompute;
+  if (generalized_adaptive_step_parameters_changed) {
+    for (int i = 0; i < manœuvres_.size(); ++i) {
+      if (!manœuvres_[i].is_inertially_fixed()) {
+        first_to_recompute = i;
+        break;
+      }
+    }
+  }
+  if (!first_to_recompute) {
+    return anomalous_segments_ == 0 ? Status::OK : anomalous_status_;
+  }
+  for (int i = *first_to_recompute; i < manœuvres_.size(); ++i) {
+    PopLastSegment();  // Last coast.
+    PopLastSegment();  // Last burn.
+  }
+  auto const first = manœuvres_.begin() + *first_to_recompute;
+  ReuseOrResetLastSegment(first->initial_time());
+  return ComputeSegments(first, manœuvres_.end());
 }
 
 Ephemeris<Barycentric>::AdaptiveStepParameters const&
@@ -270,7 +371,8 @@ void FlightPlan::WriteToMessage(
 
 std::unique_ptr<FlightPlan> FlightPlan::ReadFromMessage(
     serialization::FlightPlan const& message,
-    not_null<Ephemeris<Barycentric>*> const ephemeris) {
+    not_null<Ephemeris<Barycentric>*> const ephemeris,
+    TaskScheduler* const coast_scheduler) {
   Instant initial_time = Instant::ReadFromMessage(message.initial_time());
   std::unique_ptr<DegreesOfFreedom<Barycentric>> initial_degrees_of_freedom;
   CHECK(message.has_adaptive_step_parameters());
@@ -306,7 +408,8 @@ std::unique_ptr<FlightPlan> FlightPlan::ReadFromMessage(
       Instant::ReadFromMessage(message.desired_final_time()),
       ephemeris,
       *adaptive_step_parameters,
-      *generalized_adaptive_step_parameters);
+      *generalized_adaptive_step_parameters,
+      coast_scheduler);
 
   for (int i = 0; i < message.manoeuvre_size(); ++i) {
     auto const& manoeuvre = message.manoeuvre(i);
@@ -355,6 +458,79 @@ Status FlightPlan::RecomputeAllSegments() {
   return ComputeSegments(manœuvres_.begin(), manœuvres_.end());
 }
 
+FlightPlan::Evaluation FlightPlan::EvaluateReplacement(
+    int const index,
+    NavigationManœuvre::Burn const& burn,
+    Trajectory<Barycentric> const* const reference) const {
+  Evaluation evaluation;
+
+  // The manœuvres of the scratch flight plan, with their initial masses.
+  std::vector<NavigationManœuvre> manœuvres;
+  Mass initial_mass = manœuvres_[index].initial_mass();
+  for (int i = index; i < manœuvres_.size(); ++i) {
+    manœuvres.emplace_back(initial_mass,
+                           i == index ? burn : manœuvres_[i].burn());
+    initial_mass = manœuvres.back().final_mass();
+  }
+
+  // The scratch flight plan is created empty, and each manœuvre is appended
+  // with a desired final time at the beginning of the next one, so that its
+  // last coast is only integrated as far as needed.  Its coasts are computed
+  // like ours, so that the evaluation agrees with |Replace|.
+  auto const fork = segments_[2 * index]->Fork();
+  FlightPlan flight_plan(manœuvres.front().initial_mass(),
+                         /*initial_time=*/fork->time,
+                         /*initial_degrees_of_freedom=*/
+                             fork->degrees_of_freedom,
+                         /*desired_final_time=*/fork->time,
+                         ephemeris_,
+                         adaptive_step_parameters_,
+                         generalized_adaptive_step_parameters_,
+                         coast_scheduler_,
+                         coast_minimum_slice_duration_);
+  for (int i = 0; i < manœuvres.size(); ++i) {
+    flight_plan.desired_final_time_ = i + 1 < manœuvres.size()
+                                          ? manœuvres[i + 1].initial_time()
+                                          : desired_final_time_;
+    Status const status = flight_plan.Append(manœuvres[i].burn());
+    if (status.error() == singular || status.error() == does_not_fit) {
+      evaluation.status = status;
+      return evaluation;
+    }
+    evaluation.status.Update(status);
+  }
+
+  auto const& [final_time, final_degrees_of_freedom] =
+      flight_plan.segments_.back()->back();
+  evaluation.final_time = final_time;
+  evaluation.final_degrees_of_freedom = final_degrees_of_freedom;
+  evaluation.final_mass = flight_plan.manœuvres_.back().final_mass();
+
+  if (reference != nullptr) {
+    DiscreteTrajectory<Barycentric>::Iterator begin;
+    DiscreteTrajectory<Barycentric>::Iterator end;
+    flight_plan.GetAllSegments(begin, end);
+    DiscreteTrajectory<Barycentric> apoapsides;
+    DiscreteTrajectory<Barycentric> periapsides;
+    ComputeApsides(*reference,
+                   begin,
+                   end,
+                   /*max_points=*/std::numeric_limits<int>::max(),
+                   apoapsides,
+                   periapsides);
+    for (auto const& [time, degrees_of_freedom] : periapsides) {
+      Length const distance = (degrees_of_freedom.position() -
+                               reference->EvaluatePosition(time)).Norm();
+      if (!evaluation.periapsis_distance ||
+          distance < *evaluation.periapsis_distance) {
+        evaluation.periapsis_time = time;
+        evaluation.periapsis_distance = distance;
+      }
+    }
+  }
+  return evaluation;
+}
+
 Status FlightPlan::BurnSegment(
     NavigationManœuvre const& manœuvre,
     not_null<DiscreteTrajectory<Barycentric>*> const segment) {
@@ -383,14 +559,196 @@ Status FlightPlan::BurnSegment(
 Status FlightPlan::CoastSegment(
     Instant const& desired_final_time,
     not_null<DiscreteTrajectory<Barycentric>*> const segment) {
+  auto parameters = adaptive_step_parameters_;
+  if (coast_scheduler_ != nullptr) {
+    // The steps of the slices count towards |max_steps|, so that the anomalies
+    // are reported by the sequential integration below.
+    std::int64_t const steps = ParallelCoastSegment(
+        desired_final_time, parameters.max_steps(), segment);
+    parameters.set_max_steps(parameters.max_steps() - steps);
+  }
   return ephemeris_->FlowWithAdaptiveStep(
                          segment,
                          Ephemeris<Barycentric>::NoIntrinsicAcceleration,
                          desired_final_time,
-                         adaptive_step_parameters_,
+                         parameters,
                          max_ephemeris_steps_per_frame);
 }
 
+std::int64_t FlightPlan::ParallelCoastSegment(
+    Instant const& desired_final_time,
+    std::int64_t const max_steps,
+    not_null<DiscreteTrajectory<Barycentric>*> const segment) {
+  auto const& parameters = adaptive_step_parameters_;
+  Instant const t_initial = segment->back().time;
+  DegreesOfFreedom<Barycentric> const initial_degrees_of_freedom =
+      segment->back().degrees_of_freedom;
+  double const max_slices =
+      (desired_final_time - t_initial) / coast_minimum_slice_duration_;
+  int const slices = max_slices < parareal_max_slices
+                         ? static_cast<int>(max_slices)
+                         : parareal_max_slices;
+  if (slices < 2) {
+    return 0;
+  }
+
+  // Prolong the ephemeris beforehand, otherwise the slices would contend for
+  // its lock to prolong it step by step.
+  ephemeris_->Prolong(desired_final_time);
+
+  // The |n|th slice is [times[n], times[n + 1]].
+  std::vector<Instant> times;
+  for (int n = 0; n < slices; ++n) {
+    times.push_back(t_initial + n * (desired_final_time - t_initial) / slices);
+  }
+  times.push_back(desired_final_time);
+
+  auto coarse_parameters = parameters;
+  coarse_parameters.set_length_integration_tolerance(
+      parareal_coarse_tolerance_factor *
+      parameters.length_integration_tolerance());
+  coarse_parameters.set_speed_integration_tolerance(
+      parareal_coarse_tolerance_factor *
+      parameters.speed_integration_tolerance());
+  auto const coarse_integration =
+      [this, &coarse_parameters, &times](
+          int const n,
+          DegreesOfFreedom<Barycentric> const& degrees_of_freedom)
+      -> std::optional<DegreesOfFreedom<Barycentric>> {
+    DiscreteTrajectory<Barycentric> slice;
+    slice.Append(times[n], degrees_of_freedom);
+    Status const status = ephemeris_->FlowWithAdaptiveStep(
+                              &slice,
+                              Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+                              times[n + 1],
+                              coarse_parameters,
+                              max_ephemeris_steps_per_frame);
+    if (!status.ok()) {
+      return std::nullopt;
+    }
+    return slice.back().degrees_of_freedom;
+  };
+
+  // |states[n]| is the estimate of the state at the beginning of the |n|th
+  // slice, and |coarse_states[n]| is the coarse integration of the |n|th slice
+  // from that estimate.  The initial estimates are obtained sequentially by
+  // the coarse integration.
+  std::vector<DegreesOfFreedom<Barycentric>> states = {
+      initial_degrees_of_freedom};
+  std::vector<DegreesOfFreedom<Barycentric>> coarse_states;
+  for (int n = 0; n < slices; ++n) {
+    auto const coarse_state = coarse_integration(n, states[n]);
+    if (!coarse_state) {
+      return 0;
+    }
+    coarse_states.push_back(*coarse_state);
+    states.push_back(*coarse_state);
+  }
+
+  std::vector<std::unique_ptr<DiscreteTrajectory<Barycentric>>> fine_slices(
+      slices);
+  // Whether each fine slice was integrated successfully until its end; a
+  // collision stops the integration early without returning an error.  Not a
+  // vector<bool> since the elements are written concurrently.
+  std::vector<char> fine_slices_complete(slices, false);
+  // The slices before |accepted_slices| are appended to |segment|.  These are
+  // all the slices if the iterations converge, otherwise the ones that were
+  // integrated from an exact initial state, i.e., that are the same as a
+  // sequential integration restarted at the beginning of each slice.
+  int accepted_slices = 0;
+  for (int k = 0; k < parareal_max_iterations; ++k) {
+    // After |k| iterations the states at the beginning of the slices up to the
+    // |k|th are exact, so only the subsequent slices are integrated.
+    {
+      TaskGroup group(*coast_scheduler_, TaskPriority::Critical);
+      for (int n = k; n < slices; ++n) {
+        fine_slices[n] = std::make_unique<DiscreteTrajectory<Barycentric>>();
+        fine_slices[n]->Append(times[n], states[n]);
+        group.Spawn([this, &parameters, &times, n,
+                     slice = fine_slices[n].get(),
+                     &complete = fine_slices_complete[n]]() {
+          Status const status = ephemeris_->FlowWithAdaptiveStep(
+              slice,
+              Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+              times[n + 1],
+              parameters,
+              max_ephemeris_steps_per_frame);
+          complete = status.ok() && slice->back().time == times[n + 1];
+        });
+      }
+    }
+    if (fine_slices_complete[k]) {
+      accepted_slices = k + 1;
+    }
+    if (std::find(fine_slices_complete.begin() + k,
+                  fine_slices_complete.end(),
+                  false) != fine_slices_complete.end()) {
+      break;
+    }
+
+    // The fine slices are consistent if the jumps between the end of each of
+    // them and the beginning of the next one are within the tolerances.
+    bool converged = true;
+    for (int n = k; n < slices - 1; ++n) {
+      auto const& fine_state = fine_slices[n]->back().degrees_of_freedom;
+      if ((fine_state.position() - states[n + 1].position()).Norm() >
+              parameters.length_integration_tolerance() ||
+          (fine_state.velocity() - states[n + 1].velocity()).Norm() >
+              parameters.speed_integration_tolerance()) {
+        converged = false;
+        break;
+      }
+    }
+    if (converged) {
+      accepted_slices = slices;
+      break;
+    }
+
+    // The Parareal correction, which is sequential but only involves coarse
+    // integrations.  The state at the beginning of the |k + 1|st slice becomes
+    // exact: it is the end of the |k|th fine slice.
+    states[k + 1] = fine_slices[k]->back().degrees_of_freedom;
+    bool coarse_integration_failed = false;
+    for (int n = k + 1; n < slices - 1; ++n) {
+      auto const coarse_state = coarse_integration(n, states[n]);
+      if (!coarse_state) {
+        coarse_integration_failed = true;
+        break;
+      }
+      auto const& fine_state = fine_slices[n]->back().degrees_of_freedom;
+      states[n + 1] = DegreesOfFreedom<Barycentric>(
+          coarse_state->position() +
+              (fine_state.position() - coarse_states[n].position()),
+          coarse_state->velocity() +
+              (fine_state.velocity() - coarse_states[n].velocity()));
+      coarse_states[n] = *coarse_state;
+    }
+    if (coarse_integration_failed) {
+      break;
+    }
+  }
+
+  // Append the accepted slices, in order, as long as they fit in |max_steps|.
+  // The rest of the coast, if any, is integrated sequentially by the caller
+  // from the end of the last slice appended.  It must be left at least one
+  // step, since the integrator doesn't stop after 0 steps.
+  std::int64_t steps = 0;
+  for (int n = 0; n < accepted_slices; ++n) {
+    auto const& slice = *fine_slices[n];
+    std::int64_t const slice_steps = slice.Size() - 1;  // Not the first point.
+    if (steps + slice_steps > max_steps ||
+        (steps + slice_steps == max_steps && n < slices - 1)) {
+      break;
+    }
+    for (auto it = std::next(slice.begin()); it != slice.end(); ++it) {
+      auto const& [time, degrees_of_freedom] = *it;
+      segment->Append(time, degrees_of_freedom);
+    }
+    steps += slice_steps;
+  }
+  return steps;
+}
+
 Status FlightPlan::ComputeSegments(
     std::vector<NavigationManœuvre>::iterator const begin,
     std::vector<NavigationManœuvre>::iterator const end) {
@@ -446,6 +804,7 @@ Status FlightPlan::ComputeSegments(
 
 void FlightPlan::AddLastSegment() {
   segments_.emplace_back(segments_.back()->NewForkAtLast());
+  segments_.back()->EnableLevelOfDetail();
   if (anomalous_segments_ > 0) {
     ++anomalous_segments_;
   }
@@ -458,6 +817,12 @@ void FlightPlan::ResetLastSegment() {
   }
 }
 
+void FlightPlan::ReuseOrResetLastSegment(Instant const& time) {
+  if (anomalous_segments_ > 0 || segments_.back()->back().time != time) {
+    ResetLastSegment();
+  }
+}
+
 void FlightPlan::PopLastSegment() {
   DiscreteTrajectory<Barycentric>* trajectory = segments_.back();
   CHECK(!trajectory->is_root());
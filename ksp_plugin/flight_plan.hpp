@@ -1,10 +1,12 @@
 ﻿
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include "base/not_null.hpp"
 #include "base/status.hpp"
+#include "base/task_scheduler.hpp"
 #include "geometry/named_quantities.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "ksp_plugin/frames.hpp"
@@ -12,8 +14,10 @@
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
+#include "physics/trajectory.hpp"
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
 #include "serialization/ksp_plugin.pb.h"
 
 namespace principia {
@@ -23,14 +27,17 @@ namespace internal_flight_plan {
 using base::Error;
 using base::not_null;
 using base::Status;
+using base::TaskScheduler;
 using geometry::Instant;
 using integrators::AdaptiveStepSizeIntegrator;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
+using physics::Trajectory;
 using quantities::Length;
 using quantities::Mass;
 using quantities::Speed;
+using quantities::Time;
 
 // A chain of trajectories obtained by executing the corresponding
 // |NavigationManœuvre|s.
@@ -41,6 +48,12 @@ class FlightPlan {
   // trajectories are computed using the given parameters by the given
   // |ephemeris|.  The flight plan contains a single coast which, if possible
   // ends at |desired_final_time|.
+  // If |coast_scheduler| is not null, the coasts that can be split in at least
+  // two slices of |coast_minimum_slice_duration| are integrated in parallel in
+  // time on |coast_scheduler|, see |ParallelCoastSegment|.  Otherwise the
+  // coasts are integrated sequentially.  The scheduler is fixed for the
+  // lifetime of the flight plan, so that all its coasts are computed the same
+  // way.
   FlightPlan(Mass const& initial_mass,
              Instant const& initial_time,
              DegreesOfFreedom<Barycentric> const& initial_degrees_of_freedom,
@@ -49,7 +62,10 @@ class FlightPlan {
              Ephemeris<Barycentric>::AdaptiveStepParameters const&
                  adaptive_step_parameters,
              Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
-                 generalized_adaptive_step_parameters);
+                 generalized_adaptive_step_parameters,
+             TaskScheduler* coast_scheduler = nullptr,
+             Time const& coast_minimum_slice_duration =
+                 default_minimum_coast_slice_duration);
   virtual ~FlightPlan() = default;
 
   // Construction parameters.
@@ -97,13 +113,42 @@ class FlightPlan {
   // Otherwise, updates the flight plan and returns the integration status.
   virtual Status Replace(NavigationManœuvre::Burn const& burn, int index);
 
+  // The outcome of replacing a manœuvre with a candidate burn, see
+  // |EvaluateReplacements|.
+  struct Evaluation final {
+    // An error if the burn is singular or doesn't fit, otherwise the status of
+    // the integration.
+    Status status;
+    // The end of the flight plan.  Not set if the burn is singular or doesn't
+    // fit.
+    std::optional<Instant> final_time;
+    std::optional<DegreesOfFreedom<Barycentric>> final_degrees_of_freedom;
+    std::optional<Mass> final_mass;
+    // The lowest periapsis with respect to the reference, if any.  This is the
+    // closest approach if the reference is the trajectory of a vessel.
+    std::optional<Instant> periapsis_time;
+    std::optional<Length> periapsis_distance;
+  };
+
+  // Evaluates the flight plans that would result from replacing the manœuvre
+  // at |index| with each of the |burns|, without changing this flight plan.
+  // The manœuvres that follow are kept as in |Replace|.  The evaluations are
+  // independent and executed concurrently by |scheduler|, sharing the
+  // ephemeris.  If |reference| is not null, the periapsides are computed with
+  // respect to it.  The result has one element per burn.
+  std::vector<Evaluation> EvaluateReplacements(
+      int index,
+      std::vector<NavigationManœuvre::Burn> const& burns,
+      Trajectory<Barycentric> const* reference,
+      TaskScheduler& scheduler) const;
+
   // Updates the desired final time of the flight plan.  Returns an error and
   // has no effect |desired_final_time| is before the beginning of the last
   // coast.
   virtual Status SetDesiredFinalTime(Instant const& desired_final_time);
 
-  // Sets the parameters used to compute the trajectories and recomputes them
-  // all.  Returns the integration status.
+  // Sets the parameters used to compute the trajectories and recomputes those
+  // that are affected by the change.  Returns the integration status.
   virtual Status SetAdaptiveStepParameters(
       Ephemeris<Barycentric>::AdaptiveStepParameters const&
           adaptive_step_parameters,
@@ -130,12 +175,16 @@ class FlightPlan {
   void WriteToMessage(not_null<serialization::FlightPlan*> message) const;
 
   // This may return a null pointer if the flight plan contained in the
-  // |message| is anomalous.
+  // |message| is anomalous.  The |coast_scheduler| is not serialized, it is
+  // given to the constructor.
   static std::unique_ptr<FlightPlan> ReadFromMessage(
       serialization::FlightPlan const& message,
-      not_null<Ephemeris<Barycentric>*> ephemeris);
+      not_null<Ephemeris<Barycentric>*> ephemeris,
+      TaskScheduler* coast_scheduler);
 
   static constexpr std::int64_t max_ephemeris_steps_per_frame = 1000;
+  static constexpr Time default_minimum_coast_slice_duration =
+      10 * quantities::si::Day;
 
   static constexpr Error bad_desired_final_time = Error::OUT_OF_RANGE;
   static constexpr Error does_not_fit = Error::OUT_OF_RANGE;
@@ -149,6 +198,14 @@ class FlightPlan {
   // Clears and recomputes all trajectories in |segments_|.
   Status RecomputeAllSegments();
 
+  // Evaluates the replacement of the manœuvre at |index| with |burn| by
+  // building a scratch flight plan that starts with the coast that precedes
+  // that manœuvre.
+  Evaluation EvaluateReplacement(
+      int index,
+      NavigationManœuvre::Burn const& burn,
+      Trajectory<Barycentric> const* reference) const;
+
   // Flows the given |segment| for the duration of |manœuvre| using its
   // intrinsic acceleration.
   Status BurnSegment(NavigationManœuvre const& manœuvre,
@@ -159,6 +216,24 @@ class FlightPlan {
   Status CoastSegment(Instant const& desired_final_time,
                       not_null<DiscreteTrajectory<Barycentric>*> segment);
 
+  // Flows the given |segment| towards |desired_final_time| with no intrinsic
+  // acceleration using the Parareal algorithm: the coast is split in time
+  // slices, whose initial states are predicted sequentially with a coarse
+  // integration and corrected by fine integrations of the slices executed
+  // concurrently on |coast_scheduler_|, until the initial states converge.
+  // The number of slices only depends on the duration of the coast, so that
+  // the result doesn't depend on the number of workers; the slices are not
+  // shorter than |coast_minimum_slice_duration_|.
+  // The slices are appended to |segment| if they converge.  Otherwise, e.g., if
+  // an integration fails or if the iterations are exhausted, only the slices
+  // that were integrated from an exact initial state are appended, and the
+  // caller must integrate the rest of the coast sequentially.  The steps
+  // appended are not more than |max_steps|; their number is returned.
+  std::int64_t ParallelCoastSegment(
+      Instant const& desired_final_time,
+      std::int64_t max_steps,
+      not_null<DiscreteTrajectory<Barycentric>*> segment);
+
   // Computes new trajectories and appends them to |segments_|.  This updates
   // the last coast of |segments_| and then appends one coast and one burn for
   // each manœuvre in |manœuvres|.  If one of the integration returns an error,
@@ -171,13 +246,21 @@ class FlightPlan {
 
   // Adds a trajectory to |segments_|, forked at the end of the last one.  If
   // there are already anomalous trajectories, the newly created trajectory is
-  // anomalous too.
+  // anomalous too.  The level of detail of the trajectory is enabled since it
+  // gets rendered.
   void AddLastSegment();
 
   // Forgets the last trajectory after its fork.  If that trajectory was the
   // only anomalous one, there are no anomalous trajectories after this call.
   void ResetLastSegment();
 
+  // Keeps the last trajectory, which must be a coast, if it is not anomalous
+  // and already ends at |time|; otherwise, this is the same as
+  // |ResetLastSegment|.  The steps of an adaptive integration depend on the
+  // time at which it ends, so a coast that ends elsewhere must be integrated
+  // again from its fork to match a flight plan computed from scratch.
+  void ReuseOrResetLastSegment(Instant const& time);
+
   // Deletes the last trajectory and removes it from |segments_|.  If there are
   // anomalous trajectories, their number is decremented and may become 0.
   void PopLastSegment();
@@ -212,6 +295,8 @@ class FlightPlan {
   Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters_;
   Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters
       generalized_adaptive_step_parameters_;
+  TaskScheduler* const coast_scheduler_ = nullptr;
+  Time const coast_minimum_slice_duration_;
 };
 
 }  // namespace internal_flight_plan
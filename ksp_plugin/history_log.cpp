@@ -0,0 +1,365 @@
+#include "ksp_plugin/history_log.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "glog/logging.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_history_log {
+
+// A new file with the complete histories is started when the number of points
+// written to the current file exceeds this multiple of the number of points in
+// the histories.
+constexpr std::int64_t max_logged_to_live_points_ratio = 4;
+// Don't bother starting a new file if the current one is small.
+constexpr std::int64_t min_logged_points_for_new_file = 100'000;
+
+HistoryLog::HistoryLog(std::filesystem::path directory)
+    : directory_(std::move(directory)) {}
+
+std::unique_ptr<HistoryLog> HistoryLog::ReadFromFile(
+    std::filesystem::path const& path,
+    std::int64_t const generation,
+    Histories& histories) {
+  histories.clear();
+  auto log = std::make_unique<HistoryLog>(path.parent_path());
+  log->path_ = path;
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file.good()) {
+    LOG(ERROR) << "Cannot open history log " << path;
+    return nullptr;
+  }
+  std::string const bytes((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  if (file.bad()) {
+    LOG(ERROR) << "Cannot read history log " << path;
+    return nullptr;
+  }
+
+  // Read all the records, as we don't know which ones are the ancestors of
+  // |generation|.
+  std::map<std::int64_t, serialization::HistoryLogRecord> records;
+  auto const* const data = reinterpret_cast<std::uint8_t const*>(bytes.data());
+  std::int64_t offset = 0;
+  while (offset < bytes.size()) {
+    google::protobuf::io::CodedInputStream size_stream(
+        data + offset,
+        static_cast<int>(std::min<std::int64_t>(
+            bytes.size() - offset, std::numeric_limits<int>::max())));
+    std::uint32_t size;
+    if (!size_stream.ReadVarint32(&size)) {
+      LOG(ERROR) << "Malformed history log " << path << " at " << offset;
+      return nullptr;
+    }
+    offset += size_stream.CurrentPosition();
+    if (offset + size > bytes.size()) {
+      LOG(ERROR) << "Truncated history log " << path << " at " << offset;
+      return nullptr;
+    }
+    serialization::HistoryLogRecord record;
+    if (!record.ParseFromArray(data + offset, size)) {
+      LOG(ERROR) << "Malformed history log " << path << " at " << offset;
+      return nullptr;
+    }
+    offset += size;
+    for (auto const& delta : record.delta()) {
+      log->logged_points_ += delta.appended_point_size();
+    }
+    log->last_generation_ = std::max(log->last_generation_,
+                                     record.generation());
+    records.emplace(record.generation(), std::move(record));
+  }
+
+  // Find the ancestry of |generation| up to a record with complete histories,
+  // and apply it from the oldest record.
+  std::vector<serialization::HistoryLogRecord const*> ancestry;
+  for (std::optional<std::int64_t> g = generation; g.has_value();) {
+    auto const it = records.find(*g);
+    if (it == records.end()) {
+      LOG(ERROR) << "History log " << path << " has no record " << *g;
+      return nullptr;
+    }
+    auto const& record = it->second;
+    ancestry.push_back(&record);
+    g = record.has_parent_generation()
+            ? std::make_optional(record.parent_generation())
+            : std::nullopt;
+  }
+  for (auto it = ancestry.rbegin(); it != ancestry.rend(); ++it) {
+    for (auto const& delta : (*it)->delta()) {
+      ApplyDelta(delta, histories[delta.vessel_guid()]);
+    }
+  }
+
+  // We don't know which points of the histories may still be changed by
+  // downsampling, so the first call to |Write| compares all of them.
+  for (auto const& [guid, history] : histories) {
+    auto& persisted = log->persisted_histories_[guid];
+    persisted.size = history.size();
+    for (auto const& point : history) {
+      persisted.unstable_times.push_back(
+          Instant::ReadFromMessage(point.instant()));
+    }
+    if (!history.empty()) {
+      persisted.first_time = persisted.unstable_times.front();
+      persisted.last_time = persisted.unstable_times.back();
+    }
+    log->live_points_ += history.size();
+  }
+  log->parent_generation_ = generation;
+  return log;
+}
+
+std::optional<std::int64_t> HistoryLog::Write(
+    std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>> const&
+        histories) {
+  bool const new_file =
+      !parent_generation_.has_value() ||
+      (logged_points_ > min_logged_points_for_new_file &&
+       logged_points_ > max_logged_to_live_points_ratio * live_points_);
+  if (new_file) {
+    StartNewFile();
+  }
+
+  serialization::HistoryLogRecord record;
+  std::int64_t const generation = ++last_generation_;
+  record.set_generation(generation);
+  if (parent_generation_.has_value()) {
+    record.set_parent_generation(*parent_generation_);
+  }
+
+  // Forget the vessels that have disappeared.
+  for (auto it = persisted_histories_.begin();
+       it != persisted_histories_.end();) {
+    if (histories.find(it->first) == histories.end()) {
+      it = persisted_histories_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  live_points_ = 0;
+  for (auto const& [guid, history] : histories) {
+    CHECK(history->is_root()) << guid;
+    serialization::HistoryLogRecord::Delta delta;
+    delta.set_vessel_guid(guid);
+    auto& persisted = persisted_histories_[guid];
+    WriteDelta(*history, persisted, delta);
+    // A record with complete histories must list all the vessels, even those
+    // that didn't change.
+    if (new_file ||
+        delta.has_forget_before() ||
+        delta.has_forget_from() ||
+        delta.appended_point_size() > 0) {
+      logged_points_ += delta.appended_point_size();
+      *record.add_delta() = std::move(delta);
+    }
+    live_points_ += persisted.size;
+  }
+
+  if (!AppendRecord(record)) {
+    // We don't know what the readers know, start afresh next time.
+    parent_generation_ = std::nullopt;
+    return std::nullopt;
+  }
+  parent_generation_ = generation;
+  return generation;
+}
+
+bool HistoryLog::IsUpToDate(
+    std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>> const&
+        histories) const {
+  if (!parent_generation_.has_value() ||
+      histories.size() != persisted_histories_.size()) {
+    return false;
+  }
+  for (auto const& [guid, history] : histories) {
+    auto const it = persisted_histories_.find(guid);
+    if (it == persisted_histories_.end()) {
+      return false;
+    }
+    PersistedHistory const& persisted = it->second;
+    if (history->Size() != persisted.size) {
+      return false;
+    }
+    if (!history->Empty() &&
+        (persisted.first_time != history->front().time ||
+         persisted.last_time != history->back().time)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::filesystem::path const& HistoryLog::directory() const {
+  return directory_;
+}
+
+std::filesystem::path const& HistoryLog::path() const {
+  return path_;
+}
+
+std::int64_t HistoryLog::generation() const {
+  CHECK(parent_generation_.has_value()) << path_;
+  return *parent_generation_;
+}
+
+void HistoryLog::WriteDelta(DiscreteTrajectory<Barycentric> const& history,
+                            PersistedHistory& persisted,
+                            serialization::HistoryLogRecord::Delta& delta) {
+  if (history.Empty()) {
+    if (persisted.first_time.has_value()) {
+      persisted.first_time->WriteToMessage(delta.mutable_forget_from());
+    }
+    persisted = PersistedHistory();
+    return;
+  }
+
+  Instant const& first_time = history.front().time;
+  auto& unstable_times = persisted.unstable_times;
+  if (!persisted.first_time.has_value()) {
+    // The reader may know of an older history for this vessel, make sure that
+    // it is cleared.
+    first_time.WriteToMessage(delta.mutable_forget_before());
+    first_time.WriteToMessage(delta.mutable_forget_from());
+  } else if (*persisted.first_time < first_time) {
+    first_time.WriteToMessage(delta.mutable_forget_before());
+    if (persisted.stable_time.has_value() &&
+        *persisted.stable_time < first_time) {
+      // The remaining points are all in |unstable_times|.
+      persisted.stable_time = std::nullopt;
+    }
+    unstable_times.erase(unstable_times.begin(),
+                         std::lower_bound(unstable_times.begin(),
+                                          unstable_times.end(),
+                                          first_time));
+  }
+
+  // Skip the points that the reader already has.  The points up to the stable
+  // time haven't changed, and, since downsampling only removes points after
+  // it, the first mismatch after it is where the history was rewritten.
+  auto it = history.begin();
+  if (persisted.stable_time.has_value()) {
+    auto const stable = history.Find(*persisted.stable_time);
+    if (stable == history.end()) {
+      // The history was truncated at its end; rewrite all of it.
+      LOG(WARNING) << "History changed at " << *persisted.stable_time;
+      first_time.WriteToMessage(delta.mutable_forget_from());
+      unstable_times.clear();
+    } else {
+      it = std::next(stable);
+    }
+  }
+  std::int64_t i = 0;
+  while (i < unstable_times.size() &&
+         it != history.end() &&
+         it->time == unstable_times[i]) {
+    ++it;
+    ++i;
+  }
+  if (i < unstable_times.size()) {
+    unstable_times[i].WriteToMessage(delta.mutable_forget_from());
+  }
+
+  for (; it != history.end(); ++it) {
+    auto* const point = delta.add_appended_point();
+    it->time.WriteToMessage(point->mutable_instant());
+    it->degrees_of_freedom.WriteToMessage(point->mutable_degrees_of_freedom());
+  }
+
+  // The reader now has all the points of |history|.  Only remember the times
+  // of those that downsampling may remove.
+  persisted.size = history.Size();
+  persisted.first_time = first_time;
+  persisted.last_time = history.back().time;
+  persisted.stable_time = history.FirstDenseTime();
+  unstable_times.clear();
+  for (auto unstable = std::next(history.Find(*persisted.stable_time));
+       unstable != history.end();
+       ++unstable) {
+    unstable_times.push_back(unstable->time);
+  }
+}
+
+void HistoryLog::ApplyDelta(
+    serialization::HistoryLogRecord::Delta const& delta,
+    std::vector<Point>& history) {
+  auto const before = [](Instant const& t) {
+    return [t](Point const& point) {
+      return Instant::ReadFromMessage(point.instant()) < t;
+    };
+  };
+  if (delta.has_forget_before()) {
+    Instant const t = Instant::ReadFromMessage(delta.forget_before());
+    history.erase(history.begin(),
+                  std::partition_point(history.begin(),
+                                       history.end(),
+                                       before(t)));
+  }
+  if (delta.has_forget_from()) {
+    Instant const t = Instant::ReadFromMessage(delta.forget_from());
+    history.erase(std::partition_point(history.begin(),
+                                       history.end(),
+                                       before(t)),
+                  history.end());
+  }
+  history.insert(history.end(),
+                 delta.appended_point().begin(),
+                 delta.appended_point().end());
+}
+
+void HistoryLog::StartNewFile() {
+  // If the directory cannot be created, |AppendRecord| reports the error.
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  // The generations are unique within a file, but a file might have been
+  // started by another branch of the tree with the same generation.
+  std::int64_t generation = last_generation_ + 1;
+  for (;;) {
+    path_ = directory_ / ("history." + std::to_string(generation) + ".log");
+    if (!std::filesystem::exists(path_, error)) {
+      break;
+    }
+    ++generation;
+  }
+  last_generation_ = generation - 1;
+  parent_generation_ = std::nullopt;
+  logged_points_ = 0;
+  persisted_histories_.clear();
+}
+
+bool HistoryLog::AppendRecord(serialization::HistoryLogRecord const& record) {
+  std::string bytes;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&bytes);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.WriteVarint32(record.ByteSize());
+    CHECK(record.SerializeToCodedStream(&coded_stream));
+  }
+  std::ofstream file(path_, std::ios::binary | std::ios::app);
+  if (!file.good()) {
+    LOG(ERROR) << "Cannot open history log " << path_;
+    return false;
+  }
+  file.write(bytes.data(), bytes.size());
+  file.close();
+  if (file.fail()) {
+    LOG(ERROR) << "Cannot write history log " << path_;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal_history_log
+}  // namespace ksp_plugin
+}  // namespace principia
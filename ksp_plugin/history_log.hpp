@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/identification.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "serialization/ksp_plugin.pb.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_history_log {
+
+using base::not_null;
+using geometry::Instant;
+using physics::DiscreteTrajectory;
+
+// An append-only log of the histories of the vessels, which makes it possible
+// to save them incrementally.  Histories change only at their ends: points are
+// appended, the beginning is forgotten, and the end may be rewritten, e.g., by
+// downsampling.  Therefore, each call to |Write| appends a record that only
+// contains the changes made to the histories since the previous call, which
+// is proportional to the recent activity, not to the length of the campaign.
+// The records form a tree: each one refers to the generation of its parent, so
+// that a save that is loaded again (e.g., when reverting) may be continued
+// without invalidating the other saves.
+// When the log becomes large compared to the histories, the next record
+// contains the complete histories and starts a new file.  The previous files
+// are left untouched as older saves may still refer to them.
+class HistoryLog final {
+ public:
+  using Point =
+      serialization::DiscreteTrajectory::InstantaneousDegreesOfFreedom;
+  using Histories = std::map<GUID, std::vector<Point>>;
+
+  // Constructs a log whose files are created in |directory|.  The first call to
+  // |Write| writes the complete histories.
+  explicit HistoryLog(std::filesystem::path directory);
+
+  // Reads the log file at |path| and fills |histories| with the histories as
+  // they were when the record with the given |generation| was written.  The
+  // log returned continues from that record.  Returns null, after logging an
+  // error, if the file cannot be read, is malformed, or doesn't contain the
+  // record.
+  static std::unique_ptr<HistoryLog> ReadFromFile(
+      std::filesystem::path const& path,
+      std::int64_t generation,
+      Histories& histories);
+
+  // Appends to the log a record of the changes made to |histories| since the
+  // last call to |Write|, or since the record passed to |ReadFromFile|.  The
+  // histories must be roots, and may only have changed by appending points,
+  // downsampling, and forgetting points at the beginning.  The vessels that
+  // are not in |histories| are forgotten.  Returns the generation of the
+  // record, which is in the file designated by |path|, or nothing, after
+  // logging an error, if the file cannot be written, in which case the next
+  // call starts a new file.  The cost is proportional to the number of points
+  // appended since the last call and to the number of dense points of the
+  // histories, not to their length.
+  std::optional<std::int64_t> Write(
+      std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>> const&
+          histories);
+
+  // Returns true if the last record that was written or read describes
+  // |histories| exactly, i.e., if the histories haven't changed since.  This
+  // is cheap and doesn't look at the points of the histories.
+  bool IsUpToDate(
+      std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>> const&
+          histories) const;
+
+  std::filesystem::path const& directory() const;
+
+  // The file that contains the last record.
+  std::filesystem::path const& path() const;
+
+  // The generation of the last record written or read.  Must only be called if
+  // there is such a record.
+  std::int64_t generation() const;
+
+ private:
+  // What the readers of the last record know of a history.
+  struct PersistedHistory final {
+    // The number of points and the times of the first and last ones.  The
+    // times are absent if the history is empty.
+    std::int64_t size = 0;
+    std::optional<Instant> first_time;
+    std::optional<Instant> last_time;
+    // A time of the history at or before which the points cannot change,
+    // except by being forgotten at the beginning.  If absent, all the points
+    // may have changed.
+    std::optional<Instant> stable_time;
+    // The times of the points after |stable_time|, or of all the points if
+    // there is no |stable_time|.
+    std::vector<Instant> unstable_times;
+  };
+
+  // Appends to |delta| the changes needed to turn |persisted| into |history|,
+  // and updates |persisted|.
+  static void WriteDelta(DiscreteTrajectory<Barycentric> const& history,
+                         PersistedHistory& persisted,
+                         serialization::HistoryLogRecord::Delta& delta);
+
+  // Applies |delta| to |history|.
+  static void ApplyDelta(serialization::HistoryLogRecord::Delta const& delta,
+                         std::vector<Point>& history);
+
+  // Starts a new file for a record that contains the complete histories.
+  void StartNewFile();
+
+  // Returns false if the record could not be written.
+  bool AppendRecord(serialization::HistoryLogRecord const& record);
+
+  std::filesystem::path const directory_;
+
+  // The file to which the records are appended, and the generation of the last
+  // record written to it or read from it.
+  std::filesystem::path path_;
+  std::optional<std::int64_t> parent_generation_;
+  // The greatest generation in the file, used to number the next record.
+  std::int64_t last_generation_ = -1;
+
+  // The number of points written to |path_| and the number of points in the
+  // histories, used to decide when to start a new file.
+  std::int64_t logged_points_ = 0;
+  std::int64_t live_points_ = 0;
+
+  std::map<GUID, PersistedHistory> persisted_histories_;
+};
+
+}  // namespace internal_history_log
+
+using internal_history_log::HistoryLog;
+
+}  // namespace ksp_plugin
+}  // namespace principia
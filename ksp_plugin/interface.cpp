@@ -344,7 +344,8 @@ void __cdecl principia__ActivateRecorder(bool const activate) {
     std::stringstream name;
     name << std::put_time(localtime, "JOURNAL.%Y%m%d-%H%M%S");
     journal::Recorder* const recorder = new journal::Recorder(
-        std::filesystem::path("glog") / "Principia" / name.str());
+        std::filesystem::path("glog") / "Principia" / name.str(),
+        gipfeli_compressor);
     Vessel::MakeSynchronous();
     journal::Recorder::Activate(recorder);
   } else if (!activate && journal::Recorder::IsActivated()) {
@@ -541,6 +542,26 @@ void __cdecl principia__DeserializePlugin(
 
 // Calls |plugin->EndInitialization|.
 // |plugin| must not be null.  No transfer of ownership.
+// Caches the ephemeris in |directory|, which may be shared by several games.
+void __cdecl principia__EnableEphemerisCache(Plugin* const plugin,
+                                             char const* const directory) {
+  journal::Method<journal::EnableEphemerisCache> m({plugin, directory});
+  CHECK_NOTNULL(plugin);
+  plugin->EnableEphemerisCache(std::filesystem::path(directory));
+  return m.Return();
+}
+
+// From now on, the histories of the vessels are saved in a log in
+// |directory|, which must be preserved with the saves.
+void __cdecl principia__EnableIncrementalHistories(
+    Plugin* const plugin,
+    char const* const directory) {
+  journal::Method<journal::EnableIncrementalHistories> m({plugin, directory});
+  CHECK_NOTNULL(plugin);
+  plugin->EnableIncrementalHistories(std::filesystem::path(directory));
+  return m.Return();
+}
+
 void __cdecl principia__EndInitialization(Plugin* const plugin) {
   journal::Method<journal::EndInitialization> m({plugin});
   CHECK_NOTNULL(plugin);
@@ -1186,5 +1207,14 @@ void __cdecl principia__UpdatePrediction(Plugin const* const plugin,
   return m.Return();
 }
 
+// Must be called before |principia__SerializePlugin| when incremental
+// histories are enabled.
+void __cdecl principia__WriteHistoryLog(Plugin* const plugin) {
+  journal::Method<journal::WriteHistoryLog> m({plugin});
+  CHECK_NOTNULL(plugin);
+  plugin->WriteHistoryLog();
+  return m.Return();
+}
+
 }  // namespace interface
 }  // namespace principia
@@ -162,6 +162,22 @@ inline bool operator==(FlightPlanAdaptiveStepParameters const& left,
                           right.speed_integration_tolerance);
 }
 
+inline bool operator==(FlightPlanEvaluation const& left,
+                       FlightPlanEvaluation const& right) {
+  return left.status == right.status &&
+         NaNIndependentEq(left.final_time, right.final_time) &&
+         left.final_degrees_of_freedom == right.final_degrees_of_freedom &&
+         NaNIndependentEq(left.final_mass_in_tonnes,
+                          right.final_mass_in_tonnes) &&
+         left.final_time_has_value == right.final_time_has_value &&
+         NaNIndependentEq(left.closest_approach_time,
+                          right.closest_approach_time) &&
+         NaNIndependentEq(left.closest_approach_distance,
+                          right.closest_approach_distance) &&
+         left.closest_approach_time_has_value ==
+             right.closest_approach_time_has_value;
+}
+
 inline bool operator==(Interval const& left, Interval const& right) {
   return NaNIndependentEq(left.min, right.min) &&
          NaNIndependentEq(left.max, right.max);
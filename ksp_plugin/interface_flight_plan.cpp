@@ -1,6 +1,8 @@
 ﻿
 #include "ksp_plugin/interface.hpp"
 
+#include <vector>
+
 #include "base/not_null.hpp"
 #include "geometry/named_quantities.hpp"
 #include "glog/logging.h"
@@ -43,6 +45,7 @@ using physics::BodySurfaceDynamicFrame;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
 using physics::Frenet;
+using quantities::Length;
 using quantities::Speed;
 using quantities::constants::StandardGravity;
 using quantities::si::Kilo;
@@ -54,6 +57,11 @@ using quantities::si::Tonne;
 
 namespace {
 
+// The points of a flight plan segment that are within this distance of the
+// rendered segment are skipped.  The adapter only uses the rendered segment to
+// locate its start, which is always rendered, so this needn't be small.
+constexpr Length flight_plan_rendering_tolerance = 1 * Kilo(Metre);
+
 NavigationManœuvre::Burn FromInterfaceBurn(Plugin const& plugin,
                                            Burn const& burn) {
   NavigationManœuvre::Intensity intensity;
@@ -201,6 +209,58 @@ void __cdecl principia__FlightPlanDelete(Plugin const* const plugin,
   return m.Return();
 }
 
+// Evaluates the replacement of the manœuvre at |index| by each of the
+// candidate |burns|, without modifying the flight plan.  The iterator yields
+// the evaluations in the order of |burns|.
+Iterator* __cdecl principia__FlightPlanEvaluateReplacements(
+    Plugin const* const plugin,
+    char const* const vessel_guid,
+    CandidateBurns const& burns,
+    int const index) {
+  journal::Method<journal::FlightPlanEvaluateReplacements> m(
+      {plugin, vessel_guid, burns, index});
+  CHECK_NOTNULL(plugin);
+  std::vector<NavigationManœuvre::Burn> candidate_burns;
+  candidate_burns.reserve(burns.burn_size);
+  for (int i = 0; i < burns.burn_size; ++i) {
+    candidate_burns.push_back(FromInterfaceBurn(*plugin, burns.burn[i]));
+  }
+  auto const evaluations = plugin->EvaluateFlightPlanReplacements(
+      vessel_guid, index, candidate_burns);
+
+  Vessel const& vessel = *plugin->GetVessel(vessel_guid);
+  std::vector<FlightPlanEvaluation> interface_evaluations;
+  interface_evaluations.reserve(evaluations.size());
+  for (auto const& evaluation : evaluations) {
+    // Make sure that the absent fields get a deterministic default.
+    FlightPlanEvaluation interface_evaluation{};
+    interface_evaluation.status = ToStatus(evaluation.status);
+    interface_evaluation.final_time_has_value =
+        evaluation.final_time.has_value();
+    if (interface_evaluation.final_time_has_value) {
+      Instant const& final_time = *evaluation.final_time;
+      interface_evaluation.final_time = ToGameTime(*plugin, final_time);
+      interface_evaluation.final_degrees_of_freedom =
+          ToQP(plugin->PlanetariumRotation()(
+              *evaluation.final_degrees_of_freedom -
+              vessel.parent()->current_degrees_of_freedom(final_time)));
+      interface_evaluation.final_mass_in_tonnes =
+          *evaluation.final_mass / Tonne;
+    }
+    interface_evaluation.closest_approach_time_has_value =
+        evaluation.periapsis_time.has_value();
+    if (interface_evaluation.closest_approach_time_has_value) {
+      interface_evaluation.closest_approach_time =
+          ToGameTime(*plugin, *evaluation.periapsis_time);
+      interface_evaluation.closest_approach_distance =
+          *evaluation.periapsis_distance / Metre;
+    }
+    interface_evaluations.push_back(interface_evaluation);
+  }
+  return m.Return(new TypedIterator<std::vector<FlightPlanEvaluation>>(
+      std::move(interface_evaluations)));
+}
+
 bool __cdecl principia__FlightPlanExists(
     Plugin const* const plugin,
     char const* const vessel_guid) {
@@ -451,6 +511,7 @@ Iterator* __cdecl principia__FlightPlanRenderedSegment(
           plugin->CurrentTime(),
           begin,
           end,
+          flight_plan_rendering_tolerance,
           FromXYZ<Position<World>>(sun_world_position),
           plugin->PlanetariumRotation());
   if (index % 2 == 1 && !rendered_trajectory->Empty() &&
@@ -1,6 +1,7 @@
 ﻿
 #include "ksp_plugin/interface.hpp"
 
+#include <utility>
 #include <vector>
 
 #include "geometry/rp2_point.hpp"
@@ -19,7 +20,6 @@ namespace interface {
 using base::check_not_null;
 using geometry::RP2Line;
 using geometry::RP2Lines;
-using geometry::RP2Point;
 using ksp_plugin::Camera;
 using ksp_plugin::TypedIterator;
 using ksp_plugin::VesselSet;
@@ -76,6 +76,19 @@ XYZ __cdecl principia__IteratorGetDiscreteTrajectoryXYZ(
       }));
 }
 
+FlightPlanEvaluation __cdecl principia__IteratorGetFlightPlanEvaluation(
+    Iterator const* const iterator) {
+  journal::Method<journal::IteratorGetFlightPlanEvaluation> m({iterator});
+  CHECK_NOTNULL(iterator);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<std::vector<FlightPlanEvaluation>> const*>(
+          iterator));
+  return m.Return(typed_iterator->Get<FlightPlanEvaluation>(
+      [](FlightPlanEvaluation const& evaluation) -> FlightPlanEvaluation {
+        return evaluation;
+      }));
+}
+
 Iterator* __cdecl principia__IteratorGetRP2LinesIterator(
     Iterator const* const iterator) {
   journal::Method<journal::IteratorGetRP2LinesIterator> m({iterator});
@@ -84,7 +97,14 @@ Iterator* __cdecl principia__IteratorGetRP2LinesIterator(
       dynamic_cast<TypedIterator<RP2Lines<Length, Camera>> const*>(iterator));
   return m.Return(typed_iterator->Get<Iterator*>(
       [](RP2Line<Length, Camera> const& rp2_line) -> Iterator* {
-        return new TypedIterator<RP2Line<Length, Camera>>(rp2_line);
+        // The points are converted once here, so that they may be obtained
+        // either one at a time or in bulk.
+        std::vector<XY> xys;
+        xys.reserve(rp2_line.size());
+        for (auto const& rp2_point : rp2_line) {
+          xys.push_back(ToXY(rp2_point));
+        }
+        return new TypedIterator<std::vector<XY>>(std::move(xys));
       }));
 }
 
@@ -92,13 +112,26 @@ XY __cdecl principia__IteratorGetRP2LineXY(Iterator const* const iterator) {
   journal::Method<journal::IteratorGetRP2LineXY> m({iterator});
   CHECK_NOTNULL(iterator);
   auto const typed_iterator = check_not_null(
-      dynamic_cast<TypedIterator<RP2Line<Length, Camera>> const*>(iterator));
+      dynamic_cast<TypedIterator<std::vector<XY>> const*>(iterator));
   return m.Return(typed_iterator->Get<XY>(
-      [](RP2Point<Length, Camera> const& rp2_point) -> XY {
-        return ToXY(rp2_point);
+      [](XY const& xy) -> XY {
+        return xy;
       }));
 }
 
+// Returns all the points of the line, irrespective of the position of
+// |iterator|, so that the C# code doesn't have to cross the interface for each
+// point.  The buffer has |principia__IteratorSize(iterator)| elements and lives
+// as long as |iterator|.
+XY const* __cdecl principia__IteratorGetRP2LineXYBuffer(
+    Iterator const* const iterator) {
+  journal::Method<journal::IteratorGetRP2LineXYBuffer> m({iterator});
+  CHECK_NOTNULL(iterator);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<std::vector<XY>> const*>(iterator));
+  return m.Return(typed_iterator->container().data());
+}
+
 char const* __cdecl principia__IteratorGetVesselGuid(
     Iterator const* const iterator) {
   journal::Method<journal::IteratorGetVesselGuid> m({iterator});
@@ -42,6 +42,9 @@ class TypedIterator : public Iterator {
   void Reset() override;
   int Size() const override;
 
+  // The entire container, for bulk access.
+  Container const& container() const;
+
  private:
   Container container_;
   typename Container::const_iterator iterator_;
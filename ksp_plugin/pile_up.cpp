@@ -21,6 +21,7 @@ namespace internal_pile_up {
 using base::check_not_null;
 using base::FindOrDie;
 using base::make_not_null_unique;
+using base::TaskPriority;
 using geometry::AngularVelocity;
 using geometry::BarycentreCalculator;
 using geometry::Bivector;
@@ -492,9 +493,9 @@ DegreesOfFreedom<Barycentric> PileUp::RecomputeFromParts(
 }
 
 PileUpFuture::PileUpFuture(not_null<PileUp const*> const pile_up,
-                           std::future<Status> future)
+                           TaskScheduler& scheduler)
     : pile_up(pile_up),
-      future(std::move(future)) {}
+      group(scheduler, TaskPriority::Critical) {}
 
 }  // namespace internal_pile_up
 }  // namespace ksp_plugin
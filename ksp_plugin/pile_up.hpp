@@ -2,13 +2,13 @@
 #pragma once
 
 #include <functional>
-#include <future>
 #include <list>
 #include <map>
 
 #include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
 #include "base/status.hpp"
+#include "base/task_scheduler.hpp"
 #include "geometry/grassmann.hpp"
 #include "integrators/integrators.hpp"
 #include "physics/discrete_trajectory.hpp"
@@ -29,6 +29,8 @@ namespace internal_pile_up {
 
 using base::not_null;
 using base::Status;
+using base::TaskGroup;
+using base::TaskScheduler;
 using geometry::Bivector;
 using geometry::Frame;
 using geometry::Instant;
@@ -195,10 +197,15 @@ class PileUp {
 };
 
 // A convenient data object to track a pile-up and the result of integrating it.
+// The tasks spawned in |group| are expected to set |status|, which may only be
+// read once |group| has been waited upon.
 struct PileUpFuture {
-  PileUpFuture(not_null<PileUp const*> pile_up, std::future<Status> future);
+  PileUpFuture(not_null<PileUp const*> pile_up, TaskScheduler& scheduler);
   not_null<PileUp const*> pile_up;
-  std::future<Status> future;
+  Status status;
+  // Declared last so that the destructor waits for the tasks before destroying
+  // |status|.
+  TaskGroup group;
 };
 
 }  // namespace internal_pile_up
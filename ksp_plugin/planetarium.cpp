@@ -2,7 +2,9 @@
 #include "ksp_plugin/planetarium.hpp"
 
 #include <algorithm>
+#include <iterator>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "geometry/point.hpp"
@@ -13,19 +15,28 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_planetarium {
 
+using base::TaskGroup;
+using base::TaskPriority;
 using geometry::Position;
 using geometry::RP2Line;
 using geometry::Sign;
 using geometry::Velocity;
 using physics::MassiveBody;
+using physics::TrajectoryPyramid;
 using quantities::Pow;
 using quantities::Sin;
 using quantities::Sqrt;
 using quantities::Tan;
 using quantities::Time;
 
+using LevelOfDetailPoint = TrajectoryPyramid<Barycentric>::Point;
+
 namespace {
 constexpr int max_plot_method_2_steps = 10'000;
+// When plotting in parallel, the number of subintervals per worker.  The cost
+// of a subinterval depends on the curvature of the trajectory, so we want more
+// subintervals than workers to balance the load.
+constexpr int plot_method_2_subintervals_per_worker = 4;
 }  // namespace
 
 Planetarium::Parameters::Parameters(double const sphere_radius_multiplier,
@@ -40,11 +51,13 @@ Planetarium::Planetarium(
     Parameters const& parameters,
     Perspective<Navigation, Camera> const& perspective,
     not_null<Ephemeris<Barycentric> const*> const ephemeris,
-    not_null<NavigationFrame const*> const plotting_frame)
+    not_null<NavigationFrame const*> const plotting_frame,
+    TaskScheduler* const scheduler)
     : parameters_(parameters),
       perspective_(perspective),
       ephemeris_(ephemeris),
-      plotting_frame_(plotting_frame) {}
+      plotting_frame_(plotting_frame),
+      scheduler_(scheduler) {}
 
 RP2Lines<Length, Camera> Planetarium::PlotMethod0(
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
@@ -55,45 +68,10 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod0(
       begin.trajectory()->LowerBound(plotting_frame_->t_min());
   auto const plottable_end =
       begin.trajectory()->LowerBound(plotting_frame_->t_max());
-  auto const plottable_spheres = ComputePlottableSpheres(now);
-  auto const plottable_segments = ComputePlottableSegments(plottable_spheres,
-                                                           plottable_begin,
-                                                           plottable_end);
-
-  auto const field_of_view_radius² =
-      perspective_.focal() * perspective_.focal() *
-      parameters_.tan_field_of_view_ * parameters_.tan_field_of_view_;
-  std::optional<Position<Navigation>> previous_position;
-  RP2Lines<Length, Camera> rp2_lines;
-  for (auto const& plottable_segment : plottable_segments) {
-    // Apply the projection to the current plottable segment.
-    auto const rp2_first = perspective_(plottable_segment.first);
-    auto const rp2_second = perspective_(plottable_segment.second);
-
-    // If the segment is entirely outside the field of view, ignore it.
-    Length const x1 = rp2_first.x();
-    Length const y1 = rp2_first.y();
-    Length const x2 = rp2_second.x();
-    Length const y2 = rp2_second.y();
-    if (x1 * x1 + y1 * y1 > field_of_view_radius² &&
-        x2 * x2 + y2 * y2 > field_of_view_radius²) {
-      continue;
-    }
-
-    // Create a new ℝP² line when two segments are not consecutive.  Don't
-    // compare ℝP² points for equality, that's expensive.
-    bool const are_consecutive =
-        previous_position == plottable_segment.first;
-    previous_position = plottable_segment.second;
-
-    if (are_consecutive) {
-      rp2_lines.back().push_back(rp2_second);
-    } else {
-      RP2Line<Length, Camera> const rp2_line = {rp2_first, rp2_second};
-      rp2_lines.push_back(rp2_line);
-    }
-  }
-  return rp2_lines;
+  auto const& plottable_sphere_cones = PlottableSphereCones(now);
+  return PlotSegments(ComputePlottableSegments(plottable_sphere_cones,
+                                               plottable_begin,
+                                               plottable_end));
 }
 
 RP2Lines<Length, Camera> Planetarium::PlotMethod1(
@@ -101,12 +79,61 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod1(
     DiscreteTrajectory<Barycentric>::Iterator const& end,
     Instant const& now,
     bool const reverse) const {
+  if (begin == end) {
+    return {};
+  }
+  auto last = end;
+  --last;
+  auto const& trajectory = *begin.trajectory();
+  auto const first_time = std::max(begin->time, plotting_frame_->t_min());
+  auto const last_time = std::min(last->time, plotting_frame_->t_max());
+
+  // A chord of the trajectory is acceptable if the points that it skips are
+  // within the angular resolution of it as seen from the camera.  The error of
+  // the chord is known in |Barycentric|.  In the plotting frame, the skipped
+  // points are additionally displaced by the motion of the frame during the
+  // chord, which we estimate to first order from the velocities of the
+  // endpoints in the plotting frame at the middle of the chord, so that the
+  // plotting frame is only evaluated once per chord.
+  auto const acceptable = [this](LevelOfDetailPoint const& p,
+                                 LevelOfDetailPoint const& q,
+                                 Length const& error) {
+    Time const half_duration = (q.time - p.time) / 2;
+    RigidMotion<Barycentric, Navigation> const to_plotting_at_mid =
+        plotting_frame_->ToThisFrameAtTime(p.time + half_duration);
+    DegreesOfFreedom<Navigation> const p_in_plotting =
+        to_plotting_at_mid({p.position, Barycentric::unmoving});
+    DegreesOfFreedom<Navigation> const q_in_plotting =
+        to_plotting_at_mid({q.position, Barycentric::unmoving});
+    Length const drift =
+        std::max(p_in_plotting.velocity().Norm(),
+                 q_in_plotting.velocity().Norm()) * half_duration;
+    Length const distance =
+        std::min((p_in_plotting.position() - perspective_.camera()).Norm(),
+                 (q_in_plotting.position() - perspective_.camera()).Norm());
+    return error + drift <= parameters_.tan_angular_resolution_ * distance;
+  };
+  std::vector<Position<Navigation>> positions;
+  trajectory.ForEachLevelOfDetailPoint(
+      first_time,
+      last_time,
+      acceptable,
+      [this, &positions](LevelOfDetailPoint const& point) {
+        positions.push_back(
+            plotting_frame_->ToThisFrameAtTime(point.time)
+                .rigid_transformation()(point.position));
+      });
+  if (reverse) {
+    std::reverse(positions.begin(), positions.end());
+  }
+
   Length const focal_plane_tolerance =
       perspective_.focal() * parameters_.tan_angular_resolution_;
   auto const focal_plane_tolerance² =
       focal_plane_tolerance * focal_plane_tolerance;
 
-  auto const rp2_lines = PlotMethod0(begin, end, now, reverse);
+  auto const rp2_lines = PlotSegments(
+      ComputePlottableSegments(PlottableSphereCones(now), positions));
 
   RP2Lines<Length, Camera> new_rp2_lines;
   for (auto const& rp2_line : rp2_lines) {
@@ -155,8 +182,116 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     Instant const& last_time,
     Instant const& now,
     bool const reverse) const {
+  auto const& plottable_sphere_cones = PlottableSphereCones(now);
+  if (scheduler_ == nullptr ||
+      scheduler_->number_of_workers() == 1 ||
+      last_time <= first_time) {
+    int steps;
+    return PlotMethod2(plottable_sphere_cones,
+                       trajectory,
+                       first_time,
+                       last_time,
+                       reverse,
+                       max_plot_method_2_steps,
+                       steps);
+  }
+
+  // Plot subintervals of equal duration in parallel.  The lines, bounds and
+  // number of steps of each subinterval are stored in plotting order, i.e.,
+  // backwards if |reverse|.  Each subinterval may use the entire budget of
+  // steps, so that the ones that need many steps (e.g., around a periapsis)
+  // don't leave a hole in the plot, and so that the plot of a subinterval
+  // doesn't depend on the scheduling of the others.
+  int const number_of_subintervals =
+      scheduler_->number_of_workers() * plot_method_2_subintervals_per_worker;
+  Time const duration = (last_time - first_time) / number_of_subintervals;
+  std::vector<RP2Lines<Length, Camera>> subinterval_lines(
+      number_of_subintervals);
+  std::vector<std::pair<Instant, Instant>> subinterval_bounds(
+      number_of_subintervals);
+  std::vector<int> subinterval_steps(number_of_subintervals);
+  {
+    TaskGroup group(*scheduler_, TaskPriority::Critical);
+    for (int i = 0; i < number_of_subintervals; ++i) {
+      // The bounds are computed by the same expression on both sides, so that
+      // consecutive subintervals share their bounds exactly.
+      Instant const subinterval_first_time =
+          i == 0 ? first_time : first_time + i * duration;
+      Instant const subinterval_last_time =
+          i == number_of_subintervals - 1 ? last_time
+                                          : first_time + (i + 1) * duration;
+      int const j = reverse ? number_of_subintervals - 1 - i : i;
+      subinterval_bounds[j] = {subinterval_first_time, subinterval_last_time};
+      group.Spawn([this,
+                   &plottable_sphere_cones,
+                   &trajectory,
+                   subinterval_first_time,
+                   subinterval_last_time,
+                   reverse,
+                   &lines = subinterval_lines[j],
+                   &steps = subinterval_steps[j]]() {
+        lines = PlotMethod2(plottable_sphere_cones,
+                            trajectory,
+                            subinterval_first_time,
+                            subinterval_last_time,
+                            reverse,
+                            max_plot_method_2_steps,
+                            steps);
+      });
+    }
+    group.Wait();
+  }
+
+  // Concatenate the lines, joining the ones that continue across the bound of
+  // their subintervals.  The budget of steps is handed out to the subintervals
+  // in plotting order.  The first subinterval that doesn't fit in what remains
+  // is plotted again with the remaining steps, and the plot stops there, so
+  // that it may only be truncated at its end, as in the sequential case, and
+  // the result doesn't depend on the scheduling.
+  RP2Lines<Length, Camera> lines;
+  int remaining_steps = max_plot_method_2_steps;
+  for (int j = 0; j < number_of_subintervals; ++j) {
+    auto& subinterval = subinterval_lines[j];
+    bool const truncated = subinterval_steps[j] > remaining_steps;
+    if (truncated) {
+      auto const& [subinterval_first_time, subinterval_last_time] =
+          subinterval_bounds[j];
+      subinterval = PlotMethod2(plottable_sphere_cones,
+                                trajectory,
+                                subinterval_first_time,
+                                subinterval_last_time,
+                                reverse,
+                                remaining_steps,
+                                subinterval_steps[j]);
+    }
+    remaining_steps -= subinterval_steps[j];
+    auto it = subinterval.begin();
+    if (it != subinterval.end() &&
+        !lines.empty() &&
+        lines.back().back() == it->front()) {
+      lines.back().insert(lines.back().end(),
+                          std::next(it->begin()),
+                          it->end());
+      ++it;
+    }
+    std::move(it, subinterval.end(), std::back_inserter(lines));
+    if (truncated) {
+      break;
+    }
+  }
+  return lines;
+}
+
+RP2Lines<Length, Camera> Planetarium::PlotMethod2(
+    std::vector<SphereCone<Navigation>> const& plottable_sphere_cones,
+    Trajectory<Barycentric> const& trajectory,
+    Instant const& first_time,
+    Instant const& last_time,
+    bool const reverse,
+    int const max_steps,
+    int& steps) const {
+  steps = 0;
   RP2Lines<Length, Camera> lines;
-  auto const plottable_spheres = ComputePlottableSpheres(now);
   double const tan²_angular_resolution =
       Pow<2>(parameters_.tan_angular_resolution_);
   auto const final_time = reverse ? first_time : last_time;
@@ -185,12 +320,16 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
 
   std::optional<Position<Navigation>> last_endpoint;
 
-  int steps_accepted = 0;
-
+  // The first step jumps into the loop, so it is counted here.
+  if (steps == max_steps) {
+    return lines;
+  }
+  ++steps;
   goto estimate_tan²_error;
 
-  while (steps_accepted < max_plot_method_2_steps &&
+  while (steps < max_steps &&
          direction * (previous_time - final_time) < Time{}) {
+    ++steps;
     do {
       // One square root because we have squared errors, another one because the
       // errors are quadratic in time (in other words, two square roots because
@@ -219,7 +358,6 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
           perspective_.Tan²AngularDistance(extrapolated_position, position) /
           16;
     } while (estimated_tan²_error > tan²_angular_resolution);
-    ++steps_accepted;
 
     // TODO(egg): also limit to field of view.
     auto const segment_behind_focal_plane =
@@ -237,7 +375,7 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
 
     auto const visible_segments = perspective_.VisibleSegments(
                                       *segment_behind_focal_plane,
-                                      plottable_spheres);
+                                      plottable_sphere_cones);
     for (auto const& segment : visible_segments) {
       if (last_endpoint != segment.first) {
         lines.emplace_back();
@@ -250,6 +388,18 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
   return lines;
 }
 
+std::vector<SphereCone<Navigation>> const& Planetarium::PlottableSphereCones(
+    Instant const& now) const {
+  absl::MutexLock l(&lock_);
+  auto it = plottable_sphere_cones_.find(now);
+  if (it == plottable_sphere_cones_.end()) {
+    it = plottable_sphere_cones_.emplace(
+        now,
+        perspective_.ComputeSphereCones(ComputePlottableSpheres(now))).first;
+  }
+  return it->second;
+}
+
 std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
     Instant const& now) const {
   RigidMotion<Barycentric, Navigation> const rigid_motion_at_now =
@@ -276,55 +426,80 @@ std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
 }
 
 Segments<Navigation> Planetarium::ComputePlottableSegments(
-    const std::vector<Sphere<Navigation>>& plottable_spheres,
+    std::vector<SphereCone<Navigation>> const& plottable_sphere_cones,
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
     DiscreteTrajectory<Barycentric>::Iterator const& end) const {
-  Segments<Navigation> all_segments;
-  if (begin == end) {
-    return all_segments;
+  // Transform the degrees of freedom to the plotting frame.
+  std::vector<Position<Navigation>> positions;
+  for (auto it = begin; it != end; ++it) {
+    RigidMotion<Barycentric, Navigation> const rigid_motion =
+        plotting_frame_->ToThisFrameAtTime(it->time);
+    positions.push_back(rigid_motion(it->degrees_of_freedom).position());
   }
-  auto it1 = begin;
-  Instant t1 = it1->time;
-  RigidMotion<Barycentric, Navigation> rigid_motion_at_t1 =
-      plotting_frame_->ToThisFrameAtTime(t1);
-  Position<Navigation> p1 =
-      rigid_motion_at_t1(it1->degrees_of_freedom).position();
-
-  auto it2 = it1;
-  while (++it2 != end) {
-    // Processing one segment of the trajectory.
-    Instant const t2 = it2->time;
-
-    // Transform the degrees of freedom to the plotting frame.
-    RigidMotion<Barycentric, Navigation> const rigid_motion_at_t2 =
-        plotting_frame_->ToThisFrameAtTime(t2);
-    Position<Navigation> const p2 =
-        rigid_motion_at_t2(it2->degrees_of_freedom).position();
+  return ComputePlottableSegments(plottable_sphere_cones, positions);
+}
 
+Segments<Navigation> Planetarium::ComputePlottableSegments(
+    std::vector<SphereCone<Navigation>> const& plottable_sphere_cones,
+    std::vector<Position<Navigation>> const& positions) const {
+  Segments<Navigation> all_segments;
+  for (int i = 1; i < positions.size(); ++i) {
     // Find the part of the segment that is behind the focal plane.  We don't
     // care about things that are in front of the focal plane.
-    const Segment<Navigation> segment = {p1, p2};
+    const Segment<Navigation> segment = {positions[i - 1], positions[i]};
     auto const segment_behind_focal_plane =
         perspective_.SegmentBehindFocalPlane(segment);
     if (segment_behind_focal_plane) {
       // Find the part(s) of the segment that are not hidden by spheres.  These
       // are the ones we want to plot.
       auto segments = perspective_.VisibleSegments(*segment_behind_focal_plane,
-                                                   plottable_spheres);
+                                                   plottable_sphere_cones);
       std::move(segments.begin(),
                 segments.end(),
                 std::back_inserter(all_segments));
     }
-
-    it1 = it2;
-    t1 = t2;
-    rigid_motion_at_t1 = rigid_motion_at_t2;
-    p1 = p2;
   }
-
   return all_segments;
 }
 
+RP2Lines<Length, Camera> Planetarium::PlotSegments(
+    Segments<Navigation> const& plottable_segments) const {
+  auto const field_of_view_radius² =
+      perspective_.focal() * perspective_.focal() *
+      parameters_.tan_field_of_view_ * parameters_.tan_field_of_view_;
+  std::optional<Position<Navigation>> previous_position;
+  RP2Lines<Length, Camera> rp2_lines;
+  for (auto const& plottable_segment : plottable_segments) {
+    // Apply the projection to the current plottable segment.
+    auto const rp2_first = perspective_(plottable_segment.first);
+    auto const rp2_second = perspective_(plottable_segment.second);
+
+    // If the segment is entirely outside the field of view, ignore it.
+    Length const x1 = rp2_first.x();
+    Length const y1 = rp2_first.y();
+    Length const x2 = rp2_second.x();
+    Length const y2 = rp2_second.y();
+    if (x1 * x1 + y1 * y1 > field_of_view_radius² &&
+        x2 * x2 + y2 * y2 > field_of_view_radius²) {
+      continue;
+    }
+
+    // Create a new ℝP² line when two segments are not consecutive.  Don't
+    // compare ℝP² points for equality, that's expensive.
+    bool const are_consecutive =
+        previous_position == plottable_segment.first;
+    previous_position = plottable_segment.second;
+
+    if (are_consecutive) {
+      rp2_lines.back().push_back(rp2_second);
+    } else {
+      RP2Line<Length, Camera> const rp2_line = {rp2_first, rp2_second};
+      rp2_lines.push_back(rp2_line);
+    }
+  }
+  return rp2_lines;
+}
+
 }  // namespace internal_planetarium
 }  // namespace ksp_plugin
 }  // namespace principia
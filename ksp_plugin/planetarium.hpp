@@ -1,9 +1,12 @@
 ﻿
 #pragma once
 
+#include <map>
 #include <vector>
 
+#include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
+#include "base/task_scheduler.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/perspective.hpp"
@@ -21,15 +24,18 @@ namespace ksp_plugin {
 namespace internal_planetarium {
 
 using base::not_null;
+using base::TaskScheduler;
 using geometry::Displacement;
 using geometry::Instant;
 using geometry::OrthogonalMap;
 using geometry::Perspective;
+using geometry::Position;
 using geometry::RP2Lines;
 using geometry::RP2Point;
 using geometry::Segment;
 using geometry::Segments;
 using geometry::Sphere;
+using geometry::SphereCone;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
@@ -62,10 +68,13 @@ class Planetarium {
 
   // TODO(phl): All this Navigation is weird.  Should it be named Plotting?
   // In particular Navigation vs. NavigationFrame is a mess.
+  // If |scheduler| is not null and has several workers, |PlotMethod2| plots
+  // the trajectories in parallel.
   Planetarium(Parameters const& parameters,
               Perspective<Navigation, Camera> const& perspective,
               not_null<Ephemeris<Barycentric> const*> ephemeris,
-              not_null<NavigationFrame const*> plotting_frame);
+              not_null<NavigationFrame const*> plotting_frame,
+              TaskScheduler* scheduler = nullptr);
 
   // A no-op method that just returns all the points in the trajectory defined
   // by |begin| and |end|.
@@ -76,7 +85,9 @@ class Planetarium {
       bool reverse) const;
 
   // A method that coalesces segments until they are larger than the angular
-  // resolution.
+  // resolution.  The points are taken from the level of detail of the
+  // trajectory that matches the angular resolution, so the cost doesn't
+  // depend on the number of points of the trajectory.
   RP2Lines<Length, Camera> PlotMethod1(
       DiscreteTrajectory<Barycentric>::Iterator const& begin,
       DiscreteTrajectory<Barycentric>::Iterator const& end,
@@ -92,7 +103,9 @@ class Planetarium {
       Instant const& now,
       bool reverse) const;
 
-  // The same method, operating on the |Trajectory| interface.
+  // The same method, operating on the |Trajectory| interface.  The time
+  // interval is split into subintervals which are plotted in parallel if this
+  // object has a scheduler.
   RP2Lines<Length, Camera> PlotMethod2(
       Trajectory<Barycentric> const& trajectory,
       Instant const& first_time,
@@ -101,22 +114,55 @@ class Planetarium {
       bool reverse) const;
 
  private:
+  // Returns the cones of the result of |ComputePlottableSpheres|, which are
+  // only computed once for all the trajectories plotted at the same time |now|.
+  std::vector<SphereCone<Navigation>> const& PlottableSphereCones(
+      Instant const& now) const EXCLUDES(lock_);
+
   // Computes the coordinates of the spheres that represent the |ephemeris_|
   // bodies.  These coordinates are in the |plotting_frame_| at time |now|.
   std::vector<Sphere<Navigation>> ComputePlottableSpheres(
       Instant const& now) const;
 
+  // The sequential implementation of |PlotMethod2| on the interval
+  // [first_time, last_time], with at most |max_steps| steps.  The number of
+  // steps actually taken is returned in |steps|.
+  RP2Lines<Length, Camera> PlotMethod2(
+      std::vector<SphereCone<Navigation>> const& plottable_sphere_cones,
+      Trajectory<Barycentric> const& trajectory,
+      Instant const& first_time,
+      Instant const& last_time,
+      bool reverse,
+      int max_steps,
+      int& steps) const;
+
   // Computes the segments of the trajectory defined by |begin| and |end| that
-  // are not hidden by the |plottable_spheres|.
+  // are not hidden by the spheres of the |plottable_sphere_cones|.
   Segments<Navigation> ComputePlottableSegments(
-      const std::vector<Sphere<Navigation>>& plottable_spheres,
+      std::vector<SphereCone<Navigation>> const& plottable_sphere_cones,
       DiscreteTrajectory<Barycentric>::Iterator const& begin,
       DiscreteTrajectory<Barycentric>::Iterator const& end) const;
 
+  // Same as above, for the segments joining consecutive |positions|.
+  Segments<Navigation> ComputePlottableSegments(
+      std::vector<SphereCone<Navigation>> const& plottable_sphere_cones,
+      std::vector<Position<Navigation>> const& positions) const;
+
+  // Projects the |plottable_segments| that are in the field of view, joining
+  // the consecutive ones into lines.
+  RP2Lines<Length, Camera> PlotSegments(
+      Segments<Navigation> const& plottable_segments) const;
+
   Parameters const parameters_;
   Perspective<Navigation, Camera> const perspective_;
   not_null<Ephemeris<Barycentric> const*> const ephemeris_;
   not_null<NavigationFrame const*> const plotting_frame_;
+  TaskScheduler* const scheduler_;
+
+  mutable absl::Mutex lock_;
+  // The values are never removed, so references to them remain valid.
+  mutable std::map<Instant, std::vector<SphereCone<Navigation>>>
+      plottable_sphere_cones_ GUARDED_BY(lock_);
 };
 
 }  // namespace internal_planetarium
@@ -50,6 +50,7 @@
 #include "physics/frame_field.hpp"
 #include "physics/massive_body.hpp"
 #include "physics/solar_system.hpp"
+#include "physics/trajectory.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 
@@ -72,6 +73,8 @@ using base::not_null;
 using base::OFStream;
 using base::SerializeAsBytes;
 using base::Status;
+using base::TaskGroup;
+using base::TaskPriority;
 using geometry::AffineMap;
 using geometry::AngularVelocity;
 using geometry::BarycentreCalculator;
@@ -91,8 +94,6 @@ using physics::BodyCentredBodyDirectionDynamicFrame;
 using physics::BodyCentredNonRotatingDynamicFrame;
 using physics::BodySurfaceDynamicFrame;
 using physics::BodySurfaceFrameField;
-using physics::ComputeApsides;
-using physics::ComputeNodes;
 using physics::CoordinateFrameField;
 using physics::DynamicFrame;
 using physics::Frenet;
@@ -100,6 +101,7 @@ using physics::KeplerianElements;
 using physics::MassiveBody;
 using physics::RigidMotion;
 using physics::SolarSystem;
+using physics::Trajectory;
 using quantities::Force;
 using quantities::Infinity;
 using quantities::Length;
@@ -111,13 +113,61 @@ using quantities::si::Minute;
 using quantities::si::Radian;
 using ::operator<<;
 
+namespace {
+
+// The maximum number of trajectories for which the markers are kept, see
+// |Plugin::apsides_|.
+constexpr std::size_t max_incremental_events = 16;
+
+// Returns the entry of |events| for |key|, creating it if needed.
+template<typename Key, typename Events>
+Events& FindOrInsertEvents(Key const& key, std::map<Key, Events>& events) {
+  if (events.size() >= max_incremental_events &&
+      events.find(key) == events.end()) {
+    events.clear();
+  }
+  return events[key];
+}
+
+// Returns a function that maps a point of a trajectory to the sample used to
+// compute its apsides with respect to |reference|, or to nullopt if the point
+// is not in the time span of |reference|.
+auto ApsisSampler(Trajectory<Barycentric> const& reference) {
+  return [&reference, t_min = reference.t_min(), t_max = reference.t_max()](
+             DiscreteTrajectory<Barycentric>::Iterator::reference const point)
+             -> std::optional<ApsisDetector<Barycentric>::Sample> {
+    if (point.time < t_min || point.time > t_max) {
+      return std::nullopt;
+    }
+    return ApsisDetector<Barycentric>::Sample{
+        point.degrees_of_freedom,
+        reference.EvaluateDegreesOfFreedom(point.time)};
+  };
+}
+
+// Returns true if the history read from the log has the same last point as
+// the |timeline| of the history in the message, which only keeps that point.
+bool HasSameLastPoint(
+    google::protobuf::RepeatedPtrField<HistoryLog::Point> const& timeline,
+    std::vector<HistoryLog::Point> const& history) {
+  if (timeline.empty() || history.empty()) {
+    return timeline.empty() && history.empty();
+  }
+  return Instant::ReadFromMessage(timeline.rbegin()->instant()) ==
+         Instant::ReadFromMessage(history.back().instant());
+}
+
+}  // namespace
+
 Plugin::Plugin(std::string const& game_epoch,
                std::string const& solar_system_epoch,
                Angle const& planetarium_rotation)
     : history_parameters_(DefaultHistoryParameters()),
       psychohistory_parameters_(DefaultPsychohistoryParameters()),
-      vessel_thread_pool_(
-          /*pool_size=*/2 * std::thread::hardware_concurrency()),
+      vessel_scheduler_(/*number_of_workers=*/std::max(
+          1u, std::thread::hardware_concurrency())),
+      prediction_service_(/*number_of_workers=*/std::max(
+          1u, std::thread::hardware_concurrency() / 2)),
       planetarium_rotation_(planetarium_rotation),
       game_epoch_(ParseTT(game_epoch)),
       current_time_(ParseTT(solar_system_epoch)) {
@@ -379,7 +429,8 @@ void Plugin::InsertOrKeepVessel(GUID const& vessel_guid,
                                          vessel_name,
                                          parent,
                                          ephemeris_.get(),
-                                         DefaultPredictionParameters()));
+                                         DefaultPredictionParameters(),
+                                         &prediction_service_));
   } else {
     inserted = false;
   }
@@ -709,32 +760,48 @@ void Plugin::AdvanceTime(Instant const& t, Angle const& planetarium_rotation) {
 void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
   CHECK(!initializing_);
 
-  // Start all the integrations in parallel.
-  std::vector<PileUpFuture> pile_up_futures;
-  for (auto* const pile_up : pile_ups_) {
-    pile_up_futures.emplace_back(
-        pile_up,
-        vessel_thread_pool_.Add([this, pile_up]() {
-          // Note that there cannot be contention in the following method as
-          // no two pile-ups are advanced at the same time.
-          return pile_up->DeformAndAdvanceTime(current_time_);
-        }));
+  // The ephemeris was prolonged to |current_time_| by |AdvanceTime|, so the
+  // integrations below only read it and don't contend for its lock.
+
+  // Advance all the pile-ups in parallel.  Note that there cannot be
+  // contention in |DeformAndAdvanceTime| as no two tasks advance the same
+  // pile-up.  Each task writes its own status.
+  std::vector<not_null<PileUp*>> const pile_ups(pile_ups_.begin(),
+                                                pile_ups_.end());
+  std::vector<Status> statuses(pile_ups.size());
+  {
+    TaskGroup group(vessel_scheduler_, TaskPriority::Critical);
+    for (std::int64_t i = 0; i < pile_ups.size(); ++i) {
+      group.Spawn([this, pile_up = pile_ups[i], &status = statuses[i]]() {
+        status = pile_up->DeformAndAdvanceTime(current_time_);
+      });
+    }
+    group.Wait();
   }
 
-  // Wait for the integrations to finish and figure out which vessels collided
-  // with a celestial.
-  for (auto& pile_up_future : pile_up_futures) {
-    WaitForVesselToCatchUp(pile_up_future, collided_vessels);
+  // Figure out which vessels collided with a celestial.  This is done in the
+  // order of |pile_ups_| so that the result doesn't depend on the scheduling.
+  for (std::int64_t i = 0; i < pile_ups.size(); ++i) {
+    InsertCollidedVessels(*pile_ups[i], statuses[i], collided_vessels);
   }
 
-  // Update the vessels.
+  // Update the lagging vessels in parallel.  Each vessel only touches its own
+  // trajectories and parts.
+  std::vector<not_null<Vessel*>> lagging_vessels;
   for (auto const& [_, vessel] : vessels_) {
     if (vessel->psychohistory().back().time < current_time_) {
       if (Contains(collided_vessels, vessel.get())) {
         vessel->DisableDownsampling();
       }
-      vessel->AdvanceTime();
+      lagging_vessels.push_back(vessel.get());
+    }
+  }
+  {
+    TaskGroup group(vessel_scheduler_, TaskPriority::Critical);
+    for (not_null<Vessel*> const vessel : lagging_vessels) {
+      group.Spawn([vessel]() { vessel->AdvanceTime(); });
     }
+    group.Wait();
   }
 }
 
@@ -749,38 +816,27 @@ not_null<std::unique_ptr<PileUpFuture>> Plugin::CatchUpVessel(
     pile_up = part.containing_pile_up();
   });
 
-  return make_not_null_unique<PileUpFuture>(
-      pile_up,
-      vessel_thread_pool_.Add([this, pile_up, &vessel]() {
+  auto pile_up_future =
+      make_not_null_unique<PileUpFuture>(pile_up, vessel_scheduler_);
+  pile_up_future->group.Spawn(
+      [this, pile_up, &vessel, &status = pile_up_future->status]() {
         // Note that there can be contention in the following method if the
         // caller is catching-up two vessels belonging to the same pile-up in
         // parallel.
-        Status const status = pile_up->DeformAndAdvanceTime(current_time_);
+        status = pile_up->DeformAndAdvanceTime(current_time_);
         if (!status.ok()) {
           vessel.DisableDownsampling();
         }
         vessel.AdvanceTime();
-        return status;
-      }));
+      });
+  return pile_up_future;
 }
 
 void Plugin::WaitForVesselToCatchUp(PileUpFuture& pile_up_future,
                                     VesselSet& collided_vessels) {
   PileUp const* const pile_up = pile_up_future.pile_up;
-  auto& future = pile_up_future.future;
-  future.wait();
-  Status const status = future.get();
-  if (!status.ok()) {
-    for (not_null<Part*> const part : pile_up->parts()) {
-      not_null<Vessel*> const vessel =
-          FindOrDie(part_id_to_vessel_, part->part_id());
-      if (bool const inserted = collided_vessels.insert(vessel).second;
-          inserted) {
-        LOG(WARNING) << "Vessel " << vessel->ShortDebugString()
-                     << " collided with a celestial: " << status.ToString();
-      }
-    }
-  }
+  pile_up_future.group.Wait();
+  InsertCollidedVessels(*pile_up, pile_up_future.status, collided_vessels);
 }
 
 void Plugin::ForgetAllHistoriesBefore(Instant const& t) const {
@@ -848,12 +904,15 @@ void Plugin::UpdatePrediction(GUID const& vessel_guid) const {
 
   // If there is a target vessel, ensure that the prediction of |vessel| is not
   // longer than that of the target vessel.  This is necessary to build the
-  // targetting frame.
+  // targetting frame.  The prognostications of these vessels are computed
+  // before those of the others.
   if (renderer_->HasTargetVessel()) {
     Vessel& target_vessel = renderer_->GetTargetVessel();
+    prediction_service_.Prioritize({&vessel, &target_vessel});
     target_vessel.RefreshPrediction();
     vessel.RefreshPrediction(target_vessel.prediction().back().time);
   } else {
+    prediction_service_.Prioritize({&vessel});
     vessel.RefreshPrediction();
   }
 }
@@ -864,11 +923,27 @@ void Plugin::CreateFlightPlan(GUID const& vessel_guid,
   CHECK(!initializing_);
   // TODO(phl): Serialize the burn parameters.  We should also probably
   // distinguish the coast parameters from the prediction parameters.
-  FindOrDie(vessels_, vessel_guid)->CreateFlightPlan(
-      final_time,
-      initial_mass,
-      DefaultPredictionParameters(),
-      DefaultBurnParameters());
+  auto const& vessel = FindOrDie(vessels_, vessel_guid);
+  vessel->CreateFlightPlan(final_time,
+                           initial_mass,
+                           DefaultPredictionParameters(),
+                           DefaultBurnParameters(),
+                           &vessel_scheduler_);
+}
+
+std::vector<FlightPlan::Evaluation> Plugin::EvaluateFlightPlanReplacements(
+    GUID const& vessel_guid,
+    int const index,
+    std::vector<NavigationManœuvre::Burn> const& burns) const {
+  CHECK(!initializing_);
+  auto const& vessel = FindOrDie(vessels_, vessel_guid);
+  CHECK(vessel->has_flight_plan()) << vessel_guid;
+  Trajectory<Barycentric> const* reference = nullptr;
+  if (renderer_->HasTargetVessel()) {
+    reference = &renderer_->GetTargetVessel().prediction();
+  }
+  return vessel->flight_plan().EvaluateReplacements(
+      index, burns, reference, vessel_scheduler_);
 }
 
 void Plugin::ComputeAndRenderApsides(
@@ -879,24 +954,25 @@ void Plugin::ComputeAndRenderApsides(
     int const max_points,
     std::unique_ptr<DiscreteTrajectory<World>>& apoapsides,
     std::unique_ptr<DiscreteTrajectory<World>>& periapsides) const {
-  DiscreteTrajectory<Barycentric> apoapsides_trajectory;
-  DiscreteTrajectory<Barycentric> periapsides_trajectory;
-  ComputeApsides(FindOrDie(celestials_, celestial_index)->trajectory(),
-                 begin,
+  auto const& reference = FindOrDie(celestials_, celestial_index)->trajectory();
+  DiscreteTrajectory<Barycentric> const* const trajectory = begin.trajectory();
+  auto& apsides =
+      FindOrInsertEvents(std::make_pair(trajectory, celestial_index), apsides_);
+  apsides.Update(begin,
                  end,
                  max_points,
-                 apoapsides_trajectory,
-                 periapsides_trajectory);
+                 ApsisDetector<Barycentric>(),
+                 ApsisSampler(reference));
   apoapsides = renderer_->RenderBarycentricTrajectoryInWorld(
                    current_time_,
-                   apoapsides_trajectory.begin(),
-                   apoapsides_trajectory.end(),
+                   apsides.first().begin(),
+                   apsides.first().end(),
                    sun_world_position,
                    PlanetariumRotation());
   periapsides = renderer_->RenderBarycentricTrajectoryInWorld(
                     current_time_,
-                    periapsides_trajectory.begin(),
-                    periapsides_trajectory.end(),
+                    apsides.second().begin(),
+                    apsides.second().end(),
                     sun_world_position,
                     PlanetariumRotation());
 }
@@ -909,19 +985,20 @@ void Plugin::ComputeAndRenderClosestApproaches(
     std::unique_ptr<DiscreteTrajectory<World>>& closest_approaches) const {
   CHECK(renderer_->HasTargetVessel());
 
-  DiscreteTrajectory<Barycentric> apoapsides_trajectory;
-  DiscreteTrajectory<Barycentric> periapsides_trajectory;
-  ComputeApsides(renderer_->GetTargetVessel().prediction(),
-                 begin,
+  // The prediction of the target changes often, but this is detected by
+  // |IncrementalEvents| since it is part of the samples.
+  DiscreteTrajectory<Barycentric> const* const trajectory = begin.trajectory();
+  auto& apsides = FindOrInsertEvents(trajectory, closest_approaches_);
+  apsides.Update(begin,
                  end,
                  max_points,
-                 apoapsides_trajectory,
-                 periapsides_trajectory);
+                 ApsisDetector<Barycentric>(),
+                 ApsisSampler(renderer_->GetTargetVessel().prediction()));
   closest_approaches =
       renderer_->RenderBarycentricTrajectoryInWorld(
           current_time_,
-          periapsides_trajectory.begin(),
-          periapsides_trajectory.end(),
+          apsides.second().begin(),
+          apsides.second().end(),
           sun_world_position,
           PlanetariumRotation());
 }
@@ -933,9 +1010,6 @@ void Plugin::ComputeAndRenderNodes(
     int const max_points,
     std::unique_ptr<DiscreteTrajectory<World>>& ascending,
     std::unique_ptr<DiscreteTrajectory<World>>& descending) const {
-  auto const trajectory_in_plotting =
-      renderer_->RenderBarycentricTrajectoryInPlotting(begin, end);
-
   auto const* const cast_plotting_frame = dynamic_cast<
       BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation> const*>(
       &*renderer_->GetPlottingFrame());
@@ -953,27 +1027,43 @@ void Plugin::ComputeAndRenderNodes(
     return (dof.position() - Navigation::origin).Norm() < threshold;
   };
 
-  DiscreteTrajectory<Navigation> ascending_trajectory;
-  DiscreteTrajectory<Navigation> descending_trajectory;
+  // The nodes are computed in the plotting frame, so the points are
+  // transformed as in |Renderer::RenderBarycentricTrajectoryInPlotting|, but
+  // only when they are processed.  A change of plotting frame changes the
+  // samples and causes the nodes to be recomputed.
+  auto const sample = [this](DiscreteTrajectory<Barycentric>::Iterator::
+                                 reference const point)
+      -> std::optional<DegreesOfFreedom<Navigation>> {
+    if (renderer_->HasTargetVessel()) {
+      auto const& prediction = renderer_->GetTargetVessel().prediction();
+      if (point.time < prediction.t_min() || point.time > prediction.t_max()) {
+        return std::nullopt;
+      }
+    }
+    return renderer_->BarycentricToPlotting(point.time)(
+        point.degrees_of_freedom);
+  };
+
+  DiscreteTrajectory<Barycentric> const* const trajectory = begin.trajectory();
+  auto& nodes = FindOrInsertEvents(trajectory, nodes_);
   // The so-called North is orthogonal to the plane of the trajectory.
-  ComputeNodes(trajectory_in_plotting->begin(),
-               trajectory_in_plotting->end(),
-               Vector<double, Navigation>({0, 0, 1}),
+  nodes.Update(begin,
+               end,
                max_points,
-               ascending_trajectory,
-               descending_trajectory,
-               show_node);
+               NavigationNodeDetector(
+                   Vector<double, Navigation>({0, 0, 1}), show_node),
+               sample);
 
   ascending = renderer_->RenderPlottingTrajectoryInWorld(
                   current_time_,
-                  ascending_trajectory.begin(),
-                  ascending_trajectory.end(),
+                  nodes.first().begin(),
+                  nodes.first().end(),
                   sun_world_position,
                   PlanetariumRotation());
   descending = renderer_->RenderPlottingTrajectoryInWorld(
                    current_time_,
-                   descending_trajectory.begin(),
-                   descending_trajectory.end(),
+                   nodes.second().begin(),
+                   nodes.second().end(),
                    sun_world_position,
                    PlanetariumRotation());
 }
@@ -1002,7 +1092,8 @@ not_null<std::unique_ptr<Planetarium>> Plugin::NewPlanetarium(
   return make_not_null_unique<Planetarium>(parameters,
                                            perspective,
                                            ephemeris_.get(),
-                                           renderer_->GetPlottingFrame());
+                                           renderer_->GetPlottingFrame(),
+                                           &vessel_scheduler_);
 }
 
 not_null<std::unique_ptr<NavigationFrame>>
@@ -1217,6 +1308,37 @@ Renderer const& Plugin::renderer() const {
   return *renderer_;
 }
 
+void Plugin::EnableIncrementalHistories(
+    std::filesystem::path const& directory) {
+  // Keep the log that was read with the plugin, so that the saves continue it.
+  if (history_log_ != nullptr &&
+      history_log_->directory().lexically_normal() ==
+          directory.lexically_normal()) {
+    return;
+  }
+  history_log_ = std::make_unique<HistoryLog>(directory);
+}
+
+void Plugin::WriteHistoryLog() {
+  if (history_log_ == nullptr) {
+    return;
+  }
+  if (!history_log_->Write(VesselHistories()).has_value()) {
+    LOG(ERROR) << "The histories will be saved in full";
+  }
+}
+
+void Plugin::EnableEphemerisCache(std::filesystem::path const& directory) {
+  // Keep the cache that was read with the plugin, it knows how recent the file
+  // is.
+  if (ephemeris_cache_ != nullptr &&
+      ephemeris_cache_->directory().lexically_normal() ==
+          directory.lexically_normal()) {
+    return;
+  }
+  ephemeris_cache_ = std::make_unique<EphemerisCache>(directory);
+}
+
 void Plugin::WriteToMessage(
     not_null<serialization::Plugin*> const message) const {
   LOG(INFO) << __FUNCTION__;
@@ -1253,13 +1375,53 @@ void Plugin::WriteToMessage(
         return serialization_index_to_pile_up.at(pile_up);
       };
 
+  // When the histories are saved incrementally and |WriteHistoryLog| has
+  // written them since they last changed, the vessels only keep the last point
+  // of their histories, to which the forks are attached.  Otherwise the
+  // histories are written in full.
+  bool omit_history_timelines = false;
+  if (history_log_ != nullptr) {
+    if (history_log_->IsUpToDate(VesselHistories())) {
+      omit_history_timelines = true;
+      auto* const history_log_message = message->mutable_history_log();
+      history_log_message->set_path(history_log_->path().string());
+      history_log_message->set_generation(history_log_->generation());
+    } else {
+      LOG(WARNING) << "The history log is not up to date, the histories are "
+                   << "saved in full";
+    }
+  }
+
+  // The ephemeris and the vessels, which are the bulk of the message, are
+  // written in parallel.  Each task writes to its own submessage, which is
+  // allocated on this thread.  Note that the submessages don't move when
+  // |message| grows.
+  TaskGroup group(vessel_scheduler_, TaskPriority::Critical);
+  group.Spawn([this, ephemeris_message = message->mutable_ephemeris()]() {
+    ephemeris_->WriteToMessage(ephemeris_message);
+  });
+  if (ephemeris_cache_ != nullptr) {
+    message->set_ephemeris_cache_directory(
+        ephemeris_cache_->directory().string());
+    group.Spawn([this]() {
+      ephemeris_cache_->Update(*ephemeris_);
+    });
+  }
+
   std::map<not_null<Vessel const*>, GUID const> vessel_to_guid;
   for (auto const& [guid, vessel] : vessels_) {
     vessel_to_guid.emplace(vessel.get(), guid);
     auto* const vessel_message = message->add_vessel();
     vessel_message->set_guid(guid);
-    vessel->WriteToMessage(vessel_message->mutable_vessel(),
-                           serialization_index_for_pile_up);
+    group.Spawn([omit_history_timelines,
+                 vessel = vessel.get(),
+                 serialized_vessel = vessel_message->mutable_vessel(),
+                 &serialization_index_for_pile_up]() {
+      vessel->WriteToMessage(
+          serialized_vessel,
+          serialization_index_for_pile_up,
+          /*only_last_point_of_history=*/omit_history_timelines);
+    });
     Index const parent_index = FindOrDie(celestial_to_index, vessel->parent());
     vessel_message->set_parent_index(parent_index);
     vessel_message->set_loaded(Contains(loaded_vessels_, vessel.get()));
@@ -1271,8 +1433,6 @@ void Plugin::WriteToMessage(
     (*message->mutable_part_id_to_vessel())[part_id] = vessel_to_guid[vessel];
   }
 
-  ephemeris_->WriteToMessage(message->mutable_ephemeris());
-
   history_parameters_.WriteToMessage(message->mutable_history_parameters());
   psychohistory_parameters_.WriteToMessage(
       message->mutable_psychohistory_parameters());
@@ -1287,6 +1447,8 @@ void Plugin::WriteToMessage(
   for (auto* const pile_up : pile_ups_) {
     pile_up->WriteToMessage(message->add_pile_up());
   }
+
+  group.Wait();
 }
 
 not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
@@ -1309,9 +1471,17 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
       Angle::ReadFromMessage(message.planetarium_rotation());
 
   // The ephemeris constructed here is *not* prolonged and needs to be
-  // explicitly prolonged to cover all the instants that we care about.
-  plugin->ephemeris_ =
-      Ephemeris<Barycentric>::ReadFromMessage(message.ephemeris());
+  // explicitly prolonged to cover all the instants that we care about.  If
+  // there is a cache, it may already cover these instants.
+  if (message.has_ephemeris_cache_directory()) {
+    plugin->ephemeris_cache_ =
+        std::make_unique<EphemerisCache>(message.ephemeris_cache_directory());
+    plugin->ephemeris_ =
+        plugin->ephemeris_cache_->ReadEphemeris(message.ephemeris());
+  } else {
+    plugin->ephemeris_ =
+        Ephemeris<Barycentric>::ReadFromMessage(message.ephemeris());
+  }
   plugin->ephemeris_->Prolong(plugin->game_epoch_);
   plugin->ephemeris_->Prolong(plugin->current_time_);
 
@@ -1320,13 +1490,54 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
                              plugin->celestials_,
                              plugin->name_to_index_);
 
+  // If the histories were saved incrementally, their timelines are in the log.
+  // If the log cannot be read, the histories are reduced to their last point,
+  // and the next saves write them in full.
+  HistoryLog::Histories histories;
+  bool history_log_matches_vessels = true;
+  if (message.has_history_log()) {
+    plugin->history_log_ =
+        HistoryLog::ReadFromFile(message.history_log().path(),
+                                 message.history_log().generation(),
+                                 histories);
+  }
+
   for (auto const& vessel_message : message.vessel()) {
     not_null<Celestial const*> const parent =
         FindOrDie(plugin->celestials_, vessel_message.parent_index()).get();
+    serialization::Vessel const* serialized_vessel = &vessel_message.vessel();
+    serialization::Vessel serialized_vessel_with_history;
+    if (message.has_history_log()) {
+      serialized_vessel_with_history = vessel_message.vessel();
+      auto* const serialized_history =
+          serialized_vessel_with_history.mutable_history();
+      auto* const timeline = serialized_history->mutable_timeline();
+      auto const it = histories.find(vessel_message.guid());
+      if (it != histories.end() && HasSameLastPoint(*timeline, it->second)) {
+        auto& history = it->second;
+        timeline->Clear();
+        timeline->Reserve(history.size());
+        for (auto& point : history) {
+          timeline->Add()->Swap(&point);
+        }
+      } else {
+        LOG(ERROR) << "No history in the log for vessel "
+                   << vessel_message.guid() << ", keeping its last point";
+        history_log_matches_vessels = false;
+        if (serialized_history->has_downsampling() && !timeline->empty()) {
+          *serialized_history->mutable_downsampling()
+               ->mutable_start_of_dense_timeline() =
+              timeline->rbegin()->instant();
+        }
+      }
+      serialized_vessel = &serialized_vessel_with_history;
+    }
     not_null<std::unique_ptr<Vessel>> vessel = Vessel::ReadFromMessage(
-        vessel_message.vessel(),
+        *serialized_vessel,
         parent,
         plugin->ephemeris_.get(),
+        &plugin->prediction_service_,
+        &plugin->vessel_scheduler_,
         [&part_id_to_vessel = plugin->part_id_to_vessel_](
             PartId const part_id) {
           CHECK_NE(part_id_to_vessel.erase(part_id), 0) << part_id;
@@ -1343,6 +1554,12 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
     CHECK(inserted);
   }
 
+  // The log doesn't describe the histories that were truncated, don't continue
+  // it.
+  if (!history_log_matches_vessels) {
+    plugin->history_log_ = nullptr;
+  }
+
   for (auto const& pair : message.part_id_to_vessel()) {
     PartId const part_id = pair.first;
     GUID const guid = pair.second;
@@ -1422,8 +1639,10 @@ Plugin::Plugin(
         psychohistory_parameters)
     : history_parameters_(history_parameters),
       psychohistory_parameters_(psychohistory_parameters),
-      vessel_thread_pool_(
-          /*pool_size=*/2 * std::thread::hardware_concurrency()) {}
+      vessel_scheduler_(/*number_of_workers=*/std::max(
+          1u, std::thread::hardware_concurrency())),
+      prediction_service_(/*number_of_workers=*/std::max(
+          1u, std::thread::hardware_concurrency() / 2)) {}
 
 void Plugin::InitializeIndices(std::string const& name,
                                Index const celestial_index,
@@ -1460,6 +1679,23 @@ void Plugin::UpdatePlanetariumRotation() {
       to_planetarium;
 }
 
+void Plugin::InsertCollidedVessels(PileUp const& pile_up,
+                                   Status const& status,
+                                   VesselSet& collided_vessels) const {
+  if (status.ok()) {
+    return;
+  }
+  for (not_null<Part*> const part : pile_up.parts()) {
+    not_null<Vessel*> const vessel =
+        FindOrDie(part_id_to_vessel_, part->part_id());
+    if (bool const inserted = collided_vessels.insert(vessel).second;
+        inserted) {
+      LOG(WARNING) << "Vessel " << vessel->ShortDebugString()
+                   << " collided with a celestial: " << status.ToString();
+    }
+  }
+}
+
 Velocity<World> Plugin::VesselVelocity(
     Instant const& time,
     DegreesOfFreedom<Barycentric> const& degrees_of_freedom) const {
@@ -1527,6 +1763,15 @@ bool Plugin::is_loaded(not_null<Vessel*> vessel) const {
   return Contains(loaded_vessels_, vessel);
 }
 
+std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>>
+Plugin::VesselHistories() const {
+  std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>> histories;
+  for (auto const& [guid, vessel] : vessels_) {
+    histories.emplace(guid, vessel->psychohistory().root());
+  }
+  return histories;
+}
+
 }  // namespace internal_plugin
 }  // namespace ksp_plugin
 }  // namespace principia
@@ -1,6 +1,8 @@
 ﻿
 #pragma once
 
+#include <filesystem>
+#include <functional>
 #include <future>
 #include <limits>
 #include <list>
@@ -14,18 +16,22 @@
 
 #include "base/monostable.hpp"
 #include "base/status.hpp"
-#include "base/thread_pool.hpp"
+#include "base/task_scheduler.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/perspective.hpp"
 #include "geometry/point.hpp"
 #include "ksp_plugin/celestial.hpp"
+#include "ksp_plugin/ephemeris_cache.hpp"
 #include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/history_log.hpp"
 #include "ksp_plugin/manœuvre.hpp"
 #include "ksp_plugin/planetarium.hpp"
+#include "ksp_plugin/prediction_service.hpp"
 #include "ksp_plugin/renderer.hpp"
 #include "ksp_plugin/vessel.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
+#include "physics/apsides.hpp"
 #include "physics/body.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
@@ -50,7 +56,7 @@ namespace internal_plugin {
 using base::not_null;
 using base::Status;
 using base::Subset;
-using base::ThreadPool;
+using base::TaskScheduler;
 using geometry::AffineMap;
 using geometry::AngularVelocity;
 using geometry::Displacement;
@@ -64,6 +70,7 @@ using geometry::Vector;
 using geometry::Velocity;
 using integrators::FixedStepSizeIntegrator;
 using integrators::AdaptiveStepSizeIntegrator;
+using physics::ApsisDetector;
 using physics::Body;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
@@ -72,8 +79,10 @@ using physics::Ephemeris;
 using physics::FrameField;
 using physics::Frenet;
 using physics::HierarchicalSystem;
+using physics::IncrementalEvents;
 using physics::InertiaTensor;
 using physics::MassiveBody;
+using physics::NodeDetector;
 using physics::RelativeDegreesOfFreedom;
 using physics::RigidMotion;
 using physics::RotatingBody;
@@ -328,6 +337,15 @@ class Plugin {
                                 Instant const& final_time,
                                 Mass const& initial_mass) const;
 
+  // Evaluates concurrently the replacements of the manœuvre at |index| in the
+  // flight plan of the vessel with guid |vessel_guid| by each of the |burns|,
+  // see |FlightPlan::EvaluateReplacements|.  The closest approaches are
+  // computed with respect to the prediction of the target vessel, if any.
+  virtual std::vector<FlightPlan::Evaluation> EvaluateFlightPlanReplacements(
+      GUID const& vessel_guid,
+      int index,
+      std::vector<NavigationManœuvre::Burn> const& burns) const;
+
   // Computes the apsides of the trajectory defined by |begin| and |end| with
   // respect to the celestial with index |celestial_index|.
   virtual void ComputeAndRenderApsides(
@@ -421,6 +439,25 @@ class Plugin {
   virtual Renderer& renderer();
   virtual Renderer const& renderer() const;
 
+  // From now on, the histories of the vessels are saved incrementally, in a
+  // log in |directory|, instead of in the message.  This makes saves
+  // proportional to the recent activity.  The log must be preserved for the
+  // message to be read completely.  Does nothing if the plugin already uses a
+  // log in |directory|, e.g., the one from which it was read.
+  virtual void EnableIncrementalHistories(
+      std::filesystem::path const& directory);
+
+  // Appends the changes made to the histories to the log, if incremental
+  // histories are enabled.  Must be called before |WriteToMessage|, which only
+  // omits the histories if they haven't changed since the last call.
+  virtual void WriteHistoryLog();
+
+  // Caches the ephemeris in |directory|, so that loading a save doesn't
+  // reintegrate the solar system from the oldest checkpoint of the ephemeris.
+  // The cache is shared by all the games with the same celestials.  Does
+  // nothing if the plugin already uses a cache in |directory|.
+  virtual void EnableEphemerisCache(std::filesystem::path const& directory);
+
   // Must be called after initialization.
   virtual void WriteToMessage(not_null<serialization::Plugin*> message) const;
   static not_null<std::unique_ptr<Plugin>> ReadFromMessage(
@@ -447,6 +484,12 @@ class Plugin {
   // whenever |main_body_| or |planetarium_rotation_| changes.
   void UpdatePlanetariumRotation();
 
+  // If |status| is an error, inserts the vessels of |pile_up| into
+  // |collided_vessels|, as they collided with a celestial.
+  void InsertCollidedVessels(PileUp const& pile_up,
+                             Status const& status,
+                             VesselSet& collided_vessels) const;
+
   Velocity<World> VesselVelocity(
       Instant const& time,
       DegreesOfFreedom<Barycentric> const& degrees_of_freedom) const;
@@ -471,6 +514,10 @@ class Plugin {
   // Whether |loaded_vessels_| contains |vessel|.
   bool is_loaded(not_null<Vessel*> vessel) const;
 
+  // The histories of the vessels, i.e., the roots of their psychohistories.
+  std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>>
+  VesselHistories() const;
+
   // Initialization objects.
   base::Monostable initializing_;
   serialization::GravityModel gravity_model_;
@@ -500,8 +547,18 @@ class Plugin {
   Ephemeris<Barycentric>::FixedStepParameters history_parameters_;
   Ephemeris<Barycentric>::AdaptiveStepParameters psychohistory_parameters_;
 
-  // The thread pool for advancing vessels.
-  ThreadPool<Status> vessel_thread_pool_;
+  // The scheduler for advancing vessels and plotting their trajectories.  It
+  // is thread-safe, and the planetaria use it from const member functions.
+  mutable TaskScheduler vessel_scheduler_;
+
+  // The service that computes the prognostications of the vessels.  It is
+  // thread-safe, and |UpdatePrediction| uses it to prioritize vessels.
+  mutable PredictionService prediction_service_;
+
+  // Null unless the histories are saved incrementally.
+  std::unique_ptr<HistoryLog> history_log_;
+  // Null unless the ephemeris is cached.
+  std::unique_ptr<EphemerisCache> ephemeris_cache_;
 
   Angle planetarium_rotation_;
   std::optional<Rotation<Barycentric, AliceSun>> cached_planetarium_rotation_;
@@ -515,6 +572,31 @@ class Plugin {
   // Not null after initialization.
   std::unique_ptr<Renderer> renderer_;
 
+  using ApsisEvents =
+      IncrementalEvents<Barycentric, ApsisDetector<Barycentric>>;
+  using NavigationNodeDetector =
+      NodeDetector<Navigation,
+                   std::function<bool(DegreesOfFreedom<Navigation> const&)>>;
+  using NodeEvents = IncrementalEvents<Navigation, NavigationNodeDetector>;
+
+  // The markers computed by |ComputeAndRender...|, updated incrementally from
+  // one frame to the next.  They are keyed by the (most forked) trajectory
+  // being rendered, and for the apsides by the celestial.  The address of a
+  // destroyed trajectory may be reused, but this is harmless since
+  // |IncrementalEvents| checks that the points that it has processed are
+  // unchanged.  The maps are cleared when they become large, to forget the
+  // trajectories that no longer exist.
+  // Only the trajectories whose points survive from one frame to the next
+  // benefit from this, in practice the segments of a flight plan that is not
+  // being edited.  A prediction is recomputed from the end of the
+  // psychohistory each time it is refreshed, so its markers are recomputed
+  // from scratch after each refresh.
+  mutable std::map<std::pair<DiscreteTrajectory<Barycentric> const*, Index>,
+                   ApsisEvents> apsides_;
+  mutable std::map<DiscreteTrajectory<Barycentric> const*, ApsisEvents>
+      closest_approaches_;
+  mutable std::map<DiscreteTrajectory<Barycentric> const*, NodeEvents> nodes_;
+
   RotatingBody<Barycentric> const* main_body_ = nullptr;
   AngularVelocity<Barycentric> angular_velocity_of_world_;
 
@@ -0,0 +1,143 @@
+#include "ksp_plugin/prediction_service.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_prediction_service {
+
+PredictionService::PredictionService(std::int64_t const number_of_workers) {
+  CHECK_LT(0, number_of_workers);
+  for (std::int64_t i = 0; i < number_of_workers; ++i) {
+    workers_.emplace_back(&PredictionService::Work, this);
+  }
+}
+
+PredictionService::~PredictionService() {
+  {
+    absl::MutexLock l(&lock_);
+    LOG_IF(WARNING, !requests_.empty())
+        << "Discarding " << requests_.size() << " prediction requests";
+    requests_.clear();
+    queue_.clear();
+    shutdown_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  Statistics const statistics = this->statistics();
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  LOG(INFO) << "Prediction service started " << statistics.computations
+            << " computations, coalesced " << statistics.coalesced_requests
+            << " requests, mean latency "
+            << duration_cast<microseconds>(statistics.mean_latency).count()
+            << " μs, max latency "
+            << duration_cast<microseconds>(statistics.max_latency).count()
+            << " μs";
+}
+
+void PredictionService::Request(Client const client,
+                                Computation computation) {
+  absl::MutexLock l(&lock_);
+  auto const [it, inserted] = requests_.try_emplace(client);
+  auto& request = it->second;
+  request.computation = std::move(computation);
+  if (inserted) {
+    request.time = Clock::now();
+    request.sequence_number = next_sequence_number_++;
+    queue_.emplace(request.sequence_number, client);
+  } else {
+    ++coalesced_requests_;
+  }
+}
+
+void PredictionService::Cancel(Client const client) {
+  absl::MutexLock l(&lock_);
+  if (auto const it = requests_.find(client); it != requests_.end()) {
+    queue_.erase(it->second.sequence_number);
+    requests_.erase(it);
+  }
+  auto const client_is_idle = [this, client]() { return is_idle(client); };
+  lock_.Await(absl::Condition(&client_is_idle));
+}
+
+void PredictionService::Prioritize(std::set<Client> clients) {
+  absl::MutexLock l(&lock_);
+  prioritized_clients_ = std::move(clients);
+}
+
+PredictionService::Statistics PredictionService::statistics() const {
+  absl::ReaderMutexLock l(&lock_);
+  Statistics statistics;
+  statistics.computations = computations_;
+  statistics.coalesced_requests = coalesced_requests_;
+  if (computations_ > 0) {
+    statistics.mean_latency = total_latency_ / computations_;
+  }
+  statistics.max_latency = max_latency_;
+  return statistics;
+}
+
+PredictionService::Client PredictionService::NextClient() const {
+  for (Client const client : prioritized_clients_) {
+    if (requests_.count(client) > 0 && is_idle(client)) {
+      return client;
+    }
+  }
+  for (auto const& [_, client] : queue_) {
+    if (is_idle(client)) {
+      return client;
+    }
+  }
+  return nullptr;
+}
+
+bool PredictionService::has_runnable_request_or_shutdown() const {
+  return shutdown_ || NextClient() != nullptr;
+}
+
+bool PredictionService::is_idle(Client const client) const {
+  return running_clients_.count(client) == 0;
+}
+
+void PredictionService::Work() {
+  for (;;) {
+    Client client;
+    Computation computation;
+    {
+      absl::MutexLock l(&lock_);
+      lock_.Await(absl::Condition(
+          this, &PredictionService::has_runnable_request_or_shutdown));
+      if (shutdown_) {
+        return;
+      }
+      client = NextClient();
+      auto const it = requests_.find(client);
+      auto& request = it->second;
+      Clock::duration const latency = Clock::now() - request.time;
+      total_latency_ += latency;
+      max_latency_ = std::max(max_latency_, latency);
+      ++computations_;
+      computation = std::move(request.computation);
+      queue_.erase(request.sequence_number);
+      requests_.erase(it);
+      running_clients_.insert(client);
+    }
+
+    computation();
+    // Destroy the captures before declaring the client idle, since they may
+    // refer to it.
+    computation = nullptr;
+
+    absl::MutexLock l(&lock_);
+    running_clients_.erase(client);
+  }
+}
+
+}  // namespace internal_prediction_service
+}  // namespace ksp_plugin
+}  // namespace principia
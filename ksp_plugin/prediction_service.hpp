@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_prediction_service {
+
+// A service that computes the predictions of the vessels on a bounded pool of
+// workers, instead of one thread per vessel.  Each client (typically a vessel)
+// has at most one pending request: a request made while another one is pending
+// replaces it but keeps its place in the queue, so duplicate requests are
+// coalesced.  The prioritized clients (typically the active vessel and the
+// target) are served first, the others in the order of their requests.  Since
+// a client that has been served goes to the back of the queue when it makes its
+// next request, this is a round-robin.  The computations of a given client
+// never run concurrently.  This class is thread-safe.
+class PredictionService final {
+ public:
+  using Client = void const*;
+  using Computation = std::function<void()>;
+  using Clock = std::chrono::steady_clock;
+
+  struct Statistics final {
+    // The number of computations that have started.
+    std::int64_t computations = 0;
+    // The number of requests that replaced a pending one.
+    std::int64_t coalesced_requests = 0;
+    // The time between the first pending request of a client and the start of
+    // its computation.
+    Clock::duration mean_latency{};
+    Clock::duration max_latency{};
+  };
+
+  // Constructs a service with the given number of workers, which must be
+  // positive.
+  explicit PredictionService(std::int64_t number_of_workers);
+
+  // Discards the pending requests, waits for the computations in progress and
+  // joins the workers.  Logs the statistics.
+  ~PredictionService();
+
+  PredictionService(PredictionService const&) = delete;
+  PredictionService(PredictionService&&) = delete;
+  PredictionService& operator=(PredictionService const&) = delete;
+  PredictionService& operator=(PredictionService&&) = delete;
+
+  // Requests that |computation| be run for |client|, replacing the pending
+  // request of |client|, if any.
+  void Request(Client client, Computation computation) EXCLUDES(lock_);
+
+  // Discards the pending request of |client|, if any, and waits for its
+  // computation in progress, if any.  Must not be called from a computation.
+  void Cancel(Client client) EXCLUDES(lock_);
+
+  // Sets the clients that are served before all the others, replacing the
+  // previous ones.
+  void Prioritize(std::set<Client> clients) EXCLUDES(lock_);
+
+  Statistics statistics() const EXCLUDES(lock_);
+
+ private:
+  struct PendingRequest final {
+    Computation computation;
+    // The time of the first request that was coalesced in this one.
+    Clock::time_point time;
+    // The position of this request in |queue_|.
+    std::int64_t sequence_number;
+  };
+
+  // Returns the client whose request should be served next, or null if there is
+  // none.
+  Client NextClient() const REQUIRES_SHARED(lock_);
+
+  bool has_runnable_request_or_shutdown() const REQUIRES_SHARED(lock_);
+  bool is_idle(Client client) const REQUIRES_SHARED(lock_);
+
+  // The loop executed by each worker.
+  void Work();
+
+  mutable absl::Mutex lock_;
+  std::map<Client, PendingRequest> requests_ GUARDED_BY(lock_);
+  // The clients having a pending request, in the order of their requests.
+  std::map<std::int64_t, Client> queue_ GUARDED_BY(lock_);
+  std::int64_t next_sequence_number_ GUARDED_BY(lock_) = 0;
+  std::set<Client> prioritized_clients_ GUARDED_BY(lock_);
+  // The clients whose computation is in progress.
+  std::set<Client> running_clients_ GUARDED_BY(lock_);
+  bool shutdown_ GUARDED_BY(lock_) = false;
+
+  std::int64_t computations_ GUARDED_BY(lock_) = 0;
+  std::int64_t coalesced_requests_ GUARDED_BY(lock_) = 0;
+  Clock::duration total_latency_ GUARDED_BY(lock_){};
+  Clock::duration max_latency_ GUARDED_BY(lock_){};
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace internal_prediction_service
+
+using internal_prediction_service::PredictionService;
+
+}  // namespace ksp_plugin
+}  // namespace principia
@@ -23,6 +23,10 @@ using geometry::Vector;
 using geometry::Velocity;
 using physics::BodyCentredBodyDirectionDynamicFrame;
 using physics::DegreesOfFreedom;
+using physics::TrajectoryPyramid;
+using quantities::Time;
+
+using LevelOfDetailPoint = TrajectoryPyramid<Barycentric>::Point;
 
 Renderer::Renderer(not_null<Celestial const*> const sun,
                    not_null<std::unique_ptr<NavigationFrame>> plotting_frame)
@@ -92,6 +96,25 @@ Renderer::RenderBarycentricTrajectoryInWorld(
   return trajectory_in_world;
 }
 
+not_null<std::unique_ptr<DiscreteTrajectory<World>>>
+Renderer::RenderBarycentricTrajectoryInWorld(
+    Instant const& time,
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Length const& tolerance,
+    Position<World> const& sun_world_position,
+    Rotation<Barycentric, AliceSun> const& planetarium_rotation) const {
+  auto const trajectory_in_plotting_frame =
+      RenderBarycentricTrajectoryInPlotting(begin, end, tolerance);
+  auto trajectory_in_world =
+      RenderPlottingTrajectoryInWorld(time,
+                                      trajectory_in_plotting_frame->begin(),
+                                      trajectory_in_plotting_frame->end(),
+                                      sun_world_position,
+                                      planetarium_rotation);
+  return trajectory_in_world;
+}
+
 not_null<std::unique_ptr<DiscreteTrajectory<Navigation>>>
 Renderer::RenderBarycentricTrajectoryInPlotting(
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
@@ -112,6 +135,60 @@ Renderer::RenderBarycentricTrajectoryInPlotting(
   return trajectory;
 }
 
+not_null<std::unique_ptr<DiscreteTrajectory<Navigation>>>
+Renderer::RenderBarycentricTrajectoryInPlotting(
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Length const& tolerance) const {
+  auto trajectory = make_not_null_unique<DiscreteTrajectory<Navigation>>();
+  if (begin == end) {
+    return trajectory;
+  }
+  auto last = end;
+  --last;
+  Instant first_time = begin->time;
+  Instant last_time = last->time;
+  if (target_) {
+    auto const& prediction = target_->vessel->prediction();
+    first_time = std::max(first_time, prediction.t_min());
+    last_time = std::min(last_time, prediction.t_max());
+  }
+  if (first_time > last_time) {
+    return trajectory;
+  }
+
+  // The error of a chord is known in |Barycentric|.  In the plotting frame,
+  // the skipped points are additionally displaced by the motion of the frame
+  // during the chord, which we estimate to first order at the middle of the
+  // chord.
+  auto const acceptable = [this, &tolerance](LevelOfDetailPoint const& p,
+                                             LevelOfDetailPoint const& q,
+                                             Length const& error) {
+    Time const half_duration = (q.time - p.time) / 2;
+    RigidMotion<Barycentric, Navigation> const to_plotting_at_mid =
+        BarycentricToPlotting(p.time + half_duration);
+    Length const drift =
+        std::max(to_plotting_at_mid({p.position, Barycentric::unmoving})
+                     .velocity().Norm(),
+                 to_plotting_at_mid({q.position, Barycentric::unmoving})
+                     .velocity().Norm()) * half_duration;
+    return error + drift <= tolerance;
+  };
+  auto const& trajectory_to_render = *begin.trajectory();
+  trajectory_to_render.ForEachLevelOfDetailPoint(
+      first_time,
+      last_time,
+      acceptable,
+      [this, &trajectory, &trajectory_to_render](
+          LevelOfDetailPoint const& point) {
+        trajectory->Append(
+            point.time,
+            BarycentricToPlotting(point.time)(
+                trajectory_to_render.Find(point.time)->degrees_of_freedom));
+      });
+  return trajectory;
+}
+
 not_null<std::unique_ptr<DiscreteTrajectory<World>>>
 Renderer::RenderPlottingTrajectoryInWorld(
     Instant const& time,
@@ -80,6 +80,19 @@ class Renderer {
       Position<World> const& sun_world_position,
       Rotation<Barycentric, AliceSun> const& planetarium_rotation) const;
 
+  // Same as above, but the points of the trajectories whose level of detail is
+  // enabled are skipped if they are within |tolerance| of the rendered
+  // trajectory in the plotting frame.  The cost is logarithmic in the number
+  // of points of these trajectories for each rendered point.
+  virtual not_null<std::unique_ptr<DiscreteTrajectory<World>>>
+  RenderBarycentricTrajectoryInWorld(
+      Instant const& time,
+      DiscreteTrajectory<Barycentric>::Iterator const& begin,
+      DiscreteTrajectory<Barycentric>::Iterator const& end,
+      Length const& tolerance,
+      Position<World> const& sun_world_position,
+      Rotation<Barycentric, AliceSun> const& planetarium_rotation) const;
+
   // Returns a trajectory in the current plotting frame corresponding to the
   // trajectory defined by |begin| and |end|.  If there is a target vessel, its
   // prediction must not be empty.
@@ -88,6 +101,14 @@ class Renderer {
       DiscreteTrajectory<Barycentric>::Iterator const& begin,
       DiscreteTrajectory<Barycentric>::Iterator const& end) const;
 
+  // Same as above, with a level of detail as described for
+  // |RenderBarycentricTrajectoryInWorld|.
+  virtual not_null<std::unique_ptr<DiscreteTrajectory<Navigation>>>
+  RenderBarycentricTrajectoryInPlotting(
+      DiscreteTrajectory<Barycentric>::Iterator const& begin,
+      DiscreteTrajectory<Barycentric>::Iterator const& end,
+      Length const& tolerance) const;
+
   // Returns a trajectory in |World| corresponding to the trajectory defined by
   // |begin| and |end| in the current plotting frame.
   virtual not_null<std::unique_ptr<DiscreteTrajectory<World>>>
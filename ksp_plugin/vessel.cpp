@@ -44,8 +44,7 @@ bool operator!=(Vessel::PrognosticatorParameters const& left,
          left.adaptive_step_parameters.length_integration_tolerance() !=
              right.adaptive_step_parameters.length_integration_tolerance() ||
          left.adaptive_step_parameters.speed_integration_tolerance() !=
-             right.adaptive_step_parameters.speed_integration_tolerance() ||
-         left.shutdown != right.shutdown;
+             right.adaptive_step_parameters.speed_integration_tolerance();
 }
 
 Vessel::Vessel(GUID const& guid,
@@ -53,13 +52,15 @@ Vessel::Vessel(GUID const& guid,
                not_null<Celestial const*> const parent,
                not_null<Ephemeris<Barycentric>*> const ephemeris,
                Ephemeris<Barycentric>::AdaptiveStepParameters const&
-                   prediction_adaptive_step_parameters)
+                   prediction_adaptive_step_parameters,
+               not_null<PredictionService*> const prediction_service)
     : guid_(guid),
       name_(name),
       body_(),
       prediction_adaptive_step_parameters_(prediction_adaptive_step_parameters),
       parent_(parent),
       ephemeris_(ephemeris),
+      prediction_service_(prediction_service),
       history_(make_not_null_unique<DiscreteTrajectory<Barycentric>>()) {
   // Can't create the |psychohistory_| and |prediction_| here because |history_|
   // is empty;
@@ -67,19 +68,11 @@ Vessel::Vessel(GUID const& guid,
 
 Vessel::~Vessel() {
   LOG(INFO) << "Destroying vessel " << ShortDebugString();
-  // Ask the prognosticator to shut down.  This may take a while.  Make sure
-  // that we handle the case where |PrepareHistory| was not called.
-  if (prognosticator_.joinable()) {
-    {
-      absl::MutexLock l(&prognosticator_lock_);
-      prognosticator_parameters_ =
-          PrognosticatorParameters{Ephemeris<Barycentric>::Guard(ephemeris_),
-                                   psychohistory_->back().time,
-                                   psychohistory_->back().degrees_of_freedom,
-                                   prediction_adaptive_step_parameters_,
-                                   /*shutdown=*/true};
-    }
-    prognosticator_.join();
+  // Drop our pending prognostication, if any, and wait for the one in
+  // progress, if any.  This may take a while.  Make sure that we handle the
+  // case where |RefreshPrediction| was not called.
+  if (has_requested_prognostication_) {
+    prediction_service_->Cancel(this);
   }
 }
 
@@ -272,7 +265,8 @@ void Vessel::CreateFlightPlan(
     Ephemeris<Barycentric>::AdaptiveStepParameters const&
         flight_plan_adaptive_step_parameters,
     Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
-        flight_plan_generalized_adaptive_step_parameters) {
+        flight_plan_generalized_adaptive_step_parameters,
+    TaskScheduler* const flight_plan_coast_scheduler) {
   auto const history_back = history_->back();
   flight_plan_ = std::make_unique<FlightPlan>(
       initial_mass,
@@ -281,7 +275,8 @@ void Vessel::CreateFlightPlan(
       final_time,
       ephemeris_,
       flight_plan_adaptive_step_parameters,
-      flight_plan_generalized_adaptive_step_parameters);
+      flight_plan_generalized_adaptive_step_parameters,
+      flight_plan_coast_scheduler);
 }
 
 void Vessel::DeleteFlightPlan() {
@@ -305,8 +300,7 @@ void Vessel::RefreshPrediction() {
       PrognosticatorParameters{Ephemeris<Barycentric>::Guard(ephemeris_),
                                psychohistory_->back().time,
                                psychohistory_->back().degrees_of_freedom,
-                               prediction_adaptive_step_parameters_,
-                               /*shutdown=*/false};
+                               prediction_adaptive_step_parameters_};
   if (synchronous_) {
     std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication;
     std::optional<PrognosticatorParameters> prognosticator_parameters;
@@ -316,7 +310,9 @@ void Vessel::RefreshPrediction() {
                             prognostication);
     SwapPrognostication(prognostication, status);
   } else {
-    StartPrognosticatorIfNeeded();
+    has_requested_prognostication_ = true;
+    prediction_service_->Request(this,
+                                 [this]() { FlowPrognosticationIfNeeded(); });
   }
   if (prognostication_ != nullptr) {
     AttachPrediction(std::move(prognostication_));
@@ -334,7 +330,8 @@ std::string Vessel::ShortDebugString() const {
 
 void Vessel::WriteToMessage(not_null<serialization::Vessel*> const message,
                             PileUp::SerializationIndexForPileUp const&
-                                serialization_index_for_pile_up) const {
+                                serialization_index_for_pile_up,
+                            bool const only_last_point_of_history) const {
   message->set_guid(guid_);
   message->set_name(name_);
   body_.WriteToMessage(message->mutable_body());
@@ -348,7 +345,8 @@ void Vessel::WriteToMessage(not_null<serialization::Vessel*> const message,
     message->add_kept_parts(part_id);
   }
   history_->WriteToMessage(message->mutable_history(),
-                           /*forks=*/{psychohistory_, prediction_});
+                           /*forks=*/{psychohistory_, prediction_},
+                           only_last_point_of_history);
   if (flight_plan_ != nullptr) {
     flight_plan_->WriteToMessage(message->mutable_flight_plan());
   }
@@ -358,6 +356,8 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
     serialization::Vessel const& message,
     not_null<Celestial const*> const parent,
     not_null<Ephemeris<Barycentric>*> const ephemeris,
+    not_null<PredictionService*> const prediction_service,
+    TaskScheduler* const flight_plan_coast_scheduler,
     std::function<void(PartId)> const& deletion_callback) {
   bool const is_pre_cesàro = message.has_psychohistory_is_authoritative();
   bool const is_pre_chasles = message.has_prediction();
@@ -371,7 +371,8 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
       parent,
       ephemeris,
       Ephemeris<Barycentric>::AdaptiveStepParameters::ReadFromMessage(
-          message.prediction_adaptive_step_parameters()));
+          message.prediction_adaptive_step_parameters()),
+      prediction_service);
   for (auto const& serialized_part : message.parts()) {
     PartId const part_id = serialized_part.part_id();
     auto part =
@@ -428,8 +429,8 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
   }
 
   if (message.has_flight_plan()) {
-    vessel->flight_plan_ = FlightPlan::ReadFromMessage(message.flight_plan(),
-                                                       ephemeris);
+    vessel->flight_plan_ = FlightPlan::ReadFromMessage(
+        message.flight_plan(), ephemeris, flight_plan_coast_scheduler);
   }
   return vessel;
 }
@@ -487,47 +488,27 @@ Vessel::Vessel()
       prediction_adaptive_step_parameters_(DefaultPredictionParameters()),
       parent_(testing_utilities::make_not_null<Celestial const*>()),
       ephemeris_(testing_utilities::make_not_null<Ephemeris<Barycentric>*>()),
+      prediction_service_(
+          testing_utilities::make_not_null<PredictionService*>()),
       history_(make_not_null_unique<DiscreteTrajectory<Barycentric>>()) {}
 
-void Vessel::StartPrognosticatorIfNeeded() {
-  prognosticator_lock_.AssertHeld();
-  if (!prognosticator_.joinable()) {
-    prognosticator_ =
-        std::thread(std::bind(&Vessel::RepeatedlyFlowPrognostication, this));
-  }
-}
-
-void Vessel::RepeatedlyFlowPrognostication() {
-  for (;;) {
-    // No point in going faster than 50 Hz.
-    std::chrono::steady_clock::time_point const wakeup_time =
-        std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
-
-    std::optional<PrognosticatorParameters> prognosticator_parameters;
-    {
-      absl::ReaderMutexLock l(&prognosticator_lock_);
-      if (!prognosticator_parameters_) {
-        // No parameters, let's wait for them to appear.
-        continue;
-      }
-      std::swap(prognosticator_parameters, prognosticator_parameters_);
-    }
-
-    if (prognosticator_parameters->shutdown) {
-      break;
-    }
-
-    std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication;
-    Status const status =
-        FlowPrognostication(std::move(*prognosticator_parameters),
-                            prognostication);
-    {
-      absl::MutexLock l(&prognosticator_lock_);
-      SwapPrognostication(prognostication, status);
+void Vessel::FlowPrognosticationIfNeeded() {
+  std::optional<PrognosticatorParameters> prognosticator_parameters;
+  {
+    absl::MutexLock l(&prognosticator_lock_);
+    if (!prognosticator_parameters_) {
+      // The parameters were picked by a synchronous |RefreshPrediction|.
+      return;
     }
-
-    std::this_thread::sleep_until(wakeup_time);
+    std::swap(prognosticator_parameters, prognosticator_parameters_);
   }
+
+  std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication;
+  Status const status =
+      FlowPrognostication(std::move(*prognosticator_parameters),
+                          prognostication);
+  absl::MutexLock l(&prognosticator_lock_);
+  SwapPrognostication(prognostication, status);
 }
 
 Status Vessel::FlowPrognostication(
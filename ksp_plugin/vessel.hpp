@@ -15,6 +15,7 @@
 #include "ksp_plugin/orbit_analyser.hpp"
 #include "ksp_plugin/part.hpp"
 #include "ksp_plugin/pile_up.hpp"
+#include "ksp_plugin/prediction_service.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/massless_body.hpp"
@@ -27,6 +28,7 @@ namespace internal_vessel {
 
 using base::not_null;
 using base::Status;
+using base::TaskScheduler;
 using geometry::Instant;
 using geometry::Vector;
 using physics::DegreesOfFreedom;
@@ -45,14 +47,16 @@ class Vessel {
   using Manœuvres = std::vector<
       not_null<std::unique_ptr<Manœuvre<Barycentric, Navigation> const>>>;
 
-  // Constructs a vessel whose parent is initially |*parent|.  No transfer of
-  // ownership.
+  // Constructs a vessel whose parent is initially |*parent|.  The
+  // prognostications are computed by |prediction_service| when the vessel is
+  // asynchronous.  No transfer of ownership.
   Vessel(GUID const& guid,
          std::string const& name,
          not_null<Celestial const*> parent,
          not_null<Ephemeris<Barycentric>*> ephemeris,
          Ephemeris<Barycentric>::AdaptiveStepParameters const&
-             prediction_adaptive_step_parameters);
+             prediction_adaptive_step_parameters,
+         not_null<PredictionService*> prediction_service);
 
   Vessel(Vessel const&) = delete;
   Vessel(Vessel&&) = delete;
@@ -139,13 +143,16 @@ class Vessel {
   virtual void ForgetBefore(Instant const& time);
 
   // Creates a |flight_plan_| at the end of history using the given parameters.
+  // The coasts of the flight plan are integrated on
+  // |flight_plan_coast_scheduler| if it is not null.
   virtual void CreateFlightPlan(
       Instant const& final_time,
       Mass const& initial_mass,
       Ephemeris<Barycentric>::AdaptiveStepParameters const&
           flight_plan_adaptive_step_parameters,
       Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
-          flight_plan_generalized_adaptive_step_parameters);
+          flight_plan_generalized_adaptive_step_parameters,
+      TaskScheduler* flight_plan_coast_scheduler);
 
   // Deletes the |flight_plan_|.  Performs no action unless |has_flight_plan()|.
   virtual void DeleteFlightPlan();
@@ -162,14 +169,21 @@ class Vessel {
   // Returns "vessel_name (GUID)".
   std::string ShortDebugString() const;
 
-  // The vessel must satisfy |is_initialized()|.
+  // The vessel must satisfy |is_initialized()|.  If
+  // |only_last_point_of_history| is true, only the last point of the history
+  // is written, e.g., because the history is saved elsewhere.
   virtual void WriteToMessage(not_null<serialization::Vessel*> message,
                               PileUp::SerializationIndexForPileUp const&
-                                  serialization_index_for_pile_up) const;
+                                  serialization_index_for_pile_up,
+                              bool only_last_point_of_history) const;
+  // The |flight_plan_coast_scheduler| is given to the flight plan, if any, see
+  // |CreateFlightPlan|.
   static not_null<std::unique_ptr<Vessel>> ReadFromMessage(
       serialization::Vessel const& message,
       not_null<Celestial const*> parent,
       not_null<Ephemeris<Barycentric>*> ephemeris,
+      not_null<PredictionService*> prediction_service,
+      TaskScheduler* flight_plan_coast_scheduler,
       std::function<void(PartId)> const& deletion_callback);
   void FillContainingPileUpsFromMessage(
       serialization::Vessel const& message,
@@ -195,7 +209,6 @@ class Vessel {
     Instant first_time;
     DegreesOfFreedom<Barycentric> first_degrees_of_freedom;
     Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters;
-    bool shutdown = false;
   };
   friend bool operator!=(PrognosticatorParameters const& left,
                          PrognosticatorParameters const& right);
@@ -203,13 +216,9 @@ class Vessel {
   using TrajectoryIterator =
       DiscreteTrajectory<Barycentric>::Iterator (Part::*)();
 
-  // Starts the |prognosticator_| if it is not started already.  The
-  // |prognosticator_parameters_| must have been set.
-  void StartPrognosticatorIfNeeded() REQUIRES(prognosticator_lock_);
-
-  // Run by the |prognosticator_| thread to periodically recompute the
-  // prognostication.
-  void RepeatedlyFlowPrognostication();
+  // Run by the |prediction_service_| to compute the prognostication for the
+  // latest |prognosticator_parameters_|, if they have not been picked already.
+  void FlowPrognosticationIfNeeded() EXCLUDES(prognosticator_lock_);
 
   // Runs the integrator to compute the |prognostication_| based on the given
   // parameters.
@@ -242,18 +251,21 @@ class Vessel {
   // The parent body for the 2-body approximation.
   not_null<Celestial const*> parent_;
   not_null<Ephemeris<Barycentric>*> const ephemeris_;
+  not_null<PredictionService*> const prediction_service_;
 
   std::map<PartId, not_null<std::unique_ptr<Part>>> parts_;
   std::set<PartId> kept_parts_;
 
   mutable absl::Mutex prognosticator_lock_;
   // This member only contains a value if |RefreshPrediction| has been called
-  // but the parameters have not been picked by the |prognosticator_|.  It never
-  // contains a moved-from value, and is only read using |std::swap| to ensure
-  // that reading it clears it.
+  // but the parameters have not been picked by the |prediction_service_|.  It
+  // never contains a moved-from value, and is only read using |std::swap| to
+  // ensure that reading it clears it.
   std::optional<PrognosticatorParameters> prognosticator_parameters_
       GUARDED_BY(prognosticator_lock_);
-  std::thread prognosticator_;
+  // Whether a prognostication was ever requested from the
+  // |prediction_service_|.  Only accessed from the main thread.
+  bool has_requested_prognostication_ = false;
 
   // See the comments in pile_up.hpp for an explanation of the terminology.
   not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> history_;
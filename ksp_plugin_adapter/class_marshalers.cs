@@ -99,6 +99,69 @@ internal class BodyParametersRepresentation {
         new InBodyParametersMarshaler();
   }
 
+  internal class InCandidateBurnsMarshaler : ICustomMarshaler {
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal class CandidateBurnsRepresentation {
+      public IntPtr burn;
+      public int burn_size;
+    }
+
+    public static ICustomMarshaler GetInstance(string s) {
+      return instance_;
+    }
+
+    public void CleanUpNativeData(IntPtr native_data) {
+      var representation = new CandidateBurnsRepresentation();
+      Marshal.PtrToStructure(native_data, representation);
+      for (int i = 0; i < representation.burn_size; ++i) {
+        Marshal.DestroyStructure(
+            representation.burn.At(i * Marshal.SizeOf(typeof(Burn))),
+            typeof(Burn));
+      }
+      Marshal.FreeHGlobal(representation.burn);
+      Marshal.FreeHGlobal(native_data);
+    }
+
+    public IntPtr MarshalManagedToNative(object managed_object) {
+      var burns = managed_object as CandidateBurns;
+      Debug.Assert(burns != null, nameof(burns) + " != null");
+      var representation = new CandidateBurnsRepresentation{
+          burn_size = burns.burn?.Length ?? 0
+      };
+      if (representation.burn_size == 0) {
+        representation.burn = IntPtr.Zero;
+      } else {
+        int sizeof_element = Marshal.SizeOf(typeof(Burn));
+        representation.burn = Marshal.AllocHGlobal(
+            sizeof_element * burns.burn.Length);
+        for (int i = 0; i < burns.burn.Length; ++i) {
+          Marshal.StructureToPtr(burns.burn[i],
+                                 representation.burn.At(i * sizeof_element),
+                                 fDeleteOld: false);
+        }
+      }
+      IntPtr buffer = Marshal.AllocHGlobal(Marshal.SizeOf(representation));
+      Marshal.StructureToPtr(representation, buffer, fDeleteOld: false);
+      return buffer;
+    }
+
+    public object MarshalNativeToManaged(IntPtr native_data) {
+      throw Log.Fatal("InCandidateBurnsMarshaler.MarshalNativeToManaged");
+    }
+
+    public void CleanUpManagedData(object managed_data) {
+      throw Log.Fatal("InCandidateBurnsMarshaler.CleanUpManagedData");
+    }
+
+    int ICustomMarshaler.GetNativeDataSize() {
+      return -1;
+    }
+
+    private static readonly InCandidateBurnsMarshaler instance_ =
+        new InCandidateBurnsMarshaler();
+  }
+
 }
 
 }  // namespace ksp_plugin_adapter
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Runtime.InteropServices;
 
 namespace principia {
 namespace ksp_plugin_adapter {
@@ -101,12 +102,23 @@ public enum Style {
          rp2_lines_iterator.IteratorIncrement()) {
       using (DisposableIterator rp2_line_iterator =
                 rp2_lines_iterator.IteratorGetRP2LinesIterator()) {
+        // Copy all the points of the line in one go, this is much cheaper
+        // than crossing the interface for each point.
+        int line_size = rp2_line_iterator.IteratorSize();
+        if (rp2_line_coordinates_.Length < 2 * line_size) {
+          rp2_line_coordinates_ = new double[2 * line_size];
+        }
+        if (line_size > 0) {
+          Marshal.Copy(rp2_line_iterator.IteratorGetRP2LineXYBuffer(),
+                       rp2_line_coordinates_,
+                       startIndex : 0,
+                       length     : 2 * line_size);
+        }
         XY? previous_rp2_point = null;
-        for (;
-             !rp2_line_iterator.IteratorAtEnd();
-             rp2_line_iterator.IteratorIncrement()) {
+        for (int i = 0; i < line_size; ++i) {
           XY current_rp2_point = ToScreen(
-              rp2_line_iterator.IteratorGetRP2LineXY());
+              new XY{x = rp2_line_coordinates_[2 * i],
+                     y = rp2_line_coordinates_[2 * i + 1]});
           if (previous_rp2_point.HasValue) {
             if (style == Style.Faded) {
               var faded_colour = colour;
@@ -144,6 +156,10 @@ public enum Style {
                       0.5 * camera.pixelHeight};
    }
 
+  // The interleaved coordinates of the points of an RP2 line, reused across
+  // lines and frames to avoid allocations.
+  private static double[] rp2_line_coordinates_ = new double[0];
+
   private static UnityEngine.Material line_material_;
   private static UnityEngine.Material line_material {
     get {
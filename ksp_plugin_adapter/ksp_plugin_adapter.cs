@@ -76,6 +76,14 @@ private enum UnityLayers {
   private string serialization_compression_ = "";
   [KSPField(isPersistant = true)]
   private string serialization_encoding_ = "hexadecimal";
+  // Whether to save the histories of the vessels in a log next to the save,
+  // instead of in the save itself.
+  [KSPField(isPersistant = true)]
+  private bool incremental_histories_ = true;
+  // Whether to cache the ephemeris, so that loading a save doesn't reintegrate
+  // the solar system.
+  [KSPField(isPersistant = true)]
+  private bool ephemeris_cache_ = true;
 
   // Whether the plotting frame must be set to something convenient at the next
   // opportunity.
@@ -595,6 +603,9 @@ private enum UnityLayers {
   public override void OnSave(ConfigNode node) {
     base.OnSave(node);
     if (PluginRunning()) {
+      if (incremental_histories_) {
+        plugin_.WriteHistoryLog();
+      }
       IntPtr serializer = IntPtr.Zero;
       for (;;) {
         string serialization = plugin_.SerializePlugin(
@@ -641,6 +652,8 @@ private enum UnityLayers {
       if (serialization_encoding_ == "hexadecimal") {
         serialization_encoding_ = "base64";
       }
+      EnableIncrementalHistories();
+      EnableEphemerisCache();
 
       previous_display_mode_ = null;
       must_set_plotting_frame_ = true;
@@ -2273,11 +2286,40 @@ private enum UnityLayers {
                           Planetarium.InverseRotAngle);
     }
     must_set_plotting_frame_ = true;
+    EnableIncrementalHistories();
+    EnableEphemerisCache();
   } catch (Exception e) {
     Log.Fatal($"Exception while resetting plugin: {e}");
   }
   }
 
+  // The log is in the folder of the save, so that it is copied, backed up, or
+  // deleted with the save.
+  private void EnableIncrementalHistories() {
+    if (!incremental_histories_) {
+      return;
+    }
+    plugin_.EnableIncrementalHistories(
+        KSPUtil.ApplicationRootPath + Path.DirectorySeparatorChar +
+        "saves" + Path.DirectorySeparatorChar +
+        HighLogic.SaveFolder + Path.DirectorySeparatorChar +
+        "Principia" + Path.DirectorySeparatorChar +
+        "histories");
+  }
+
+  // The cache is shared by all the saves that use the same solar system.
+  private void EnableEphemerisCache() {
+    if (!ephemeris_cache_) {
+      return;
+    }
+    plugin_.EnableEphemerisCache(
+        KSPUtil.ApplicationRootPath + Path.DirectorySeparatorChar +
+        "GameData" + Path.DirectorySeparatorChar +
+        "Principia" + Path.DirectorySeparatorChar +
+        "PluginData" + Path.DirectorySeparatorChar +
+        "ephemeris");
+  }
+
   private void RemoveBuggyTidalLocking() {
     ApplyToBodyTree(body => body.tidallyLocked = false);
   }
@@ -0,0 +1,166 @@
+#include "ksp_plugin/ephemeris_cache.hpp"
+
+#include <filesystem>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/solar_system.hpp"
+#include "quantities/astronomy.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_ephemeris_cache {
+
+using geometry::Position;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::QuinlanTremaine1990Order12;
+using physics::MassiveBody;
+using physics::SolarSystem;
+using quantities::astronomy::JulianYear;
+using quantities::si::Day;
+using quantities::si::Metre;
+using quantities::si::Milli;
+
+class EphemerisCacheTest : public ::testing::Test {
+ protected:
+  EphemerisCacheTest()
+      : directory_(std::filesystem::temp_directory_path() /
+                   "principia_ephemeris_cache_test") {
+    std::filesystem::remove_all(directory_);
+  }
+
+  ~EphemerisCacheTest() override {
+    std::filesystem::remove_all(directory_);
+  }
+
+  // An ephemeris of the Sun and the Earth, so that the integration is fast.
+  not_null<std::unique_ptr<Ephemeris<Barycentric>>> MakeEphemeris(
+      std::string const& initial_state = "jd_2451545_000000000") {
+    auto& solar_system = solar_systems_.emplace_back(
+        SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+        SOLUTION_DIR / "astronomy" /
+            ("sol_initial_state_" + initial_state + ".proto.txt"),
+        /*ignore_frame=*/true);
+    std::vector<std::string> const names = solar_system.names();
+    for (auto const& name : names) {
+      if (name != "Sun" && name != "Earth") {
+        solar_system.RemoveMassiveBody(name);
+      }
+    }
+    return solar_system.MakeEphemeris(
+        /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                                 /*geopotential_tolerance=*/0x1p-24},
+        Ephemeris<Barycentric>::FixedStepParameters(
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<Barycentric>>(),
+            /*step=*/1 * Day));
+  }
+
+  static serialization::Ephemeris Save(
+      Ephemeris<Barycentric> const& ephemeris) {
+    serialization::Ephemeris message;
+    ephemeris.WriteToMessage(&message);
+    return message;
+  }
+
+  static Instant CheckpointTime(serialization::Ephemeris const& message) {
+    return Instant::ReadFromMessage(message.checkpoint_time());
+  }
+
+  std::filesystem::path const directory_;
+  std::list<SolarSystem<Barycentric>> solar_systems_;
+};
+
+TEST_F(EphemerisCacheTest, NoCache) {
+  auto const ephemeris = MakeEphemeris();
+  ephemeris->Prolong(ephemeris->t_min() + 3 * JulianYear);
+  auto const message = Save(*ephemeris);
+
+  EphemerisCache cache(directory_);
+  auto const ephemeris_read = cache.ReadEphemeris(message);
+  EXPECT_GE(CheckpointTime(message) + 1 * Day, ephemeris_read->t_max());
+}
+
+TEST_F(EphemerisCacheTest, ReadFromCache) {
+  auto const ephemeris = MakeEphemeris();
+  MassiveBody const* const earth = ephemeris->bodies()[1];
+  ephemeris->Prolong(ephemeris->t_min() + 3 * JulianYear);
+  auto const message = Save(*ephemeris);
+  EphemerisCache(directory_).Update(*ephemeris);
+
+  // The ephemeris read from the cache extends beyond the checkpoint of the
+  // save, and it is the same as the original one.
+  EphemerisCache cache(directory_);
+  auto const ephemeris_read = cache.ReadEphemeris(message);
+  MassiveBody const* const earth_read = ephemeris_read->bodies()[1];
+  EXPECT_LT(CheckpointTime(message) + 1 * JulianYear, ephemeris_read->t_max());
+  EXPECT_EQ(ephemeris->t_min(), ephemeris_read->t_min());
+  ephemeris_read->Prolong(ephemeris->t_max());
+  for (Instant time = ephemeris->t_min();
+       time <= ephemeris->t_max();
+       time += 10 * Day) {
+    EXPECT_EQ(
+        ephemeris->trajectory(earth)->EvaluateDegreesOfFreedom(time),
+        ephemeris_read->trajectory(earth_read)->EvaluateDegreesOfFreedom(time));
+  }
+}
+
+TEST_F(EphemerisCacheTest, NoRegression) {
+  auto const long_ephemeris = MakeEphemeris();
+  long_ephemeris->Prolong(long_ephemeris->t_min() + 3 * JulianYear);
+  auto const long_message = Save(*long_ephemeris);
+  EphemerisCache(directory_).Update(*long_ephemeris);
+
+  // A shorter ephemeris doesn't replace the cache.
+  auto const short_ephemeris = MakeEphemeris();
+  short_ephemeris->Prolong(short_ephemeris->t_min() + 1 * JulianYear);
+  EphemerisCache(directory_).Update(*short_ephemeris);
+
+  EphemerisCache cache(directory_);
+  auto const ephemeris_read = cache.ReadEphemeris(long_message);
+  EXPECT_LT(CheckpointTime(long_message) + 1 * JulianYear,
+            ephemeris_read->t_max());
+}
+
+TEST_F(EphemerisCacheTest, Disagreement) {
+  auto const ephemeris = MakeEphemeris();
+  ephemeris->Prolong(ephemeris->t_min() + 3 * JulianYear);
+  EphemerisCache(directory_).Update(*ephemeris);
+
+  // Same bodies and parameters, but a different history: the cache is
+  // ignored.
+  auto const other_ephemeris = MakeEphemeris("jd_2451564_587154910");
+  other_ephemeris->Prolong(other_ephemeris->t_min() + 1 * JulianYear);
+  auto const message = Save(*other_ephemeris);
+
+  EphemerisCache cache(directory_);
+  auto const ephemeris_read = cache.ReadEphemeris(message);
+  EXPECT_GE(CheckpointTime(message) + 1 * Day, ephemeris_read->t_max());
+}
+
+TEST_F(EphemerisCacheTest, TruncatedCache) {
+  auto const ephemeris = MakeEphemeris();
+  ephemeris->Prolong(ephemeris->t_min() + 3 * JulianYear);
+  EphemerisCache(directory_).Update(*ephemeris);
+  auto const short_ephemeris = MakeEphemeris();
+  short_ephemeris->Prolong(short_ephemeris->t_min() + 1 * JulianYear);
+  auto const message = Save(*short_ephemeris);
+
+  // A cache that cannot be parsed is ignored.
+  for (auto const& entry : std::filesystem::directory_iterator(directory_)) {
+    std::filesystem::resize_file(entry.path(),
+                                 std::filesystem::file_size(entry.path()) / 2);
+  }
+  EphemerisCache cache(directory_);
+  auto const ephemeris_read = cache.ReadEphemeris(message);
+  EXPECT_GE(CheckpointTime(message) + 1 * Day, ephemeris_read->t_max());
+}
+
+}  // namespace internal_ephemeris_cache
+}  // namespace ksp_plugin
+}  // namespace principia
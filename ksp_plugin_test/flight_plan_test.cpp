@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "astronomy/epoch.hpp"
+#include "base/task_scheduler.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "integrators/embedded_explicit_generalized_runge_kutta_nyström_integrator.hpp"
@@ -30,6 +31,7 @@ using astronomy::J2000;
 using base::Error;
 using base::make_not_null_shared;
 using base::make_not_null_unique;
+using base::TaskScheduler;
 using geometry::Barycentre;
 using geometry::Displacement;
 using geometry::Position;
@@ -61,6 +63,7 @@ using testing_utilities::IsNear;
 using testing_utilities::StatusIs;
 using testing_utilities::operator""_⑴;
 using ::testing::AllOf;
+using ::testing::Contains;
 using ::testing::Eq;
 using ::testing::Gt;
 using ::testing::Lt;
@@ -425,6 +428,181 @@ TEST_F(FlightPlanTest, Replace) {
   EXPECT_EQ(1, flight_plan_->number_of_manœuvres());
 }
 
+TEST_F(FlightPlanTest, ReplaceTiming) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_OK(flight_plan_->Append(MakeFirstBurn()));
+  EXPECT_OK(flight_plan_->Append(MakeSecondBurn()));
+
+  // Move the second burn later, then back.  The coast that precedes it is
+  // recomputed each time.
+  auto later_burn = MakeSecondBurn();
+  *later_burn.timing.initial_time += 3 * Second;
+  EXPECT_OK(flight_plan_->Replace(std::move(later_burn), /*index=*/1));
+  DiscreteTrajectory<Barycentric>::Iterator begin;
+  DiscreteTrajectory<Barycentric>::Iterator end;
+  flight_plan_->GetSegment(2, begin, end);
+  --end;
+  EXPECT_EQ(t0_ + 5 * Second, end->time);
+
+  EXPECT_OK(flight_plan_->Replace(MakeSecondBurn(), /*index=*/1));
+  flight_plan_->GetSegment(2, begin, end);
+  --end;
+  EXPECT_EQ(t0_ + 2 * Second, end->time);
+  EXPECT_EQ(5, flight_plan_->number_of_segments());
+
+  // Change the Δv of the second burn.  The coast that precedes it is kept.
+  auto stronger_burn = MakeSecondBurn();
+  *stronger_burn.intensity.Δv *= 2;
+  EXPECT_OK(flight_plan_->Replace(std::move(stronger_burn), /*index=*/1));
+  EXPECT_OK(flight_plan_->Replace(MakeSecondBurn(), /*index=*/1));
+
+  // The result is identical to a flight plan computed from scratch.
+  serialization::FlightPlan message;
+  flight_plan_->WriteToMessage(&message);
+  auto const flight_plan_read =
+      FlightPlan::ReadFromMessage(message,
+                                  ephemeris_.get(),
+                                  /*coast_scheduler=*/nullptr);
+  ASSERT_EQ(flight_plan_->number_of_segments(),
+            flight_plan_read->number_of_segments());
+  for (int i = 0; i < flight_plan_->number_of_segments(); ++i) {
+    DiscreteTrajectory<Barycentric>::Iterator begin_read;
+    DiscreteTrajectory<Barycentric>::Iterator end_read;
+    flight_plan_->GetSegment(i, begin, end);
+    flight_plan_read->GetSegment(i, begin_read, end_read);
+    for (; begin != end && begin_read != end_read; ++begin, ++begin_read) {
+      EXPECT_EQ(begin_read->time, begin->time) << i;
+      EXPECT_EQ(begin_read->degrees_of_freedom, begin->degrees_of_freedom)
+          << i;
+    }
+    EXPECT_TRUE(begin == end) << i;
+    EXPECT_TRUE(begin_read == end_read) << i;
+  }
+}
+
+TEST_F(FlightPlanTest, EvaluateReplacements) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_OK(flight_plan_->Append(MakeFirstBurn()));
+  EXPECT_OK(flight_plan_->Append(MakeSecondBurn()));
+
+  std::vector<NavigationManœuvre::Burn> burns;
+  burns.push_back(MakeSecondBurn());
+  burns.push_back(MakeSecondBurn());
+  *burns.back().intensity.Δv *= 2;
+  // Starts during the first burn.
+  burns.push_back(MakeSecondBurn());
+  burns.back().timing.initial_time = t0_ + 1.2 * Second;
+
+  TaskScheduler scheduler(/*number_of_workers=*/2);
+  auto const evaluations = flight_plan_->EvaluateReplacements(
+      /*index=*/1,
+      burns,
+      ephemeris_->trajectory(ephemeris_->bodies().back()),
+      scheduler);
+  ASSERT_EQ(3, evaluations.size());
+
+  // The flight plan is unchanged, and the evaluation of its own burn agrees
+  // with it.
+  EXPECT_EQ(2, flight_plan_->number_of_manœuvres());
+  EXPECT_EQ(5, flight_plan_->number_of_segments());
+  DiscreteTrajectory<Barycentric>::Iterator begin;
+  DiscreteTrajectory<Barycentric>::Iterator end;
+  flight_plan_->GetAllSegments(begin, end);
+  --end;
+  EXPECT_OK(evaluations[0].status);
+  EXPECT_EQ(end->time, *evaluations[0].final_time);
+  EXPECT_THAT(
+      AbsoluteError(end->degrees_of_freedom.position(),
+                    evaluations[0].final_degrees_of_freedom->position()),
+      Lt(0.1 * Metre));
+  EXPECT_EQ(flight_plan_->GetManœuvre(1).final_mass(),
+            *evaluations[0].final_mass);
+  EXPECT_TRUE(evaluations[0].periapsis_time.has_value());
+  EXPECT_THAT(*evaluations[0].periapsis_distance, Gt(0 * Metre));
+
+  // A larger Δv uses more propellant.
+  EXPECT_OK(evaluations[1].status);
+  EXPECT_THAT(*evaluations[1].final_mass, Lt(*evaluations[0].final_mass));
+
+  EXPECT_THAT(evaluations[2].status, StatusIs(FlightPlan::does_not_fit));
+  EXPECT_FALSE(evaluations[2].final_time.has_value());
+}
+
+TEST_F(FlightPlanTest, ParallelCoast) {
+  Instant const initial_time = root_.front().time;
+  Instant const desired_final_time = initial_time + 40 * Second;
+  DiscreteTrajectory<Barycentric>::Iterator begin;
+  DiscreteTrajectory<Barycentric>::Iterator end;
+
+  EXPECT_OK(flight_plan_->SetDesiredFinalTime(desired_final_time));
+  flight_plan_->GetAllSegments(begin, end);
+  --end;
+  DegreesOfFreedom<Barycentric> const sequential_degrees_of_freedom =
+      end->degrees_of_freedom;
+
+  // Four slices of 10 s, independently of the number of workers.
+  TaskScheduler scheduler(/*number_of_workers=*/3);
+  FlightPlan const flight_plan(
+      /*initial_mass=*/1 * Kilogram,
+      initial_time,
+      root_.front().degrees_of_freedom,
+      desired_final_time,
+      ephemeris_.get(),
+      flight_plan_->adaptive_step_parameters(),
+      flight_plan_->generalized_adaptive_step_parameters(),
+      &scheduler,
+      /*coast_minimum_slice_duration=*/10 * Second);
+  EXPECT_EQ(1, flight_plan.number_of_segments());
+  std::vector<Instant> slice_times;
+  for (int n = 0; n <= 4; ++n) {
+    slice_times.push_back(
+        initial_time + n * (desired_final_time - initial_time) / 4);
+  }
+
+  // The coast has a point at the end of each slice, and is close to the
+  // sequential one.
+  std::vector<Instant> times;
+  flight_plan.GetAllSegments(begin, end);
+  for (auto it = begin; it != end; ++it) {
+    times.push_back(it->time);
+  }
+  for (int n = 1; n <= 4; ++n) {
+    EXPECT_THAT(times, Contains(slice_times[n]));
+  }
+  --end;
+  EXPECT_EQ(desired_final_time, end->time);
+  EXPECT_THAT(AbsoluteError(sequential_degrees_of_freedom.position(),
+                            end->degrees_of_freedom.position()),
+              Lt(0.1 * Metre));
+  EXPECT_THAT(AbsoluteError(sequential_degrees_of_freedom.velocity(),
+                            end->degrees_of_freedom.velocity()),
+              Lt(0.1 * Metre / Second));
+
+  // The coarse integrations are much too inaccurate for this orbit for the
+  // slices to be consistent after the first iteration, so the states are
+  // corrected at least once.  The first correction starts the second slice
+  // exactly at the end of the first one, so the first two slices are the same
+  // as if they had been integrated one after the other.
+  DiscreteTrajectory<Barycentric> first_slices;
+  first_slices.Append(initial_time, root_.front().degrees_of_freedom);
+  for (int n = 1; n <= 2; ++n) {
+    EXPECT_OK(ephemeris_->FlowWithAdaptiveStep(
+        &first_slices,
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        slice_times[n],
+        flight_plan.adaptive_step_parameters(),
+        FlightPlan::max_ephemeris_steps_per_frame));
+  }
+  flight_plan.GetAllSegments(begin, end);
+  auto it = begin;
+  for (auto const& [time, degrees_of_freedom] : first_slices) {
+    ASSERT_TRUE(it != end);
+    EXPECT_EQ(time, it->time);
+    EXPECT_EQ(degrees_of_freedom, it->degrees_of_freedom) << time;
+    ++it;
+  }
+}
+
 TEST_F(FlightPlanTest, Segments) {
   flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
   EXPECT_OK(flight_plan_->Append(MakeFirstBurn()));
@@ -629,7 +807,9 @@ TEST_F(FlightPlanTest, Serialization) {
   EXPECT_EQ(2, message.manoeuvre_size());
 
   std::unique_ptr<FlightPlan> flight_plan_read =
-      FlightPlan::ReadFromMessage(message, ephemeris_.get());
+      FlightPlan::ReadFromMessage(message,
+                                  ephemeris_.get(),
+                                  /*coast_scheduler=*/nullptr);
   EXPECT_EQ(t0_ - 2 * π * Second, flight_plan_read->initial_time());
   EXPECT_EQ(t0_ + 42 * Second, flight_plan_read->desired_final_time());
   EXPECT_EQ(2, flight_plan_read->number_of_manœuvres());
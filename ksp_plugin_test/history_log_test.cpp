@@ -0,0 +1,273 @@
+
+#include "ksp_plugin/history_log.hpp"
+
+#include <filesystem>
+#include <map>
+#include <vector>
+
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_history_log {
+
+using geometry::Displacement;
+using geometry::Velocity;
+using physics::DegreesOfFreedom;
+using quantities::si::Metre;
+using quantities::si::Second;
+using ::testing::ElementsAre;
+
+class HistoryLogTest : public ::testing::Test {
+ protected:
+  HistoryLogTest()
+      : directory_(std::filesystem::temp_directory_path() /
+                   "principia_history_log_test") {
+    std::filesystem::remove_all(directory_);
+  }
+
+  ~HistoryLogTest() override {
+    std::filesystem::remove_all(directory_);
+  }
+
+  // Appends points at times i s for i in [first, last[.
+  static void Append(int const first,
+                     int const last,
+                     DiscreteTrajectory<Barycentric>& trajectory) {
+    for (int i = first; i < last; ++i) {
+      trajectory.Append(
+          t(i),
+          DegreesOfFreedom<Barycentric>(
+              Barycentric::origin +
+                  Displacement<Barycentric>({i * Metre, 0 * Metre, 0 * Metre}),
+              Velocity<Barycentric>()));
+    }
+  }
+
+  static Instant t(int const i) {
+    return Instant() + i * Second;
+  }
+
+  // The indices of the points of |history|, checking that their degrees of
+  // freedom are the ones given by |Append|.
+  static std::vector<int> Indices(
+      std::vector<HistoryLog::Point> const& history) {
+    std::vector<int> result;
+    for (auto const& point : history) {
+      Instant const time = Instant::ReadFromMessage(point.instant());
+      int const i = (time - Instant()) / Second;
+      EXPECT_EQ(t(i), time);
+      EXPECT_EQ(
+          Barycentric::origin +
+              Displacement<Barycentric>({i * Metre, 0 * Metre, 0 * Metre}),
+          DegreesOfFreedom<Barycentric>::ReadFromMessage(
+              point.degrees_of_freedom()).position());
+      result.push_back(i);
+    }
+    return result;
+  }
+
+  HistoryLog::Histories Read(std::filesystem::path const& path,
+                             std::int64_t const generation) {
+    HistoryLog::Histories histories;
+    HistoryLog::ReadFromFile(path, generation, histories);
+    return histories;
+  }
+
+  std::filesystem::path const directory_;
+  DiscreteTrajectory<Barycentric> history1_;
+  DiscreteTrajectory<Barycentric> history2_;
+  std::map<GUID, not_null<DiscreteTrajectory<Barycentric> const*>> const
+      histories_ = {{"1", &history1_}, {"2", &history2_}};
+};
+
+TEST_F(HistoryLogTest, Incremental) {
+  HistoryLog log(directory_);
+  Append(0, 1000, history1_);
+  Append(0, 3, history2_);
+  std::int64_t const generation0 = *log.Write(histories_);
+  auto const size0 = std::filesystem::file_size(log.path());
+
+  // A few changes to the first history, none to the second.
+  Append(1000, 1003, history1_);
+  history1_.ForgetBefore(t(10));
+  std::int64_t const generation1 = *log.Write(histories_);
+  auto const size1 = std::filesystem::file_size(log.path());
+
+  // Only the changes were written.
+  EXPECT_LT(size1 - size0, size0 / 100);
+
+  auto const histories0 = Read(log.path(), generation0);
+  EXPECT_EQ(1000, Indices(histories0.at("1")).size());
+  EXPECT_THAT(Indices(histories0.at("2")), ElementsAre(0, 1, 2));
+
+  auto const histories1 = Read(log.path(), generation1);
+  auto const indices1 = Indices(histories1.at("1"));
+  ASSERT_EQ(993, indices1.size());
+  EXPECT_EQ(10, indices1.front());
+  EXPECT_EQ(1002, indices1.back());
+  EXPECT_THAT(Indices(histories1.at("2")), ElementsAre(0, 1, 2));
+}
+
+TEST_F(HistoryLogTest, Rewrite) {
+  HistoryLog log(directory_);
+  Append(0, 10, history1_);
+  Append(0, 10, history2_);
+  log.Write(histories_);
+
+  // Rewrite the end of the first history, the way downsampling does.
+  history1_.ForgetAfter(t(5));
+  Append(7, 12, history1_);
+  // Forget the second history entirely and restart it.
+  history2_.ForgetAfter(t(0));
+  history2_.ForgetBefore(t(1));
+  Append(20, 22, history2_);
+  std::int64_t const generation = *log.Write(histories_);
+
+  auto const histories = Read(log.path(), generation);
+  EXPECT_THAT(Indices(histories.at("1")),
+              ElementsAre(0, 1, 2, 3, 4, 5, 7, 8, 9, 10, 11));
+  EXPECT_THAT(Indices(histories.at("2")), ElementsAre(20, 21));
+}
+
+TEST_F(HistoryLogTest, Branches) {
+  HistoryLog log(directory_);
+  Append(0, 3, history1_);
+  Append(0, 3, history2_);
+  std::int64_t const generation0 = *log.Write(histories_);
+  Append(3, 5, history1_);
+  std::int64_t const generation1 = *log.Write(histories_);
+
+  // Reload the first save and continue from there.
+  HistoryLog::Histories histories;
+  auto const reloaded_log =
+      HistoryLog::ReadFromFile(log.path(), generation0, histories);
+  DiscreteTrajectory<Barycentric> reloaded_history1;
+  Append(0, 3, reloaded_history1);
+  Append(10, 12, reloaded_history1);
+  std::int64_t const generation2 =
+      *reloaded_log->Write({{"1", &reloaded_history1}});
+  EXPECT_NE(generation1, generation2);
+  EXPECT_EQ(log.path(), reloaded_log->path());
+
+  // Both branches are readable.
+  auto const histories1 = Read(log.path(), generation1);
+  EXPECT_THAT(Indices(histories1.at("1")), ElementsAre(0, 1, 2, 3, 4));
+  auto const histories2 = Read(log.path(), generation2);
+  EXPECT_THAT(Indices(histories2.at("1")), ElementsAre(0, 1, 2, 10, 11));
+}
+
+TEST_F(HistoryLogTest, Vanishing) {
+  HistoryLog log(directory_);
+  Append(0, 3, history1_);
+  Append(0, 3, history2_);
+  log.Write(histories_);
+
+  // The second vessel disappears, and comes back with a new history.
+  log.Write({{"1", &history1_}});
+  DiscreteTrajectory<Barycentric> new_history2;
+  Append(5, 7, new_history2);
+  std::int64_t const generation =
+      *log.Write({{"1", &history1_}, {"2", &new_history2}});
+
+  auto const histories = Read(log.path(), generation);
+  EXPECT_THAT(Indices(histories.at("1")), ElementsAre(0, 1, 2));
+  EXPECT_THAT(Indices(histories.at("2")), ElementsAre(5, 6));
+}
+
+TEST_F(HistoryLogTest, Downsampling) {
+  HistoryLog log(directory_);
+  history1_.SetDownsampling(/*max_dense_intervals=*/10,
+                            /*tolerance=*/1 * Metre);
+  for (int i = 0; i < 10; ++i) {
+    Append(i * 17, (i + 1) * 17, history1_);
+    std::int64_t const generation = *log.Write({{"1", &history1_}});
+
+    // The points removed by downsampling are removed from the log.
+    std::vector<int> expected_indices;
+    for (auto const& point : history1_) {
+      expected_indices.push_back((point.time - Instant()) / Second);
+    }
+    EXPECT_EQ(expected_indices, Indices(Read(log.path(), generation).at("1")));
+  }
+}
+
+TEST_F(HistoryLogTest, UpToDate) {
+  HistoryLog log(directory_);
+  EXPECT_FALSE(log.IsUpToDate(histories_));
+  Append(0, 3, history1_);
+  std::int64_t const generation = *log.Write(histories_);
+  EXPECT_TRUE(log.IsUpToDate(histories_));
+  EXPECT_EQ(generation, log.generation());
+
+  Append(3, 4, history1_);
+  EXPECT_FALSE(log.IsUpToDate(histories_));
+  EXPECT_FALSE(log.IsUpToDate({{"1", &history1_}}));
+
+  HistoryLog::Histories histories;
+  auto const reloaded_log =
+      HistoryLog::ReadFromFile(log.path(), generation, histories);
+  DiscreteTrajectory<Barycentric> reloaded_history1;
+  Append(0, 3, reloaded_history1);
+  EXPECT_TRUE(
+      reloaded_log->IsUpToDate({{"1", &reloaded_history1}, {"2", &history2_}}));
+}
+
+TEST_F(HistoryLogTest, ReadErrors) {
+  HistoryLog::Histories histories;
+  EXPECT_EQ(nullptr,
+            HistoryLog::ReadFromFile(directory_ / "history.0.log",
+                                     /*generation=*/0,
+                                     histories));
+
+  HistoryLog log(directory_);
+  Append(0, 3, history1_);
+  std::int64_t const generation = *log.Write(histories_);
+  EXPECT_EQ(nullptr,
+            HistoryLog::ReadFromFile(log.path(), generation + 1, histories));
+
+  std::filesystem::resize_file(log.path(),
+                               std::filesystem::file_size(log.path()) - 1);
+  EXPECT_EQ(nullptr,
+            HistoryLog::ReadFromFile(log.path(), generation, histories));
+  EXPECT_TRUE(histories.empty());
+}
+
+TEST_F(HistoryLogTest, NewFile) {
+  constexpr int points_per_save = 10'000;
+  HistoryLog log(directory_);
+  std::int64_t first_generation;
+  std::int64_t generation;
+  std::filesystem::path path;
+  int i = 0;
+  // Each save replaces the entire history, so the log grows much faster than
+  // the history.
+  for (; i < 100; ++i) {
+    Append(i * points_per_save, (i + 1) * points_per_save, history1_);
+    history1_.ForgetBefore(t(i * points_per_save));
+    generation = *log.Write({{"1", &history1_}});
+    if (i == 0) {
+      first_generation = generation;
+      path = log.path();
+    } else if (log.path() != path) {
+      break;
+    }
+  }
+  ASSERT_LT(i, 100);
+
+  // The new file is self-contained, and the old one is still readable.
+  auto const new_histories = Read(log.path(), generation);
+  EXPECT_EQ(points_per_save, Indices(new_histories.at("1")).size());
+  EXPECT_EQ(i * points_per_save, Indices(new_histories.at("1")).front());
+  auto const old_histories = Read(path, first_generation);
+  EXPECT_EQ(points_per_save, Indices(old_histories.at("1")).size());
+  EXPECT_EQ(0, Indices(old_histories.at("1")).front());
+}
+
+}  // namespace internal_history_log
+}  // namespace ksp_plugin
+}  // namespace principia
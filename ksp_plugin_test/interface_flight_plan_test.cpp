@@ -1,6 +1,8 @@
 ﻿
 #include "ksp_plugin/interface.hpp"
 
+#include <vector>
+
 #include "base/not_null.hpp"
 #include "geometry/identity.hpp"
 #include "geometry/named_quantities.hpp"
@@ -13,6 +15,7 @@
 #include "integrators/methods.hpp"
 #include "ksp_plugin/frames.hpp"
 #include "ksp_plugin/identification.hpp"
+#include "ksp_plugin_test/mock_celestial.hpp"
 #include "ksp_plugin_test/mock_flight_plan.hpp"
 #include "ksp_plugin_test/mock_manœuvre.hpp"
 #include "ksp_plugin_test/mock_plugin.hpp"
@@ -49,7 +52,9 @@ using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
 using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
 using integrators::methods::Fine1987RKNG34;
 using ksp_plugin::Barycentric;
+using ksp_plugin::FlightPlan;
 using ksp_plugin::Index;
+using ksp_plugin::MockCelestial;
 using ksp_plugin::MockFlightPlan;
 using ksp_plugin::MockManœuvre;
 using ksp_plugin::MockPlugin;
@@ -59,6 +64,7 @@ using ksp_plugin::Navigation;
 using ksp_plugin::NavigationManœuvre;
 using ksp_plugin::WorldSun;
 using physics::BodyCentredNonRotatingDynamicFrame;
+using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::DynamicFrame;
 using physics::Frenet;
@@ -67,6 +73,7 @@ using physics::MockContinuousTrajectory;
 using physics::MockDynamicFrame;
 using physics::MockEphemeris;
 using physics::RigidMotion;
+using quantities::Force;
 using quantities::constants::StandardGravity;
 using quantities::si::Kilo;
 using quantities::si::Kilogram;
@@ -79,6 +86,7 @@ using testing_utilities::AlmostEquals;
 using testing_utilities::FillUniquePtr;
 using ::testing::AllOf;
 using ::testing::DoAll;
+using ::testing::ElementsAre;
 using ::testing::Invoke;
 using ::testing::Property;
 using ::testing::Ref;
@@ -109,6 +117,14 @@ MATCHER_P(HasΔv, Δv, "") {
   return arg.intensity.Δv && *arg.intensity.Δv == Δv;
 }
 
+MATCHER_P(HasThrusts, thrusts, "") {
+  std::vector<Force> arg_thrusts;
+  for (auto const& burn : arg) {
+    arg_thrusts.push_back(burn.thrust);
+  }
+  return arg_thrusts == thrusts;
+}
+
 }  // namespace
 
 class InterfaceFlightPlanTest : public ::testing::Test {
@@ -411,5 +427,88 @@ TEST_F(InterfaceFlightPlanTest, FlightPlan) {
   principia__FlightPlanDelete(plugin_.get(), vessel_guid);
 }
 
+TEST_F(InterfaceFlightPlanTest, EvaluateReplacements) {
+  Burn const interface_burn = {
+      /*thrust_in_kilonewtons=*/1,
+      /*specific_impulse_in_seconds_g0=*/2,
+      /*frame=*/{/*extension=*/6000, /*centre=*/celestial_index},
+      /*initial_time=*/3,
+      /*delta_v=*/{4, 5, 6},
+      /*is_inertially_fixed=*/true};
+  Burn interface_burns[2] = {interface_burn, interface_burn};
+  interface_burns[1].thrust_in_kilonewtons = 7;
+  StrictMock<MockVessel> vessel;
+  MockCelestial parent;
+  auto const identity = Rotation<Barycentric, AliceSun>::Identity();
+
+  std::vector<FlightPlan::Evaluation> evaluations(2);
+  evaluations[0].status = base::Status(base::Error::OUT_OF_RANGE, "");
+  evaluations[1].final_time = Instant() + 10 * Second;
+  evaluations[1].final_degrees_of_freedom = DegreesOfFreedom<Barycentric>(
+      Barycentric::origin +
+          Displacement<Barycentric>({1 * Metre, 2 * Metre, 3 * Metre}),
+      Velocity<Barycentric>({4 * (Metre / Second),
+                             5 * (Metre / Second),
+                             6 * (Metre / Second)}));
+  evaluations[1].final_mass = 8 * Tonne;
+  evaluations[1].periapsis_time = Instant() + 9 * Second;
+  evaluations[1].periapsis_distance = 11 * Metre;
+
+  EXPECT_CALL(*plugin_,
+              FillBodyCentredNonRotatingNavigationFrame(celestial_index, _))
+      .WillOnce(FillUniquePtr<1>(
+                    new StrictMock<MockDynamicFrame<Barycentric, Navigation>>))
+      .WillOnce(FillUniquePtr<1>(
+                    new StrictMock<MockDynamicFrame<Barycentric, Navigation>>));
+  EXPECT_CALL(*plugin_,
+              EvaluateFlightPlanReplacements(
+                  vessel_guid,
+                  42,
+                  HasThrusts(std::vector<Force>{1 * Kilo(Newton),
+                                                7 * Kilo(Newton)})))
+      .WillOnce(Return(evaluations));
+  EXPECT_CALL(*plugin_, GetVessel(vessel_guid))
+      .WillRepeatedly(Return(&vessel));
+  EXPECT_CALL(vessel, parent()).WillRepeatedly(Return(&parent));
+  EXPECT_CALL(parent, current_degrees_of_freedom(Instant() + 10 * Second))
+      .WillOnce(Return(DegreesOfFreedom<Barycentric>(
+          Barycentric::origin,
+          Velocity<Barycentric>({1 * (Metre / Second),
+                                 1 * (Metre / Second),
+                                 1 * (Metre / Second)}))));
+  EXPECT_CALL(*plugin_, PlanetariumRotation())
+      .WillRepeatedly(ReturnRef(identity));
+
+  CandidateBurns const candidate_burns{interface_burns, /*burn_size=*/2};
+  Iterator* iterator = principia__FlightPlanEvaluateReplacements(
+      plugin_.get(), vessel_guid, candidate_burns, 42);
+  EXPECT_EQ(2, principia__IteratorSize(iterator));
+
+  FlightPlanEvaluation const evaluation0 =
+      principia__IteratorGetFlightPlanEvaluation(iterator);
+  EXPECT_EQ(static_cast<int>(base::Error::OUT_OF_RANGE),
+            evaluation0.status.error);
+  EXPECT_FALSE(evaluation0.final_time_has_value);
+  EXPECT_FALSE(evaluation0.closest_approach_time_has_value);
+
+  principia__IteratorIncrement(iterator);
+  FlightPlanEvaluation const evaluation1 =
+      principia__IteratorGetFlightPlanEvaluation(iterator);
+  EXPECT_EQ(FlightPlanEvaluation({/*status=*/{/*error=*/0},
+                                  /*final_time=*/10,
+                                  /*final_degrees_of_freedom=*/{{1, 2, 3},
+                                                                {3, 4, 5}},
+                                  /*final_mass_in_tonnes=*/8,
+                                  /*final_time_has_value=*/true,
+                                  /*closest_approach_time=*/9,
+                                  /*closest_approach_distance=*/11,
+                                  /*closest_approach_time_has_value=*/true}),
+            evaluation1);
+
+  principia__IteratorIncrement(iterator);
+  EXPECT_TRUE(principia__IteratorAtEnd(iterator));
+  principia__IteratorDelete(&iterator);
+}
+
 }  // namespace interface
 }  // namespace principia
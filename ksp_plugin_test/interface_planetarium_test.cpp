@@ -6,13 +6,16 @@
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/permutation.hpp"
 #include "geometry/rotation.hpp"
+#include "geometry/rp2_point.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/iterators.hpp"
 #include "ksp_plugin_test/mock_planetarium.hpp"
 #include "ksp_plugin_test/mock_plugin.hpp"
 #include "ksp_plugin_test/mock_renderer.hpp"
 #include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
 #include "testing_utilities/actions.hpp"
 
 namespace principia {
@@ -25,12 +28,16 @@ using geometry::OrthogonalMap;
 using geometry::Permutation;
 using geometry::RigidTransformation;
 using geometry::Rotation;
+using geometry::RP2Lines;
+using geometry::RP2Point;
 using ksp_plugin::Camera;
 using ksp_plugin::Navigation;
 using ksp_plugin::MockPlanetarium;
 using ksp_plugin::MockPlugin;
 using ksp_plugin::MockRenderer;
+using ksp_plugin::TypedIterator;
 using quantities::Length;
+using quantities::si::Metre;
 using testing_utilities::FillUniquePtr;
 using ::testing::IsNull;
 using ::testing::Return;
@@ -78,5 +85,41 @@ TEST_F(InterfacePlanetariumTest, ConstructionDestruction) {
   EXPECT_THAT(planetarium, IsNull());
 }
 
+TEST_F(InterfacePlanetariumTest, RP2LineXYBuffer) {
+  using P = RP2Point<Length, Camera>;
+  RP2Lines<Length, Camera> rp2_lines = {
+      {P(1 * Metre, 2 * Metre, 1), P(3 * Metre, 4 * Metre, 2)},
+      {P(5 * Metre, 6 * Metre, 1)}};
+  Iterator* rp2_lines_iterator =
+      new TypedIterator<RP2Lines<Length, Camera>>(std::move(rp2_lines));
+
+  Iterator* rp2_line_iterator =
+      principia__IteratorGetRP2LinesIterator(rp2_lines_iterator);
+  ASSERT_EQ(2, principia__IteratorSize(rp2_line_iterator));
+  XY const* const xys =
+      principia__IteratorGetRP2LineXYBuffer(rp2_line_iterator);
+  // The buffer agrees with the point-by-point access.
+  for (int i = 0; i < 2; ++i) {
+    XY const xy = principia__IteratorGetRP2LineXY(rp2_line_iterator);
+    EXPECT_EQ(xy.x, xys[i].x);
+    EXPECT_EQ(xy.y, xys[i].y);
+    principia__IteratorIncrement(rp2_line_iterator);
+  }
+  EXPECT_EQ(1, xys[0].x);
+  EXPECT_EQ(2, xys[0].y);
+  EXPECT_EQ(1.5, xys[1].x);
+  EXPECT_EQ(2, xys[1].y);
+  principia__IteratorDelete(&rp2_line_iterator);
+
+  principia__IteratorIncrement(rp2_lines_iterator);
+  rp2_line_iterator =
+      principia__IteratorGetRP2LinesIterator(rp2_lines_iterator);
+  ASSERT_EQ(1, principia__IteratorSize(rp2_line_iterator));
+  EXPECT_EQ(5,
+            principia__IteratorGetRP2LineXYBuffer(rp2_line_iterator)[0].x);
+  principia__IteratorDelete(&rp2_line_iterator);
+  principia__IteratorDelete(&rp2_lines_iterator);
+}
+
 }  // namespace interface
 }  // namespace principia
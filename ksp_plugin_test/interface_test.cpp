@@ -1,6 +1,7 @@
 ﻿
 #include "ksp_plugin/interface.hpp"
 
+#include <filesystem>
 #include <limits>
 #include <optional>
 #include <string>
@@ -647,6 +648,20 @@ TEST_F(InterfaceTest, SerializePlugin) {
   EXPECT_THAT(serialization, IsNull());
 }
 
+TEST_F(InterfaceTest, EnableEphemerisCache) {
+  EXPECT_CALL(*plugin_,
+              EnableEphemerisCache(std::filesystem::path("ephemeris")));
+  principia__EnableEphemerisCache(plugin_.get(), "ephemeris");
+}
+
+TEST_F(InterfaceTest, IncrementalHistories) {
+  EXPECT_CALL(*plugin_,
+              EnableIncrementalHistories(std::filesystem::path("histories")));
+  principia__EnableIncrementalHistories(plugin_.get(), "histories");
+  EXPECT_CALL(*plugin_, WriteHistoryLog());
+  principia__WriteHistoryLog(plugin_.get());
+}
+
 TEST_F(InterfaceTest, DeserializePlugin) {
   PushDeserializer* deserializer = nullptr;
   Plugin const* plugin = nullptr;
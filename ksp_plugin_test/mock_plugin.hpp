@@ -1,6 +1,7 @@
 ﻿
 #pragma once
 
+#include <filesystem>
 #include <optional>
 #include <string>
 #include <vector>
@@ -69,6 +70,12 @@ class MockPlugin : public Plugin {
                           Instant const& final_time,
                           Mass const& initial_mass));
 
+  MOCK_CONST_METHOD3(EvaluateFlightPlanReplacements,
+                     std::vector<FlightPlan::Evaluation>(
+                         GUID const& vessel_guid,
+                         int index,
+                         std::vector<NavigationManœuvre::Burn> const& burns));
+
   MOCK_CONST_METHOD2(SetPredictionAdaptiveStepParameters,
                      void(GUID const& vessel_guid,
                           Ephemeris<Barycentric>::AdaptiveStepParameters const&
@@ -126,6 +133,12 @@ class MockPlugin : public Plugin {
   MOCK_METHOD0(renderer, Renderer&());
   MOCK_CONST_METHOD0(renderer, Renderer const&());
 
+  MOCK_METHOD1(EnableEphemerisCache,
+               void(std::filesystem::path const& directory));
+  MOCK_METHOD1(EnableIncrementalHistories,
+               void(std::filesystem::path const& directory));
+  MOCK_METHOD0(WriteHistoryLog, void());
+
   MOCK_CONST_METHOD1(WriteToMessage,
                      void(not_null<serialization::Plugin*> message));
 };
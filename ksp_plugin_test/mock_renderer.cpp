@@ -39,6 +39,21 @@ MockRenderer::RenderBarycentricTrajectoryInWorld(
   return std::move(rendered_barycentric_trajectory_in_world);
 }
 
+not_null<std::unique_ptr<DiscreteTrajectory<World>>>
+MockRenderer::RenderBarycentricTrajectoryInWorld(
+    Instant const& time,
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Length const& /*tolerance*/,
+    Position<World> const& sun_world_position,
+    Rotation<Barycentric, AliceSun> const& planetarium_rotation) const {
+  return RenderBarycentricTrajectoryInWorld(time,
+                                            begin,
+                                            end,
+                                            sun_world_position,
+                                            planetarium_rotation);
+}
+
 }  // namespace internal_renderer
 }  // namespace ksp_plugin
 }  // namespace principia
@@ -29,6 +29,16 @@ class MockRenderer : public Renderer {
       Position<World> const& sun_world_position,
       Rotation<Barycentric, AliceSun> const& planetarium_rotation)
       const override;
+  // Ignores the |tolerance| and fills like the above.
+  not_null<std::unique_ptr<DiscreteTrajectory<World>>>
+  RenderBarycentricTrajectoryInWorld(
+      Instant const& time,
+      DiscreteTrajectory<Barycentric>::Iterator const& begin,
+      DiscreteTrajectory<Barycentric>::Iterator const& end,
+      Length const& tolerance,
+      Position<World> const& sun_world_position,
+      Rotation<Barycentric, AliceSun> const& planetarium_rotation)
+      const override;
   MOCK_CONST_METHOD6(
       FillRenderedBarycentricTrajectoryInWorld,
       void(Instant const& time,
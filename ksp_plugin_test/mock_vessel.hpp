@@ -27,21 +27,23 @@ class MockVessel : public Vessel {
 
   MOCK_METHOD1(ForgetBefore, void(Instant const& time));
 
-  MOCK_METHOD4(CreateFlightPlan,
+  MOCK_METHOD5(CreateFlightPlan,
                void(Instant const& final_time,
                     Mass const& initial_mass,
                     Ephemeris<Barycentric>::AdaptiveStepParameters const&
                         flight_plan_adaptive_step_parameters,
                     Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters
                         const&
-                        flight_plan_generalized_adaptive_step_parameters));
+                        flight_plan_generalized_adaptive_step_parameters,
+                    TaskScheduler* flight_plan_coast_scheduler));
 
   MOCK_METHOD0(DeleteFlightPlan, void());
 
-  MOCK_CONST_METHOD2(WriteToMessage,
+  MOCK_CONST_METHOD3(WriteToMessage,
                      void(not_null<serialization::Vessel*> message,
                           PileUp::SerializationIndexForPileUp const&
-                              serialization_index_for_pile_up));
+                              serialization_index_for_pile_up,
+                          bool only_last_point_of_history));
 };
 
 }  // namespace internal_vessel
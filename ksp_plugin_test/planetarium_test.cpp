@@ -6,6 +6,7 @@
 
 #include "base/not_null.hpp"
 #include "base/serialization.hpp"
+#include "base/task_scheduler.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/linear_map.hpp"
@@ -34,6 +35,7 @@ using astronomy::InfinitePast;
 using astronomy::InfiniteFuture;
 using base::make_not_null_unique;
 using base::ParseFromBytes;
+using base::TaskScheduler;
 using geometry::AngularVelocity;
 using geometry::Bivector;
 using geometry::DeduceSignReversingOrientation;
@@ -70,6 +72,7 @@ using testing_utilities::ReadFromBinaryFile;
 using testing_utilities::VanishesBefore;
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::ElementsAre;
 using ::testing::Ge;
 using ::testing::Le;
 using ::testing::Return;
@@ -203,20 +206,41 @@ TEST_F(PlanetariumTest, PlotMethod1) {
       /*field_of_view=*/90 * Degree);
   Planetarium planetarium(
       parameters, perspective_, &ephemeris_, &plotting_frame_);
+  // Without a level of detail, all the points of the trajectory are
+  // coalesced.
+  EXPECT_THAT(planetarium.PlotMethod1(discrete_trajectory->begin(),
+                                      discrete_trajectory->end(),
+                                      t0_ + 10 * Second,
+                                      /*reverse=*/false),
+              ElementsAre(SizeIs(4954)));
+
+  // The points are taken from the level of detail of the trajectory, so there
+  // are far fewer than the 25'000 points of the trajectory, or than the 4954
+  // points obtained by coalescing the segments of all the points.
+  discrete_trajectory->EnableLevelOfDetail();
   auto const rp2_lines =
       planetarium.PlotMethod1(discrete_trajectory->begin(),
                               discrete_trajectory->end(),
                               t0_ + 10 * Second,
                               /*reverse=*/false);
-
   EXPECT_THAT(rp2_lines, SizeIs(1));
-  EXPECT_THAT(rp2_lines[0], SizeIs(4954));
+  EXPECT_THAT(rp2_lines[0], SizeIs(AllOf(Ge(50), Le(100))));
   for (auto const& rp2_point : rp2_lines[0]) {
     EXPECT_THAT(rp2_point.x(),
                 AllOf(Ge(0 * Metre),
                       Le(5.0 / Sqrt(3.0) * Metre)));
     EXPECT_THAT(rp2_point.y(), VanishesBefore(1 * Metre, 0, 14));
   }
+
+  // Plotting backwards yields the same endpoints, swapped.
+  auto const reversed_rp2_lines =
+      planetarium.PlotMethod1(discrete_trajectory->begin(),
+                              discrete_trajectory->end(),
+                              t0_ + 10 * Second,
+                              /*reverse=*/true);
+  EXPECT_THAT(reversed_rp2_lines, SizeIs(1));
+  EXPECT_EQ(rp2_lines[0].front(), reversed_rp2_lines[0].back());
+  EXPECT_EQ(rp2_lines[0].back(), reversed_rp2_lines[0].front());
 }
 
 TEST_F(PlanetariumTest, PlotMethod2) {
@@ -250,6 +274,48 @@ TEST_F(PlanetariumTest, PlotMethod2) {
   }
 }
 
+TEST_F(PlanetariumTest, PlotMethod2Parallel) {
+  // Same as above, but the trajectory is plotted in parallel.
+  auto const discrete_trajectory =
+      NewCircularTrajectory(/*period=*/100'000 * Second,
+                            /*step=*/1 * Second,
+                            /*last=*/25'000 * Second);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  TaskScheduler scheduler(/*number_of_workers=*/2);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_, &scheduler);
+  for (bool const reverse : {false, true}) {
+    auto const rp2_lines =
+        planetarium.PlotMethod2(discrete_trajectory->begin(),
+                                discrete_trajectory->end(),
+                                t0_ + 10 * Second,
+                                reverse);
+
+    // The lines of the subintervals are joined.  Each subinterval may need a
+    // few more points than the sequential plot.
+    ASSERT_THAT(rp2_lines, SizeIs(1));
+    EXPECT_THAT(rp2_lines[0], SizeIs(AllOf(Ge(43), Le(2 * 43))));
+    for (auto const& rp2_point : rp2_lines[0]) {
+      EXPECT_THAT(rp2_point.x(),
+                  AllOf(Ge(0 * Metre),
+                        Le((5.0 / Sqrt(3.0)) * Metre)));
+      EXPECT_THAT(rp2_point.y(), VanishesBefore(1 * Metre, 0, 14));
+    }
+    // The points are in plotting order.
+    EXPECT_EQ(reverse, rp2_lines[0].front().x() > rp2_lines[0].back().x());
+    // The plot doesn't depend on the scheduling.
+    EXPECT_EQ(rp2_lines,
+              planetarium.PlotMethod2(discrete_trajectory->begin(),
+                                      discrete_trajectory->end(),
+                                      t0_ + 10 * Second,
+                                      reverse));
+  }
+}
+
 #if !defined(_DEBUG)
 TEST_F(PlanetariumTest, RealSolarSystem) {
   auto discrete_trajectory = DiscreteTrajectory<Barycentric>::ReadFromMessage(
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
 #include <limits>
 #include <map>
 #include <memory>
@@ -241,6 +242,10 @@ class PluginTest : public testing::Test {
   }
 
   void InsertAllSolarSystemBodies() {
+    InsertAllSolarSystemBodies(*plugin_);
+  }
+
+  void InsertAllSolarSystemBodies(Plugin& plugin) {
     for (int index = SolarSystemFactory::Sun;
          index <= SolarSystemFactory::LastMajorBody;
          ++index) {
@@ -249,7 +254,7 @@ class PluginTest : public testing::Test {
         parent_index = SolarSystemFactory::parent(index);
       }
       std::string const name = SolarSystemFactory::name(index);
-      plugin_->InsertCelestialAbsoluteCartesian(
+      plugin.InsertCelestialAbsoluteCartesian(
           index,
           parent_index,
           solar_system_->gravity_model_message(name),
@@ -471,6 +476,128 @@ TEST_F(PluginTest, Serialization) {
                     centre());
 }
 
+TEST_F(PluginTest, IncrementalHistories) {
+  GUID const satellite = "satellite";
+  std::filesystem::path const directory =
+      std::filesystem::temp_directory_path() /
+      "principia_plugin_test_histories";
+  std::filesystem::remove_all(directory);
+
+  auto plugin = make_not_null_unique<Plugin>(
+                    initial_time_,
+                    initial_time_,
+                    planetarium_rotation_);
+  InsertAllSolarSystemBodies(*plugin);
+  plugin->EndInitialization();
+  plugin->EnableIncrementalHistories(directory);
+  bool inserted;
+  plugin->InsertOrKeepVessel(satellite,
+                             "v" + satellite,
+                             SolarSystemFactory::Earth,
+                             /*loaded=*/false,
+                             inserted);
+  plugin->InsertUnloadedPart(
+      /*part_id=*/666,
+      "part",
+      satellite,
+      RelativeDegreesOfFreedom<AliceSun>(satellite_initial_displacement_,
+                                         satellite_initial_velocity_));
+  plugin->PrepareToReportCollisions();
+  plugin->FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+  Instant const time = ParseTT(initial_time_);
+  plugin->AdvanceTime(HistoryTime(time, 6), Angle());
+  VesselSet collided_vessels;
+  plugin->CatchUpLaggingVessels(collided_vessels);
+  std::int64_t const history_size =
+      plugin->GetVessel(satellite)->psychohistory().root()->Size();
+  ASSERT_LT(1, history_size);
+
+  // The histories are saved in full until they are written to the log.
+  serialization::Plugin full_message;
+  plugin->WriteToMessage(&full_message);
+  EXPECT_FALSE(full_message.has_history_log());
+  EXPECT_EQ(history_size,
+            full_message.vessel(0).vessel().history().timeline_size());
+
+  plugin->WriteHistoryLog();
+  serialization::Plugin message;
+  plugin->WriteToMessage(&message);
+  ASSERT_TRUE(message.has_history_log());
+  EXPECT_EQ(1, message.vessel(0).vessel().history().timeline_size());
+
+  // The histories are restored from the log, which the plugin continues.
+  auto read_plugin = Plugin::ReadFromMessage(message);
+  EXPECT_EQ(history_size,
+            read_plugin->GetVessel(satellite)->psychohistory().root()->Size());
+  read_plugin->EnableIncrementalHistories(directory);
+  serialization::Plugin second_message;
+  read_plugin->WriteToMessage(&second_message);
+  EXPECT_THAT(second_message, EqualsProto(message));
+
+  // When the histories change, the log is stale until it is written again.
+  plugin->InsertOrKeepVessel(satellite,
+                             "v" + satellite,
+                             SolarSystemFactory::Earth,
+                             /*loaded=*/false,
+                             inserted);
+  plugin->AdvanceTime(HistoryTime(time, 9), Angle());
+  plugin->CatchUpLaggingVessels(collided_vessels);
+  serialization::Plugin stale_message;
+  plugin->WriteToMessage(&stale_message);
+  EXPECT_FALSE(stale_message.has_history_log());
+  EXPECT_LT(history_size,
+            stale_message.vessel(0).vessel().history().timeline_size());
+
+  // Without the log, the histories are reduced to their last point, and are
+  // then saved in full.
+  std::filesystem::remove_all(directory);
+  auto truncated_plugin = Plugin::ReadFromMessage(message);
+  EXPECT_EQ(
+      1,
+      truncated_plugin->GetVessel(satellite)->psychohistory().root()->Size());
+  truncated_plugin->WriteHistoryLog();
+  serialization::Plugin truncated_message;
+  truncated_plugin->WriteToMessage(&truncated_message);
+  EXPECT_FALSE(truncated_message.has_history_log());
+  EXPECT_EQ(1, truncated_message.vessel(0).vessel().history().timeline_size());
+}
+
+TEST_F(PluginTest, EphemerisCache) {
+  std::filesystem::path const directory =
+      std::filesystem::temp_directory_path() /
+      "principia_plugin_test_ephemeris";
+  std::filesystem::remove_all(directory);
+
+  auto plugin = make_not_null_unique<Plugin>(
+                    initial_time_,
+                    initial_time_,
+                    planetarium_rotation_);
+  InsertAllSolarSystemBodies(*plugin);
+  plugin->EndInitialization();
+  plugin->EnableEphemerisCache(directory);
+  plugin->AdvanceTime(ParseTT(initial_time_) + 1 * Day, Angle());
+
+  serialization::Plugin message;
+  plugin->WriteToMessage(&message);
+  EXPECT_EQ(directory.string(), message.ephemeris_cache_directory());
+  EXPECT_FALSE(std::filesystem::is_empty(directory));
+
+  // The plugin is read with the cache, and keeps using it.
+  auto read_plugin = Plugin::ReadFromMessage(message);
+  read_plugin->EnableEphemerisCache(directory);
+  serialization::Plugin second_message;
+  read_plugin->WriteToMessage(&second_message);
+  EXPECT_EQ(directory.string(), second_message.ephemeris_cache_directory());
+
+  // A cache that cannot be read is ignored.
+  for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+    std::filesystem::resize_file(entry.path(), 1);
+  }
+  read_plugin = Plugin::ReadFromMessage(message);
+  EXPECT_EQ(plugin->CurrentTime(), read_plugin->CurrentTime());
+  std::filesystem::remove_all(directory);
+}
+
 TEST_F(PluginTest, Initialization) {
   InsertAllSolarSystemBodies();
   plugin_->EndInitialization();
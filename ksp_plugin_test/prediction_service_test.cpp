@@ -0,0 +1,113 @@
+#include "ksp_plugin/prediction_service.hpp"
+
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_prediction_service {
+
+using ::testing::ElementsAre;
+
+class PredictionServiceTest : public ::testing::Test {
+ protected:
+  PredictionServiceTest() : service_(/*number_of_workers=*/1) {}
+
+  // Occupies the only worker until |release_| is notified.
+  void Block() {
+    service_.Request(&blocker_, [this]() {
+      blocked_.Notify();
+      release_.WaitForNotification();
+    });
+    blocked_.WaitForNotification();
+  }
+
+  // Waits until all the requests made before this call have been served.
+  void Drain() {
+    absl::Notification drained;
+    service_.Request(&drainer_, [&drained]() { drained.Notify(); });
+    drained.WaitForNotification();
+  }
+
+  // Requests a computation for |client| that records it in |order_|.
+  void Record(int const& client) {
+    service_.Request(&client, [this, &client]() {
+      absl::MutexLock l(&lock_);
+      order_.push_back(&client);
+    });
+  }
+
+  PredictionService service_;
+  int const blocker_ = 0;
+  int const drainer_ = 0;
+  absl::Notification blocked_;
+  absl::Notification release_;
+
+  absl::Mutex lock_;
+  std::vector<int const*> order_ GUARDED_BY(lock_);
+};
+
+TEST_F(PredictionServiceTest, Coalescing) {
+  Block();
+  int const client = 0;
+  int value = 0;
+  for (int i = 1; i <= 3; ++i) {
+    service_.Request(&client, [&value, i]() { value = i; });
+  }
+  release_.Notify();
+  Drain();
+  // Only the last request was served.
+  EXPECT_EQ(3, value);
+  auto const statistics = service_.statistics();
+  EXPECT_EQ(3, statistics.computations);
+  EXPECT_EQ(2, statistics.coalesced_requests);
+  EXPECT_LE(statistics.mean_latency, statistics.max_latency);
+}
+
+TEST_F(PredictionServiceTest, Priority) {
+  int const a = 0;
+  int const b = 0;
+  int const c = 0;
+  Block();
+  Record(b);
+  Record(c);
+  Record(a);
+  // A request that is coalesced keeps its place in the queue.
+  Record(b);
+  service_.Prioritize({&a});
+  release_.Notify();
+  Drain();
+  absl::MutexLock l(&lock_);
+  EXPECT_THAT(order_, ElementsAre(&a, &b, &c));
+}
+
+TEST_F(PredictionServiceTest, Cancel) {
+  int const client = 0;
+  bool ran = false;
+  Block();
+  service_.Request(&client, [&ran]() { ran = true; });
+  service_.Cancel(&client);
+  release_.Notify();
+  Drain();
+  EXPECT_FALSE(ran);
+
+  // Cancelling waits for the computation in progress.
+  absl::Notification started;
+  service_.Request(&client, [&started, &ran]() {
+    started.Notify();
+    absl::SleepFor(absl::Milliseconds(100));
+    ran = true;
+  });
+  started.WaitForNotification();
+  service_.Cancel(&client);
+  EXPECT_TRUE(ran);
+}
+
+}  // namespace internal_prediction_service
+}  // namespace ksp_plugin
+}  // namespace principia
@@ -1,6 +1,8 @@
 
 #include "ksp_plugin/renderer.hpp"
 
+#include <vector>
+
 #include "base/not_null.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -42,6 +44,7 @@ using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
 using testing_utilities::Componentwise;
+using ::testing::ElementsAre;
 using ::testing::Ref;
 using ::testing::Return;
 using ::testing::ReturnRef;
@@ -167,6 +170,71 @@ TEST_F(RendererTest, RenderBarycentricTrajectoryInPlottingWithoutTargetVessel) {
   }
 }
 
+TEST_F(RendererTest, RenderBarycentricTrajectoryInPlottingWithLevelOfDetail) {
+  DiscreteTrajectory<Barycentric> trajectory_to_render;
+  FillTrajectory<Barycentric>(
+      /*time=*/t0_,
+      /*step=*/1 * Second,
+      /*number_of_steps=*/10,
+      /*position_function=*/
+          [this](Instant const& t) {
+            return Barycentric::origin +
+                   (t - t0_) * Velocity<Barycentric>({6 * Metre / Second,
+                                                      5 * Metre / Second,
+                                                      4 * Metre / Second});
+          },
+      /*velocity_function=*/
+          [](Instant const& t) {
+            return Velocity<Barycentric>(
+                {6 * Metre / Second, 5 * Metre / Second, 4 * Metre / Second});
+          },
+      trajectory_to_render);
+
+  RigidMotion<Barycentric, Navigation> rigid_motion(
+      RigidTransformation<Barycentric, Navigation>::Identity(),
+      AngularVelocity<Barycentric>(),
+      Velocity<Barycentric>());
+  EXPECT_CALL(*dynamic_frame_, ToThisFrameAtTime(_))
+      .WillRepeatedly(Return(rigid_motion));
+
+  auto const times = [](DiscreteTrajectory<Navigation> const& trajectory) {
+    std::vector<Instant> result;
+    for (auto const& point : trajectory) {
+      result.push_back(point.time);
+    }
+    return result;
+  };
+
+  // Without a level of detail, all the points are rendered.
+  EXPECT_EQ(10,
+            renderer_.RenderBarycentricTrajectoryInPlotting(
+                trajectory_to_render.begin(),
+                trajectory_to_render.end(),
+                /*tolerance=*/1 * Metre)->Size());
+
+  // The trajectory is a straight line in a non-moving frame, so the longest
+  // chords are used.
+  trajectory_to_render.EnableLevelOfDetail();
+  auto const rendered_trajectory =
+      renderer_.RenderBarycentricTrajectoryInPlotting(
+          trajectory_to_render.begin(),
+          trajectory_to_render.end(),
+          /*tolerance=*/1 * Metre);
+  EXPECT_THAT(times(*rendered_trajectory),
+              ElementsAre(t0_, t0_ + 8 * Second, t0_ + 9 * Second));
+  EXPECT_THAT(
+      rendered_trajectory->back().degrees_of_freedom,
+      Componentwise(
+          AlmostEquals(Navigation::origin +
+                           Displacement<Navigation>(
+                               {54 * Metre, 45 * Metre, 36 * Metre}),
+                       0),
+          AlmostEquals(Velocity<Navigation>({6 * Metre / Second,
+                                             5 * Metre / Second,
+                                             4 * Metre / Second}),
+                       0)));
+}
+
 TEST_F(RendererTest, RenderBarycentricTrajectoryInPlottingWithTargetVessel) {
   MockEphemeris<Barycentric> ephemeris;
   MockContinuousTrajectory<Barycentric> celestial_trajectory;
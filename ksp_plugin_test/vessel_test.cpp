@@ -75,11 +75,13 @@ class VesselTest : public testing::Test {
             InertiaTensor<RigidPart>::MakeWaterSphereInertiaTensor(mass1_)),
         inertia_tensor2_(
             InertiaTensor<RigidPart>::MakeWaterSphereInertiaTensor(mass2_)),
+        prediction_service_(/*number_of_workers=*/1),
         vessel_("123",
                 "vessel",
                 &celestial_,
                 &ephemeris_,
-                DefaultPredictionParameters()) {
+                DefaultPredictionParameters(),
+                &prediction_service_) {
     auto p1 = make_not_null_unique<Part>(
         part_id1_,
         "p1",
@@ -123,6 +125,7 @@ class VesselTest : public testing::Test {
 
   Part* p1_;
   Part* p2_;
+  PredictionService prediction_service_;
   Vessel vessel_;
 };
 
@@ -412,7 +415,8 @@ TEST_F(VesselTest, FlightPlan) {
   vessel_.CreateFlightPlan(astronomy::J2000 + 3.0 * Second,
                            10 * Kilogram,
                            DefaultPredictionParameters(),
-                           DefaultBurnParameters());
+                           DefaultBurnParameters(),
+                           /*flight_plan_coast_scheduler=*/nullptr);
   EXPECT_TRUE(vessel_.has_flight_plan());
   EXPECT_EQ(0, vessel_.flight_plan().number_of_manœuvres());
   EXPECT_EQ(1, vessel_.flight_plan().number_of_segments());
@@ -444,22 +448,29 @@ TEST_F(VesselTest, SerializationSuccess) {
   vessel_.CreateFlightPlan(astronomy::J2000 + 3.0 * Second,
                            10 * Kilogram,
                            DefaultPredictionParameters(),
-                           DefaultBurnParameters());
+                           DefaultBurnParameters(),
+                           /*flight_plan_coast_scheduler=*/nullptr);
 
   serialization::Vessel message;
   vessel_.WriteToMessage(&message,
-                         serialization_index_for_pile_up.AsStdFunction());
+                         serialization_index_for_pile_up.AsStdFunction(),
+                         /*only_last_point_of_history=*/false);
   EXPECT_TRUE(message.has_history());
   EXPECT_TRUE(message.has_flight_plan());
 
   EXPECT_CALL(ephemeris_, Prolong(_)).Times(2);
-  auto const v = Vessel::ReadFromMessage(
-      message, &celestial_, &ephemeris_, /*deletion_callback=*/nullptr);
+  auto const v = Vessel::ReadFromMessage(message,
+                                        &celestial_,
+                                        &ephemeris_,
+                                        &prediction_service_,
+                                        /*flight_plan_coast_scheduler=*/nullptr,
+                                        /*deletion_callback=*/nullptr);
   EXPECT_TRUE(v->has_flight_plan());
 
   serialization::Vessel second_message;
   v->WriteToMessage(&second_message,
-                    serialization_index_for_pile_up.AsStdFunction());
+                    serialization_index_for_pile_up.AsStdFunction(),
+                    /*only_last_point_of_history=*/false);
   EXPECT_THAT(message, EqualsProto(second_message));
 }
 
@@ -1,10 +1,17 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <optional>
 
 #include "base/constant_function.hpp"
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/trajectory.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
 
 namespace principia {
 namespace physics {
@@ -12,7 +19,111 @@ namespace internal_apsides {
 
 using base::ConstantFunction;
 using base::Identically;
+using base::not_null;
+using geometry::Instant;
 using geometry::Vector;
+using quantities::Length;
+using quantities::Square;
+using quantities::Variation;
+
+// A streaming version of |ComputeApsides|: the points of a trajectory are given
+// one at a time, in increasing time order, together with the degrees of freedom
+// of the reference at the same time.  An apsis is detected as soon as the
+// interval that contains it is complete, so a detector may follow a trajectory
+// as it is being integrated.
+template<typename Frame>
+class ApsisDetector final {
+ public:
+  // The degrees of freedom of the trajectory and of the reference at the time
+  // of a point.
+  struct Sample final {
+    DegreesOfFreedom<Frame> degrees_of_freedom;
+    DegreesOfFreedom<Frame> reference_degrees_of_freedom;
+
+    bool operator==(Sample const& right) const;
+  };
+
+  // Processes the point of the trajectory at |time|, which must be after the
+  // points previously processed.  If there is an apsis between the previous
+  // point and this one, appends it to |apoapsides| or |periapsides|.
+  void Append(Instant const& time,
+              Sample const& sample,
+              DiscreteTrajectory<Frame>& apoapsides,
+              DiscreteTrajectory<Frame>& periapsides);
+
+ private:
+  std::optional<Instant> previous_time_;
+  std::optional<DegreesOfFreedom<Frame>> previous_degrees_of_freedom_;
+  std::optional<Square<Length>> previous_squared_distance_;
+  std::optional<Variation<Square<Length>>>
+      previous_squared_distance_derivative_;
+};
+
+// A streaming version of |ComputeNodes|, see |ApsisDetector|.
+template<typename Frame, typename Predicate = ConstantFunction<bool>>
+class NodeDetector final {
+ public:
+  using Sample = DegreesOfFreedom<Frame>;
+
+  explicit NodeDetector(Vector<double, Frame> const& north,
+                        Predicate predicate = Identically(true));
+
+  // Processes the point of the trajectory at |time|, which must be after the
+  // points previously processed.  If there is a node between the previous
+  // point and this one, and if |predicate| returns true for it, appends it to
+  // |ascending| or |descending|.
+  void Append(Instant const& time,
+              Sample const& degrees_of_freedom,
+              DiscreteTrajectory<Frame>& ascending,
+              DiscreteTrajectory<Frame>& descending);
+
+ private:
+  Vector<double, Frame> north_;
+  Predicate predicate_;
+  std::optional<Instant> previous_time_;
+  std::optional<DegreesOfFreedom<Frame>> previous_degrees_of_freedom_;
+};
+
+// The events (apsides or nodes) found by a |Detector| on a discrete trajectory
+// segment that is processed repeatedly, typically once per frame for
+// rendering.  As long as the segment only changes by the addition of points at
+// its end or the removal of points at its beginning, as is the case for a
+// prediction or a flight plan, each point is processed only once.  The
+// |first()| events are the apoapsides or the ascending nodes, the |second()|
+// events are the periapsides or the descending nodes.
+template<typename Frame, typename Detector>
+class IncrementalEvents final {
+ public:
+  using Sample = typename Detector::Sample;
+
+  IncrementalEvents();
+
+  // Brings the events up to date with the points of [begin, end[.  |sample|
+  // maps a point to the |Sample| to be given to the detector, or to nullopt if
+  // the point must not be processed (e.g., because it is outside of the time
+  // span of the reference).  The points are processed until both sets of
+  // events have at least |max_points| points.
+  // The events previously computed are reused if the last point processed is
+  // still in [begin, end[ with the same sample, and if |max_points| is
+  // unchanged; otherwise they are recomputed using a copy of |detector|.
+  template<typename Iterator, typename SampleFunction>
+  void Update(Iterator const& begin,
+              Iterator const& end,
+              int max_points,
+              Detector const& detector,
+              SampleFunction const& sample);
+
+  DiscreteTrajectory<Frame> const& first() const;
+  DiscreteTrajectory<Frame> const& second() const;
+
+ private:
+  std::optional<Detector> detector_;
+  int max_points_ = 0;
+  std::optional<Instant> last_time_;
+  std::optional<Sample> last_sample_;
+  not_null<std::unique_ptr<DiscreteTrajectory<Frame>>> first_;
+  not_null<std::unique_ptr<DiscreteTrajectory<Frame>>> second_;
+};
 
 // Computes the apsides with respect to |reference| for the discrete trajectory
 // segment given by |begin| and |end|.  Appends to the given trajectories one
@@ -53,8 +164,11 @@ void ComputeApsides(Trajectory<Frame> const& trajectory1,
 
 }  // namespace internal_apsides
 
+using internal_apsides::ApsisDetector;
 using internal_apsides::ComputeApsides;
 using internal_apsides::ComputeNodes;
+using internal_apsides::IncrementalEvents;
+using internal_apsides::NodeDetector;
 
 }  // namespace physics
 }  // namespace principia
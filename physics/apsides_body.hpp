@@ -3,10 +3,14 @@
 
 #include "physics/apsides.hpp"
 
+#include <memory>
 #include <optional>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "base/array.hpp"
+#include "numerics/hermite3.hpp"
 #include "numerics/root_finders.hpp"
 
 namespace principia {
@@ -14,6 +18,7 @@ namespace physics {
 namespace internal_apsides {
 
 using base::BoundedArray;
+using base::make_not_null_unique;
 using geometry::Barycentre;
 using geometry::Instant;
 using geometry::Position;
@@ -25,144 +30,152 @@ using quantities::Speed;
 using quantities::Square;
 using quantities::Variation;
 
+// The degrees of freedom at |time| of the Hermite interpolation between two
+// consecutive points of a trajectory.  This is the interpolation used by
+// |DiscreteTrajectory::EvaluateDegreesOfFreedom|.
 template<typename Frame>
-void ComputeApsides(Trajectory<Frame> const& reference,
-                    typename DiscreteTrajectory<Frame>::Iterator const begin,
-                    typename DiscreteTrajectory<Frame>::Iterator const end,
-                    int const max_points,
-                    DiscreteTrajectory<Frame>& apoapsides,
-                    DiscreteTrajectory<Frame>& periapsides) {
-  std::optional<Instant> previous_time;
-  std::optional<DegreesOfFreedom<Frame>> previous_degrees_of_freedom;
-  std::optional<Square<Length>> previous_squared_distance;
-  std::optional<Variation<Square<Length>>>
-      previous_squared_distance_derivative;
+DegreesOfFreedom<Frame> Interpolate(
+    Instant const& time1,
+    DegreesOfFreedom<Frame> const& degrees_of_freedom1,
+    Instant const& time2,
+    DegreesOfFreedom<Frame> const& degrees_of_freedom2,
+    Instant const& time) {
+  Hermite3<Instant, Position<Frame>> const interpolation(
+      {time1, time2},
+      {degrees_of_freedom1.position(), degrees_of_freedom2.position()},
+      {degrees_of_freedom1.velocity(), degrees_of_freedom2.velocity()});
+  return {interpolation.Evaluate(time), interpolation.EvaluateDerivative(time)};
+}
 
-  Instant const t_min = reference.t_min();
-  Instant const t_max = reference.t_max();
-  for (auto it = begin; it != end; ++it) {
-    auto const& [time, degrees_of_freedom] = *it;
-    if (time < t_min) {
-      continue;
-    }
-    if (time > t_max) {
-      break;
-    }
-    DegreesOfFreedom<Frame> const body_degrees_of_freedom =
-        reference.EvaluateDegreesOfFreedom(time);
-    RelativeDegreesOfFreedom<Frame> const relative =
-        degrees_of_freedom - body_degrees_of_freedom;
-    Square<Length> const squared_distance = relative.displacement().Norm²();
-    // This is the derivative of |squared_distance|.
-    Variation<Square<Length>> const squared_distance_derivative =
-        2.0 * InnerProduct(relative.displacement(), relative.velocity());
-
-    if (previous_squared_distance_derivative &&
-        Sign(squared_distance_derivative) !=
-            Sign(*previous_squared_distance_derivative)) {
-      CHECK(previous_time &&
-            previous_degrees_of_freedom &&
-            previous_squared_distance);
-
-      // The derivative of |squared_distance| changed sign.  Construct a Hermite
-      // approximation of |squared_distance| and find its extrema.
-      Hermite3<Instant, Square<Length>> const
-          squared_distance_approximation(
-              {*previous_time, time},
-              {*previous_squared_distance, squared_distance},
-              {*previous_squared_distance_derivative,
-               squared_distance_derivative});
-      BoundedArray<Instant, 2> const extrema =
-          squared_distance_approximation.FindExtrema();
-
-      // Now look at the extrema and check that exactly one is in the required
-      // time interval.  This is normally the case, but it can fail due to
-      // ill-conditioning.
-      Instant apsis_time;
-      int valid_extrema = 0;
-      for (auto const& extremum : extrema) {
-        if (extremum >= *previous_time && extremum <= time) {
-          apsis_time = extremum;
-          ++valid_extrema;
-        }
-      }
-      if (valid_extrema != 1) {
-        // Something went wrong when finding the extrema of
-        // |squared_distance_approximation|. Use a linear interpolation of
-        // |squared_distance_derivative| instead.
-        apsis_time = Barycentre<Instant, Variation<Square<Length>>>(
-            {time, *previous_time},
-            {*previous_squared_distance_derivative,
-             -squared_distance_derivative});
-      }
+template<typename Frame>
+bool ApsisDetector<Frame>::Sample::operator==(Sample const& right) const {
+  return degrees_of_freedom == right.degrees_of_freedom &&
+         reference_degrees_of_freedom == right.reference_degrees_of_freedom;
+}
 
-      // Now that we know the time of the apsis, use a Hermite approximation to
-      // derive its degrees of freedom.  Note that an extremum of
-      // |squared_distance_approximation| is in general not an extremum for
-      // |position_approximation|: the distance computed using the latter is a
-      // 6th-degree polynomial.  However, approximating this polynomial using a
-      // 3rd-degree polynomial would yield |squared_distance_approximation|, so
-      // we shouldn't be far from the truth.
-      DegreesOfFreedom<Frame> const apsis_degrees_of_freedom =
-          begin.trajectory()->EvaluateDegreesOfFreedom(apsis_time);
-      if (Sign(squared_distance_derivative).is_negative()) {
-        apoapsides.Append(apsis_time, apsis_degrees_of_freedom);
-      } else {
-        periapsides.Append(apsis_time, apsis_degrees_of_freedom);
-      }
-      if (apoapsides.Size() >= max_points && periapsides.Size() >= max_points) {
-        break;
+template<typename Frame>
+void ApsisDetector<Frame>::Append(Instant const& time,
+                                  Sample const& sample,
+                                  DiscreteTrajectory<Frame>& apoapsides,
+                                  DiscreteTrajectory<Frame>& periapsides) {
+  RelativeDegreesOfFreedom<Frame> const relative =
+      sample.degrees_of_freedom - sample.reference_degrees_of_freedom;
+  Square<Length> const squared_distance = relative.displacement().Norm²();
+  // This is the derivative of |squared_distance|.
+  Variation<Square<Length>> const squared_distance_derivative =
+      2.0 * InnerProduct(relative.displacement(), relative.velocity());
+
+  if (previous_squared_distance_derivative_ &&
+      Sign(squared_distance_derivative) !=
+          Sign(*previous_squared_distance_derivative_)) {
+    CHECK(previous_time_ &&
+          previous_degrees_of_freedom_ &&
+          previous_squared_distance_);
+
+    // The derivative of |squared_distance| changed sign.  Construct a Hermite
+    // approximation of |squared_distance| and find its extrema.
+    Hermite3<Instant, Square<Length>> const
+        squared_distance_approximation(
+            {*previous_time_, time},
+            {*previous_squared_distance_, squared_distance},
+            {*previous_squared_distance_derivative_,
+             squared_distance_derivative});
+    BoundedArray<Instant, 2> const extrema =
+        squared_distance_approximation.FindExtrema();
+
+    // Now look at the extrema and check that exactly one is in the required
+    // time interval.  This is normally the case, but it can fail due to
+    // ill-conditioning.
+    Instant apsis_time;
+    int valid_extrema = 0;
+    for (auto const& extremum : extrema) {
+      if (extremum >= *previous_time_ && extremum <= time) {
+        apsis_time = extremum;
+        ++valid_extrema;
       }
     }
+    if (valid_extrema != 1) {
+      // Something went wrong when finding the extrema of
+      // |squared_distance_approximation|. Use a linear interpolation of
+      // |squared_distance_derivative| instead.
+      apsis_time = Barycentre<Instant, Variation<Square<Length>>>(
+          {time, *previous_time_},
+          {*previous_squared_distance_derivative_,
+           -squared_distance_derivative});
+    }
 
-    previous_time = time;
-    previous_degrees_of_freedom = degrees_of_freedom;
-    previous_squared_distance = squared_distance;
-    previous_squared_distance_derivative = squared_distance_derivative;
+    // Now that we know the time of the apsis, use a Hermite approximation to
+    // derive its degrees of freedom.  Note that an extremum of
+    // |squared_distance_approximation| is in general not an extremum for
+    // |position_approximation|: the distance computed using the latter is a
+    // 6th-degree polynomial.  However, approximating this polynomial using a
+    // 3rd-degree polynomial would yield |squared_distance_approximation|, so
+    // we shouldn't be far from the truth.
+    DegreesOfFreedom<Frame> const apsis_degrees_of_freedom =
+        Interpolate(*previous_time_,
+                    *previous_degrees_of_freedom_,
+                    time,
+                    sample.degrees_of_freedom,
+                    apsis_time);
+    if (Sign(squared_distance_derivative).is_negative()) {
+      apoapsides.Append(apsis_time, apsis_degrees_of_freedom);
+    } else {
+      periapsides.Append(apsis_time, apsis_degrees_of_freedom);
+    }
   }
+
+  previous_time_ = time;
+  previous_degrees_of_freedom_ = sample.degrees_of_freedom;
+  previous_squared_distance_ = squared_distance;
+  previous_squared_distance_derivative_ = squared_distance_derivative;
 }
 
 template<typename Frame, typename Predicate>
-void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
-                  typename DiscreteTrajectory<Frame>::Iterator end,
-                  Vector<double, Frame> const& north,
-                  int const max_points,
-                  DiscreteTrajectory<Frame>& ascending,
-                  DiscreteTrajectory<Frame>& descending,
-                  Predicate predicate) {
+NodeDetector<Frame, Predicate>::NodeDetector(
+    Vector<double, Frame> const& north,
+    Predicate predicate)
+    : north_(north),
+      predicate_(std::move(predicate)) {
   static_assert(
-      std::is_convertible<decltype(predicate(
+      std::is_convertible<decltype(predicate_(
                               std::declval<DegreesOfFreedom<Frame>>())),
                           bool>::value,
       "|predicate| must be a predicate on |DegreesOfFreedom<Frame>|");
+}
 
-  std::optional<Instant> previous_time;
-  std::optional<Length> previous_z;
-  std::optional<Speed> previous_z_speed;
-
-  for (auto it = begin; it != end; ++it) {
-    auto const& [time, degrees_of_freedom] = *it;
-    Length const z =
-        (degrees_of_freedom.position() - Frame::origin).coordinates().z;
-    Speed const z_speed = degrees_of_freedom.velocity().coordinates().z;
+template<typename Frame, typename Predicate>
+void NodeDetector<Frame, Predicate>::Append(
+    Instant const& time,
+    Sample const& degrees_of_freedom,
+    DiscreteTrajectory<Frame>& ascending,
+    DiscreteTrajectory<Frame>& descending) {
+  Length const z =
+      (degrees_of_freedom.position() - Frame::origin).coordinates().z;
+  Speed const z_speed = degrees_of_freedom.velocity().coordinates().z;
 
-    if (previous_z && Sign(z) != Sign(*previous_z)) {
-      CHECK(previous_time && previous_z_speed);
+  if (previous_degrees_of_freedom_) {
+    CHECK(previous_time_);
+    Length const previous_z =
+        (previous_degrees_of_freedom_->position() - Frame::origin)
+            .coordinates().z;
+    Speed const previous_z_speed =
+        previous_degrees_of_freedom_->velocity().coordinates().z;
 
+    if (Sign(z) != Sign(previous_z)) {
       // |z| changed sign.  Construct a Hermite approximation of |z| and find
       // its zeros.
       Hermite3<Instant, Length> const z_approximation(
-          {*previous_time, time},
-          {*previous_z, z},
-          {*previous_z_speed, z_speed});
+          {*previous_time_, time},
+          {previous_z, z},
+          {previous_z_speed, z_speed});
 
       Instant node_time;
-      if (Sign(z_approximation.Evaluate(*previous_time)) ==
+      if (Sign(z_approximation.Evaluate(*previous_time_)) ==
           Sign(z_approximation.Evaluate(time))) {
         // The Hermite approximation is poorly conditioned, let's use a linear
         // approximation
-        node_time = Barycentre<Instant, Length>({*previous_time, time},
-                                                {z, -*previous_z});
+        node_time = Barycentre<Instant, Length>({*previous_time_, time},
+                                                {z, -previous_z});
       } else {
         // The normal case, find the intersection with z = 0 using bisection.
         // TODO(egg): Bisection on a polynomial seems daft; we should have
@@ -171,14 +184,18 @@ void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
             [&z_approximation](Instant const& t) {
               return z_approximation.Evaluate(t);
             },
-            *previous_time,
+            *previous_time_,
             time);
       }
 
       DegreesOfFreedom<Frame> const node_degrees_of_freedom =
-          begin.trajectory()->EvaluateDegreesOfFreedom(node_time);
-      if (predicate(node_degrees_of_freedom)) {
-        if (Sign(InnerProduct(north, Vector<double, Frame>({0, 0, 1}))) ==
+          Interpolate(*previous_time_,
+                      *previous_degrees_of_freedom_,
+                      time,
+                      degrees_of_freedom,
+                      node_time);
+      if (predicate_(node_degrees_of_freedom)) {
+        if (Sign(InnerProduct(north_, Vector<double, Frame>({0, 0, 1}))) ==
             Sign(z_speed)) {
           // |north| is up and we are going up, or |north| is down and we are
           // going down.
@@ -186,15 +203,142 @@ void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
         } else {
           descending.Append(node_time, node_degrees_of_freedom);
         }
-        if (ascending.Size() >= max_points && descending.Size() >= max_points) {
-          break;
-        }
       }
     }
+  }
+
+  previous_time_ = time;
+  previous_degrees_of_freedom_ = degrees_of_freedom;
+}
+
+template<typename Frame, typename Detector>
+IncrementalEvents<Frame, Detector>::IncrementalEvents()
+    : first_(make_not_null_unique<DiscreteTrajectory<Frame>>()),
+      second_(make_not_null_unique<DiscreteTrajectory<Frame>>()) {}
+
+template<typename Frame, typename Detector>
+template<typename Iterator, typename SampleFunction>
+void IncrementalEvents<Frame, Detector>::Update(
+    Iterator const& begin,
+    Iterator const& end,
+    int const max_points,
+    Detector const& detector,
+    SampleFunction const& sample) {
+  if (begin == end) {
+    detector_.reset();
+    last_time_.reset();
+    last_sample_.reset();
+    first_ = make_not_null_unique<DiscreteTrajectory<Frame>>();
+    second_ = make_not_null_unique<DiscreteTrajectory<Frame>>();
+    return;
+  }
+
+  // Find the point where to resume the computation.  The last point processed
+  // must still be in [begin, end[ and must not have changed: if it has, the
+  // trajectory has been recomputed and so must the events.
+  Instant const first_time = begin->time;
+  auto resume = begin;
+  bool reusable = false;
+  if (detector_.has_value() &&
+      last_time_.has_value() &&
+      max_points == max_points_ &&
+      *last_time_ >= first_time) {
+    auto const trajectory = begin.trajectory();
+    auto const last = trajectory->Find(*last_time_);
+    if (last != trajectory->end() &&
+        (end == trajectory->end() || last->time < end->time)) {
+      std::optional<Sample> const sample_at_last = sample(*last);
+      if (sample_at_last.has_value() && *sample_at_last == *last_sample_) {
+        resume = last;
+        ++resume;
+        reusable = true;
+      }
+    }
+  }
+  if (reusable) {
+    // The events before |first_time| would not be found by a computation that
+    // starts at |begin|.
+    first_->ForgetBefore(first_time);
+    second_->ForgetBefore(first_time);
+  } else {
+    detector_.emplace(detector);
+    max_points_ = max_points;
+    last_time_.reset();
+    last_sample_.reset();
+    first_ = make_not_null_unique<DiscreteTrajectory<Frame>>();
+    second_ = make_not_null_unique<DiscreteTrajectory<Frame>>();
+  }
+
+  for (auto it = resume; it != end; ++it) {
+    if (first_->Size() >= max_points && second_->Size() >= max_points) {
+      break;
+    }
+    std::optional<Sample> const sample_at_it = sample(*it);
+    if (!sample_at_it.has_value()) {
+      continue;
+    }
+    detector_->Append(it->time, *sample_at_it, *first_, *second_);
+    last_time_ = it->time;
+    last_sample_ = sample_at_it;
+  }
+}
+
+template<typename Frame, typename Detector>
+DiscreteTrajectory<Frame> const&
+IncrementalEvents<Frame, Detector>::first() const {
+  return *first_;
+}
+
+template<typename Frame, typename Detector>
+DiscreteTrajectory<Frame> const&
+IncrementalEvents<Frame, Detector>::second() const {
+  return *second_;
+}
+
+template<typename Frame>
+void ComputeApsides(Trajectory<Frame> const& reference,
+                    typename DiscreteTrajectory<Frame>::Iterator const begin,
+                    typename DiscreteTrajectory<Frame>::Iterator const end,
+                    int const max_points,
+                    DiscreteTrajectory<Frame>& apoapsides,
+                    DiscreteTrajectory<Frame>& periapsides) {
+  ApsisDetector<Frame> detector;
+  Instant const t_min = reference.t_min();
+  Instant const t_max = reference.t_max();
+  for (auto it = begin; it != end; ++it) {
+    auto const& [time, degrees_of_freedom] = *it;
+    if (time < t_min) {
+      continue;
+    }
+    if (time > t_max) {
+      break;
+    }
+    detector.Append(time,
+                    {degrees_of_freedom,
+                     reference.EvaluateDegreesOfFreedom(time)},
+                    apoapsides,
+                    periapsides);
+    if (apoapsides.Size() >= max_points && periapsides.Size() >= max_points) {
+      break;
+    }
+  }
+}
 
-    previous_time = time;
-    previous_z = z;
-    previous_z_speed = z_speed;
+template<typename Frame, typename Predicate>
+void ComputeNodes(typename DiscreteTrajectory<Frame>::Iterator begin,
+                  typename DiscreteTrajectory<Frame>::Iterator end,
+                  Vector<double, Frame> const& north,
+                  int const max_points,
+                  DiscreteTrajectory<Frame>& ascending,
+                  DiscreteTrajectory<Frame>& descending,
+                  Predicate predicate) {
+  NodeDetector<Frame, Predicate> detector(north, std::move(predicate));
+  for (auto it = begin; it != end; ++it) {
+    auto const& [time, degrees_of_freedom] = *it;
+    detector.Append(time, degrees_of_freedom, ascending, descending);
+    if (ascending.Size() >= max_points && descending.Size() >= max_points) {
+      break;
+    }
   }
 }
 
@@ -4,6 +4,7 @@
 #include <limits>
 #include <map>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -269,6 +270,133 @@ TEST_F(ApsidesTest, ComputeNodes) {
   }
 }
 
+TEST_F(ApsidesTest, IncrementalEvents) {
+  Instant const t0;
+  GravitationalParameter const μ = SolarGravitationalParameter;
+  auto const b = new MassiveBody(μ);
+
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<World>> initial_state;
+  bodies.emplace_back(std::unique_ptr<MassiveBody const>(b));
+  initial_state.emplace_back(World::origin, Velocity<World>());
+
+  Ephemeris<World> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Metre,
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<World>::FixedStepParameters(
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<World>>(),
+          10 * Minute));
+
+  KeplerianElements<World> elements;
+  elements.eccentricity = 0.25;
+  elements.semimajor_axis = 1 * AstronomicalUnit;
+  elements.inclination = 10 * Degree;
+  elements.longitude_of_ascending_node = 42 * Degree;
+  elements.argument_of_periapsis = 100 * Degree;
+  elements.mean_anomaly = 0 * Degree;
+  KeplerOrbit<World> const orbit{
+      *ephemeris.bodies()[0], MasslessBody{}, elements, t0};
+
+  DiscreteTrajectory<World> trajectory;
+  trajectory.Append(t0, initial_state[0] + orbit.StateVectors(t0));
+  auto const flow = [&ephemeris, &trajectory](Instant const& t_final,
+                                              Length const& tolerance) {
+    ephemeris.FlowWithAdaptiveStep(
+        &trajectory,
+        Ephemeris<World>::NoIntrinsicAcceleration,
+        t_final,
+        Ephemeris<World>::AdaptiveStepParameters(
+            EmbeddedExplicitRungeKuttaNyströmIntegrator<
+                DormandالمكاوىPrince1986RKN434FM,
+                Position<World>>(),
+            std::numeric_limits<std::int64_t>::max(),
+            tolerance,
+            tolerance / Second),
+        Ephemeris<World>::unlimited_max_ephemeris_steps);
+  };
+
+  auto const& reference = *ephemeris.trajectory(b);
+  auto const apsis_sample =
+      [&reference](DiscreteTrajectory<World>::Iterator::reference const point)
+      -> std::optional<ApsisDetector<World>::Sample> {
+    if (point.time < reference.t_min() || point.time > reference.t_max()) {
+      return std::nullopt;
+    }
+    return ApsisDetector<World>::Sample{
+        point.degrees_of_freedom,
+        reference.EvaluateDegreesOfFreedom(point.time)};
+  };
+  auto const node_sample =
+      [](DiscreteTrajectory<World>::Iterator::reference const point)
+      -> std::optional<DegreesOfFreedom<World>> {
+    return point.degrees_of_freedom;
+  };
+  Vector<double, World> const north({0, 0, 1});
+  int const max_points = std::numeric_limits<int>::max();
+
+  IncrementalEvents<World, ApsisDetector<World>> apsides;
+  IncrementalEvents<World, NodeDetector<World>> nodes;
+
+  // Checks that the incremental events are exactly those computed from
+  // scratch.
+  auto const check = [&]() {
+    apsides.Update(trajectory.begin(), trajectory.end(),
+                   max_points, ApsisDetector<World>(), apsis_sample);
+    nodes.Update(trajectory.begin(), trajectory.end(),
+                 max_points, NodeDetector<World>(north), node_sample);
+    DiscreteTrajectory<World> apoapsides;
+    DiscreteTrajectory<World> periapsides;
+    ComputeApsides(reference,
+                   trajectory.begin(),
+                   trajectory.end(),
+                   max_points,
+                   apoapsides,
+                   periapsides);
+    DiscreteTrajectory<World> ascending;
+    DiscreteTrajectory<World> descending;
+    ComputeNodes(trajectory.begin(),
+                 trajectory.end(),
+                 north,
+                 max_points,
+                 ascending,
+                 descending);
+    for (auto const& [expected, actual] :
+         {std::pair{&apoapsides, &apsides.first()},
+          std::pair{&periapsides, &apsides.second()},
+          std::pair{&ascending, &nodes.first()},
+          std::pair{&descending, &nodes.second()}}) {
+      EXPECT_LT(0, expected->Size());
+      ASSERT_EQ(expected->Size(), actual->Size());
+      for (auto expected_it = expected->begin(), actual_it = actual->begin();
+           expected_it != expected->end();
+           ++expected_it, ++actual_it) {
+        EXPECT_EQ(expected_it->time, actual_it->time);
+        EXPECT_EQ(expected_it->degrees_of_freedom,
+                  actual_it->degrees_of_freedom);
+      }
+    }
+  };
+
+  // Points appended at the end.
+  flow(t0 + 3 * JulianYear, 1e-3 * Metre);
+  check();
+  flow(t0 + 6 * JulianYear, 1e-3 * Metre);
+  check();
+
+  // Points removed at the beginning.
+  trajectory.ForgetBefore(t0 + 1.2 * JulianYear);
+  check();
+
+  // Points recomputed at the end: the events are recomputed.
+  trajectory.ForgetAfter(t0 + 4.5 * JulianYear);
+  flow(t0 + 8 * JulianYear, 1e-2 * Metre);
+  check();
+}
+
 #endif
 
 }  // namespace internal_apsides
@@ -70,6 +70,11 @@ class Checkpointer {
   // preserved across serialization/deserialization cycles.
   Instant WriteToMessage(not_null<Message*> message) const EXCLUDES(lock_);
 
+  // Same as |WriteToMessage|, but writes the newest checkpoint.  This is useful
+  // to serialize as much of the timeline as possible, e.g., for caching.
+  Instant WriteNewestToMessage(not_null<Message*> message) const
+      EXCLUDES(lock_);
+
   // Clears all the checkpoints in this checkpointer, and calls the |Reader|
   // passed at construction to reconstruct the object from |message|.  If the
   // |Reader| returns true (i.e., there was a checkpoint in the |message|),
@@ -53,6 +53,19 @@ Instant Checkpointer<Message>::WriteToMessage(
   }
 }
 
+template<typename Message>
+Instant Checkpointer<Message>::WriteNewestToMessage(
+    not_null<Message*> const message) const {
+  absl::ReaderMutexLock l(&lock_);
+  if (checkpoints_.empty()) {
+    static Instant infinite_future = Instant() + quantities::Infinity<Time>();
+    return infinite_future;
+  } else {
+    message->MergeFrom(checkpoints_.crbegin()->second);
+    return checkpoints_.crbegin()->first;
+  }
+}
+
 template<typename Message>
 void Checkpointer<Message>::ReadFromMessage(Instant const& t,
                                             Message const& message) {
@@ -102,5 +102,22 @@ TEST_F(CheckpointerTest, WriteToMessage) {
   EXPECT_EQ(t, checkpointer_.WriteToMessage(&m));
 }
 
+TEST_F(CheckpointerTest, WriteNewestToMessage) {
+  Instant const t1 = Instant() + 10 * Second;
+  Instant const t2 = t1 + 8 * Second;
+  Message m;
+
+  EXPECT_CALL(m, MergeFrom(_)).Times(0);
+  EXPECT_LT(t2 + 1000 * Second, checkpointer_.WriteNewestToMessage(&m));
+
+  EXPECT_CALL(writer_, Call(_)).Times(2);
+  checkpointer_.CreateUnconditionally(t1);
+  checkpointer_.CreateUnconditionally(t2);
+
+  EXPECT_CALL(m, MergeFrom(_)).Times(2);
+  EXPECT_EQ(t2, checkpointer_.WriteNewestToMessage(&m));
+  EXPECT_EQ(t1, checkpointer_.WriteToMessage(&m));
+}
+
 }  // namespace physics
 }  // namespace principia
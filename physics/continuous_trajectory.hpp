@@ -2,12 +2,17 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
+#include "base/rcu_pointer.hpp"
 #include "base/status.hpp"
 #include "geometry/named_quantities.hpp"
 #include "numerics/polynomial.hpp"
@@ -22,6 +27,7 @@ namespace physics {
 namespace internal_continuous_trajectory {
 
 using base::not_null;
+using base::RCUPointer;
 using base::Status;
 using geometry::Displacement;
 using geometry::Instant;
@@ -36,7 +42,9 @@ class TestableContinuousTrajectory;
 
 // This class is thread-safe, but the client must be aware that if, for
 // instance, the trajectory is appended to asynchronously, successive calls to
-// |t_max()| may return different values.
+// |t_max()| may return different values.  The functions that evaluate the
+// trajectory or its bounds don't lock, so they don't contend with each other or
+// with the writers.
 template<typename Frame>
 class ContinuousTrajectory : public Trajectory<Frame> {
  public:
@@ -91,6 +99,16 @@ class ContinuousTrajectory : public Trajectory<Frame> {
 
   void WriteToMessage(not_null<serialization::ContinuousTrajectory*> message)
       const EXCLUDES(lock_);
+
+  // Returns a function that writes this trajectory, as it is at the time of
+  // the call, to a message.  Taking the snapshot is cheap because it shares the
+  // immutable segments of this trajectory.  The function doesn't lock, and may
+  // be executed on any thread while this trajectory keeps changing, or after it
+  // has been destroyed.  The segments are written up to the oldest checkpoint,
+  // like |WriteToMessage| does, or up to the newest one if |newest_checkpoint|
+  // is true.
+  std::function<void(not_null<serialization::ContinuousTrajectory*>)>
+  MakeSnapshotWriter(bool newest_checkpoint) const EXCLUDES(lock_);
   template<typename F = Frame,
            typename = std::enable_if_t<base::is_serializable_v<F>>>
   static not_null<std::unique_ptr<ContinuousTrajectory>> ReadFromMessage(
@@ -111,21 +129,85 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   ContinuousTrajectory();
 
  private:
-  // Each polynomial is valid over an interval [t_min, t_max].  Polynomials are
-  // stored in this vector sorted by their |t_max|, as it turns out that we
-  // never need to extract their |t_min|.  Logically, the |t_min| for a
-  // polynomial is the |t_max| of the previous one.  The first polynomial has a
-  // |t_min| which is |*first_time_|.
-  struct InstantPolynomialPair {
-    InstantPolynomialPair(
-        Instant t_max,
+  // Each polynomial is valid over an interval [t_min, t_max].  Segments are
+  // sorted by their |t_max|, as it turns out that we never need to extract
+  // their |t_min|.  Logically, the |t_min| for a segment is the |t_max| of the
+  // previous one.  The first segment has a |t_min| which is |*first_time_|.
+  struct Segment {
+    Displacement<Frame> Evaluate(Instant const& time) const;
+    Velocity<Frame> EvaluateDerivative(Instant const& time) const;
+
+    Instant t_max;
+    // The polynomial lives in an |Arena|.  If |degree| is not 0, it is a
+    // |PolynomialInMonomialBasis| of that degree with an |EstrinEvaluator|,
+    // which we evaluate without a virtual call.  Otherwise it is some other
+    // kind of polynomial, e.g., one produced by a test.
+    Polynomial<Displacement<Frame>, Instant> const* polynomial;
+    int degree;
+  };
+
+  // The storage for the segments and their polynomials.  The coefficients of
+  // the polynomials are stored contiguously, next to each other, which makes
+  // evaluation cache-friendly.  An arena is append-only, and the segments that
+  // are visible through a published |Segments| are never modified, so they may
+  // be read without locking while the writer appends new ones.  When an arena
+  // is full, the live segments are copied to a new, larger one.
+  class Arena final {
+   public:
+    Arena(std::int64_t segment_capacity, std::int64_t byte_capacity);
+    ~Arena();
+
+    Arena(Arena const&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(Arena const&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+    // True iff a polynomial of any degree may be appended.
+    bool has_room() const;
+
+    Segment const* begin() const;
+    Segment const* end() const;
+
+    void Append(
+        Instant const& t_max,
         not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
             polynomial);
-    Instant t_max;
-    not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
-        polynomial;
+    // Appends a copy of |segment|, which lives in |arena|.
+    void Append(Segment const& segment, Arena const& arena);
+
+    // The number of bytes taken by the polynomial of |segment| in an arena.
+    static std::int64_t footprint(Segment const& segment);
+
+   private:
+    template<typename P>
+    P const* Emplace(P const& polynomial);
+
+    std::unique_ptr<Segment[]> const segments_;
+    std::int64_t const segment_capacity_;
+    std::int64_t size_ = 0;
+
+    std::unique_ptr<std::byte[]> const bytes_;
+    std::int64_t const byte_capacity_;
+    std::int64_t bytes_size_ = 0;
+
+    // The polynomials that are not stored in |bytes_|, indexed by address.
+    std::map<Polynomial<Displacement<Frame>, Instant> const*,
+             std::shared_ptr<Polynomial<Displacement<Frame>, Instant> const>>
+        foreign_polynomials_;
+  };
+
+  // An immutable view of the trajectory, published by the writers and read
+  // without locking.  It keeps alive the arena in which the segments live.
+  struct Segments {
+    bool empty() const;
+    Instant t_min() const;
+    Instant t_max() const;
+
+    std::shared_ptr<Arena const> arena;
+    Segment const* begin = nullptr;
+    Segment const* end = nullptr;
+    Instant first_time;
   };
-  using InstantPolynomialPairs = std::vector<InstantPolynomialPair>;
 
   Instant t_min_locked() const REQUIRES_SHARED(lock_);
   Instant t_max_locked() const REQUIRES_SHARED(lock_);
@@ -149,11 +231,45 @@ class ContinuousTrajectory : public Trajectory<Frame> {
       std::vector<Displacement<Frame>> const& q,
       std::vector<Velocity<Frame>> const& v) REQUIRES(lock_);
 
-  // Returns an iterator to the polynomial applicable for the given |time|, or
-  // |begin()| if |time| is before the first polynomial or |end()| if |time| is
-  // after the last polynomial.  Time complexity is O(N Log N).
-  typename InstantPolynomialPairs::const_iterator
-  FindPolynomialForInstant(Instant const& time) const REQUIRES_SHARED(lock_);
+  // Appends a segment to |arena_|, moving the live segments to a new arena if
+  // it is full, and publishes the result.
+  void AppendSegment(
+      Instant const& t_max,
+      not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
+          polynomial) REQUIRES(lock_);
+
+  // Copies the segments in [begin, end[ to a new arena which becomes |arena_|,
+  // and returns the new location of |begin|.  Doesn't publish anything.
+  Segment const* ReallocateArena(Segment const* begin, Segment const* end)
+      REQUIRES(lock_);
+
+  // Publishes the segments of |arena_| starting at |begin|.
+  void PublishSegments(Segment const* begin) REQUIRES(lock_);
+
+  // The segments currently published.  Only for use by the writers.
+  Segments const& segments_locked() const REQUIRES_SHARED(lock_);
+
+  // Returns the segment applicable for the given |time|, or |segments.begin|
+  // if |time| is before the first segment or |segments.end| if |time| is after
+  // the last segment.  |hint| is an index into |segments| which is tried
+  // first, and which is updated to point to the result.  Time complexity is
+  // O(1) if |hint| is correct, O(Log N) otherwise.
+  static Segment const* FindSegmentForInstant(Segments const& segments,
+                                              Instant const& time,
+                                              std::int64_t& hint);
+
+  // Lookups into the segments are expensive because they entail a binary
+  // search into an array that grows over time.  In benchmarks, this can be as
+  // costly as the polynomial evaluation itself.  The accesses are not random,
+  // though, they are clustered in time and (slowly) increasing.  To take
+  // advantage of this, each thread keeps track of the index of the last
+  // segment that it accessed in each trajectory.  This makes us O(1) instead
+  // of O(Log N) most of the time and it speeds up the lookup by a factor of 7.
+  // Since the hint is thread-local, threads that access different parts of the
+  // trajectory (e.g., the prognosticator and the main thread) don't thrash
+  // each other's hints and don't write to shared cache lines.  Any value is
+  // correct, the hint is validated before use.
+  std::int64_t& this_thread_hint() const;
 
   // Construction parameters;
   Time const step_;
@@ -172,30 +288,20 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   int degree_ GUARDED_BY(lock_);
   int degree_age_ GUARDED_BY(lock_);
 
-  // The polynomials are in increasing time order.
-  InstantPolynomialPairs polynomials_ GUARDED_BY(lock_);
+  // The arena to which the segments are appended.  Null for a trajectory that
+  // never had a segment.
+  std::shared_ptr<Arena> arena_ GUARDED_BY(lock_);
 
-  // Lookups into |polynomials_| are expensive because they entail a binary
-  // search into a vector that grows over time.  In benchmarks, this can be as
-  // costly as the polynomial evaluation itself.  The accesses are not random,
-  // though, they are clustered in time and (slowly) increasing.  To take
-  // advantage of this, we keep track of the index of the last accessed
-  // polynomial and first try to see if the new lookup is for the same
-  // polynomial.  This makes us O(1) instead of O(Log N) most of the time and it
-  // speeds up the lookup by a factor of 7.  This member is mutable to maintain
-  // the fiction that evaluation has no side effects.  In the presence of
-  // multithreading it may be that different threads would want to access
-  // polynomials at different indices, but by and large the threads progress in
-  // parallel, and benchmarks show that there is no adverse performance effects.
-  // Any value in the range of |polynomials_| or 0 is correct.
-  mutable std::int64_t last_accessed_polynomial_ GUARDED_BY(lock_) = 0;
+  // The segments, read without locking.  Each mutation of the trajectory
+  // publishes a new |Segments| object.  Never null.
+  RCUPointer<Segments> segments_;
 
   // The time at which this trajectory starts.  Set for a nonempty trajectory.
   std::optional<Instant> first_time_ GUARDED_BY(lock_);
 
   // The points that have not yet been incorporated in a polynomial.  Nonempty
   // for a nonempty trajectory.
-  // |last_points_.begin()->first == polynomials_.back().t_max|
+  // |last_points_.begin()->first == segments_.end[-1].t_max|
   std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> last_points_
       GUARDED_BY(lock_);
 
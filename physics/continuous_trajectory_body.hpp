@@ -4,9 +4,14 @@
 #include "physics/continuous_trajectory.hpp"
 
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <limits>
+#include <new>
 #include <optional>
 #include <sstream>
+#include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -25,6 +30,7 @@ namespace internal_continuous_trajectory {
 using base::Error;
 using base::make_not_null_unique;
 using numerics::EstrinEvaluator;
+using numerics::PolynomialInMonomialBasis;
 using numerics::ULPDistance;
 using numerics::ЧебышёвSeries;
 using quantities::DebugString;
@@ -39,6 +45,55 @@ int const max_degree_age = 100;
 // Only supports 8 divisions for now.
 int const divisions = 8;
 
+// The number of segments for which a new arena has room, in addition to the
+// live segments that it receives.
+std::int64_t const min_arena_capacity = 16;
+
+// The number of entries in the table of per-thread hints.  A prime, to spread
+// the addresses of the trajectories.
+int const hints_size = 61;
+
+// The polynomials produced by the Newhall approximation.
+template<typename Frame, int degree>
+using MonomialPolynomial = PolynomialInMonomialBasis<Displacement<Frame>,
+                                                     Instant,
+                                                     degree,
+                                                     EstrinEvaluator>;
+
+#define PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(degree) \
+  case (degree):                                            \
+    return f(std::integral_constant<int, (degree)>())
+
+// Calls |f| with an |std::integral_constant| for |degree| if it is a degree
+// produced by the Newhall approximation, and for 0 otherwise.  This makes it
+// possible to evaluate the polynomials without virtual calls.
+template<typename F>
+decltype(auto) DispatchOnDegree(int const degree, F const& f) {
+  static_assert(min_degree == 3 && max_degree == 17,
+                "Update the cases below");
+  switch (degree) {
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(3);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(4);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(5);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(6);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(7);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(8);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(9);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(10);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(11);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(12);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(13);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(14);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(15);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(16);
+    PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE(17);
+    default:
+      return f(std::integral_constant<int, 0>());
+  }
+}
+
+#undef PRINCIPIA_CONTINUOUS_TRAJECTORY_DEGREE_CASE
+
 template<typename Frame>
 Checkpointer<serialization::ContinuousTrajectory>::Reader
 MakeCheckpointerReader(ContinuousTrajectory<Frame>* const trajectory) {
@@ -67,25 +122,26 @@ ContinuousTrajectory<Frame>::ContinuousTrajectory(Time const& step,
       degree_(min_degree),
       degree_age_(0) {
   CHECK_LT(0 * Metre, tolerance_);
+  segments_.Publish(std::make_unique<Segments const>());
 }
 
 template<typename Frame>
 bool ContinuousTrajectory<Frame>::empty() const {
-  absl::ReaderMutexLock l(&lock_);
-  return polynomials_.empty();
+  typename RCUPointer<Segments>::ReadLock const segments(segments_);
+  return segments->empty();
 }
 
 template<typename Frame>
 double ContinuousTrajectory<Frame>::average_degree() const {
-  absl::ReaderMutexLock l(&lock_);
-  if (polynomials_.empty()) {
+  typename RCUPointer<Segments>::ReadLock const segments(segments_);
+  if (segments->empty()) {
     return 0;
   } else {
     double total = 0;
-    for (auto const& pair : polynomials_) {
-      total += pair.polynomial->degree();
+    for (Segment const* it = segments->begin; it != segments->end; ++it) {
+      total += it->polynomial->degree();
     }
-    return total / polynomials_.size();
+    return total / (segments->end - segments->begin);
   }
 }
 
@@ -143,96 +199,133 @@ void ContinuousTrajectory<Frame>::ForgetBefore(Instant const& time) {
   absl::MutexLock l(&lock_);
   if (time < t_min_locked()) {
     // TODO(phl): test for this case, it yielded a check failure in
-    // |FindPolynomialForInstant|.
+    // |FindSegmentForInstant|.
     return;
   }
 
-  polynomials_.erase(polynomials_.begin(), FindPolynomialForInstant(time));
+  Segments const& segments = segments_locked();
+  std::int64_t hint = 0;
+  Segment const* begin = FindSegmentForInstant(segments, time, hint);
+  Segment const* const end = segments.end;
 
-  // If there are no |polynomials_| left, clear everything.  Otherwise, update
-  // the first time.
-  if (polynomials_.empty()) {
+  // If there are no segments left, clear everything.  Otherwise, update the
+  // first time.
+  if (begin == end) {
     first_time_ = std::nullopt;
     last_points_.clear();
-    last_accessed_polynomial_ = 0;
+    arena_ = nullptr;
   } else {
     first_time_ = time;
-    last_accessed_polynomial_ = polynomials_.size() - 1;
+    // If most of the arena is forgotten, move the live segments to a smaller
+    // one to reclaim the memory.
+    if (begin - arena_->begin() > end - begin) {
+      begin = ReallocateArena(begin, end);
+    }
   }
+  PublishSegments(begin);
   checkpointer_.ForgetBefore(time);
 }
 
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_min() const {
-  absl::ReaderMutexLock l(&lock_);
-  return t_min_locked();
+  typename RCUPointer<Segments>::ReadLock const segments(segments_);
+  return segments->t_min();
 }
 
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_max() const {
-  absl::ReaderMutexLock l(&lock_);
-  return t_max_locked();
+  typename RCUPointer<Segments>::ReadLock const segments(segments_);
+  return segments->t_max();
 }
 
 template<typename Frame>
 Position<Frame> ContinuousTrajectory<Frame>::EvaluatePosition(
     Instant const& time) const {
-  absl::ReaderMutexLock l(&lock_);
-  CHECK_LE(t_min_locked(), time);
-  CHECK_GE(t_max_locked(), time);
-  auto const it = FindPolynomialForInstant(time);
-  CHECK(it != polynomials_.end());
-  auto const& polynomial = it->polynomial;
-  return polynomial->Evaluate(time) + Frame::origin;
+  typename RCUPointer<Segments>::ReadLock const segments(segments_);
+  CHECK_LE(segments->t_min(), time);
+  CHECK_GE(segments->t_max(), time);
+  Segment const* const it =
+      FindSegmentForInstant(*segments, time, this_thread_hint());
+  CHECK(it != segments->end);
+  return it->Evaluate(time) + Frame::origin;
 }
 
 template<typename Frame>
 Velocity<Frame> ContinuousTrajectory<Frame>::EvaluateVelocity(
     Instant const& time) const {
-  absl::ReaderMutexLock l(&lock_);
-  CHECK_LE(t_min_locked(), time);
-  CHECK_GE(t_max_locked(), time);
-  auto const it = FindPolynomialForInstant(time);
-  CHECK(it != polynomials_.end());
-  auto const& polynomial = it->polynomial;
-  return polynomial->EvaluateDerivative(time);
+  typename RCUPointer<Segments>::ReadLock const segments(segments_);
+  CHECK_LE(segments->t_min(), time);
+  CHECK_GE(segments->t_max(), time);
+  Segment const* const it =
+      FindSegmentForInstant(*segments, time, this_thread_hint());
+  CHECK(it != segments->end);
+  return it->EvaluateDerivative(time);
 }
 
 template<typename Frame>
 DegreesOfFreedom<Frame> ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedom(
     Instant const& time) const {
-  absl::ReaderMutexLock l(&lock_);
-  CHECK_LE(t_min_locked(), time);
-  CHECK_GE(t_max_locked(), time);
-  auto const it = FindPolynomialForInstant(time);
-  CHECK(it != polynomials_.end());
-  auto const& polynomial = it->polynomial;
-  return DegreesOfFreedom<Frame>(polynomial->Evaluate(time) + Frame::origin,
-                                 polynomial->EvaluateDerivative(time));
+  typename RCUPointer<Segments>::ReadLock const segments(segments_);
+  CHECK_LE(segments->t_min(), time);
+  CHECK_GE(segments->t_max(), time);
+  Segment const* const it =
+      FindSegmentForInstant(*segments, time, this_thread_hint());
+  CHECK(it != segments->end);
+  return DegreesOfFreedom<Frame>(it->Evaluate(time) + Frame::origin,
+                                 it->EvaluateDerivative(time));
 }
 
 template<typename Frame>
 void ContinuousTrajectory<Frame>::WriteToMessage(
       not_null<serialization::ContinuousTrajectory*> const message) const {
-  absl::ReaderMutexLock l(&lock_);
-  Instant const checkpoint_time =  checkpointer_.WriteToMessage(message);
-  checkpoint_time.WriteToMessage(message->mutable_checkpoint_time());
-  step_.WriteToMessage(message->mutable_step());
-  tolerance_.WriteToMessage(message->mutable_tolerance());
-  for (auto const& pair : polynomials_) {
-    Instant const& t_max = pair.t_max;
-    auto const& polynomial = pair.polynomial;
-    if (t_max <= checkpoint_time) {
-      auto* const pair = message->add_instant_polynomial_pair();
-      t_max.WriteToMessage(pair->mutable_t_max());
-      polynomial->WriteToMessage(pair->mutable_polynomial());
-    } else {
-      break;
-    }
-  }
-  if (first_time_) {
-    first_time_->WriteToMessage(message->mutable_first_time());
+  MakeSnapshotWriter(/*newest_checkpoint=*/false)(message);
+}
+
+template<typename Frame>
+std::function<void(not_null<serialization::ContinuousTrajectory*>)>
+ContinuousTrajectory<Frame>::MakeSnapshotWriter(
+    bool const newest_checkpoint) const {
+  // The checkpoint is small, so it is written now.  The segments, which are the
+  // bulk of the message, are written by the returned function.  They are kept
+  // alive by their arena, and they never change once published.
+  auto const checkpoint =
+      std::make_shared<serialization::ContinuousTrajectory>();
+  Instant checkpoint_time;
+  std::shared_ptr<Segments const> segments;
+  std::optional<Instant> first_time;
+  {
+    absl::ReaderMutexLock l(&lock_);
+    checkpoint_time =
+        newest_checkpoint
+            ? checkpointer_.WriteNewestToMessage(checkpoint.get())
+            : checkpointer_.WriteToMessage(checkpoint.get());
+    segments = std::make_shared<Segments const>(segments_locked());
+    first_time = first_time_;
   }
+  return [checkpoint,
+          checkpoint_time,
+          segments,
+          first_time,
+          step = step_,
+          tolerance = tolerance_](
+             not_null<serialization::ContinuousTrajectory*> const message) {
+    message->MergeFrom(*checkpoint);
+    checkpoint_time.WriteToMessage(message->mutable_checkpoint_time());
+    step.WriteToMessage(message->mutable_step());
+    tolerance.WriteToMessage(message->mutable_tolerance());
+    for (Segment const* it = segments->begin; it != segments->end; ++it) {
+      if (it->t_max <= checkpoint_time) {
+        auto* const pair = message->add_instant_polynomial_pair();
+        it->t_max.WriteToMessage(pair->mutable_t_max());
+        it->polynomial->WriteToMessage(pair->mutable_polynomial());
+      } else {
+        break;
+      }
+    }
+    if (first_time) {
+      first_time->WriteToMessage(message->mutable_first_time());
+    }
+  };
 }
 
 template<typename Frame>
@@ -247,40 +340,46 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
       std::make_unique<ContinuousTrajectory<Frame>>(
           Time::ReadFromMessage(message.step()),
           Length::ReadFromMessage(message.tolerance()));
-  if (is_pre_cohen) {
-    for (auto const& s : message.series()) {
-      // Read the series, evaluate it and use the resulting values to build a
-      // polynomial in the monomial basis.
-      auto const series =
-          ЧебышёвSeries<Displacement<Frame>>::ReadFromMessage(s);
-      Time const step = (series.t_max() - series.t_min()) / divisions;
-      Instant t = series.t_min();
-      std::vector<Displacement<Frame>> q;
-      std::vector<Velocity<Frame>> v;
-      for (int i = 0; i <= divisions; t += step, ++i) {
-        q.push_back(series.Evaluate(t));
-        v.push_back(series.EvaluateDerivative(t));
+  {
+    absl::MutexLock l(&continuous_trajectory->lock_);
+    if (is_pre_cohen) {
+      for (auto const& s : message.series()) {
+        // Read the series, evaluate it and use the resulting values to build a
+        // polynomial in the monomial basis.
+        auto const series =
+            ЧебышёвSeries<Displacement<Frame>>::ReadFromMessage(s);
+        Time const step = (series.t_max() - series.t_min()) / divisions;
+        Instant t = series.t_min();
+        std::vector<Displacement<Frame>> q;
+        std::vector<Velocity<Frame>> v;
+        for (int i = 0; i <= divisions; t += step, ++i) {
+          q.push_back(series.Evaluate(t));
+          v.push_back(series.EvaluateDerivative(t));
+        }
+        // Should we do something with this?
+        Displacement<Frame> error_estimate;
+        continuous_trajectory->AppendSegment(
+            series.t_max(),
+            continuous_trajectory->NewhallApproximationInMonomialBasis(
+                series.degree(),
+                q, v,
+                series.t_min(), series.t_max(),
+                error_estimate));
+      }
+    } else {
+      for (auto const& pair : message.instant_polynomial_pair()) {
+        continuous_trajectory->AppendSegment(
+            Instant::ReadFromMessage(pair.t_max()),
+            Polynomial<Displacement<Frame>, Instant>::template ReadFromMessage<
+                EstrinEvaluator>(pair.polynomial()));
       }
-      Displacement<Frame> error_estimate;  // Should we do something with this?
-      continuous_trajectory->polynomials_.emplace_back(
-          series.t_max(),
-          continuous_trajectory->NewhallApproximationInMonomialBasis(
-              series.degree(),
-              q, v,
-              series.t_min(), series.t_max(),
-              error_estimate));
     }
-  } else {
-    for (auto const& pair : message.instant_polynomial_pair()) {
-      continuous_trajectory->polynomials_.emplace_back(
-          Instant::ReadFromMessage(pair.t_max()),
-          Polynomial<Displacement<Frame>, Instant>::template ReadFromMessage<
-              EstrinEvaluator>(pair.polynomial()));
+    if (message.has_first_time()) {
+      continuous_trajectory->first_time_ =
+          Instant::ReadFromMessage(message.first_time());
     }
-  }
-  if (message.has_first_time()) {
-    continuous_trajectory->first_time_ =
-        Instant::ReadFromMessage(message.first_time());
+    continuous_trajectory->PublishSegments(
+        continuous_trajectory->segments_locked().begin);
   }
 
   Instant checkpoint_time;
@@ -293,7 +392,7 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
   continuous_trajectory->checkpointer_.ReadFromMessage(checkpoint_time,
                                                        message);
 
-    return continuous_trajectory;
+  return continuous_trajectory;
 }
 
 template<typename Frame>
@@ -343,25 +442,190 @@ bool ContinuousTrajectory<Frame>::ReadFromCheckpoint(
 
 template<typename Frame>
 ContinuousTrajectory<Frame>::ContinuousTrajectory()
-    : checkpointer_(/*reader=*/nullptr, /*writer=*/nullptr) {}
+    : checkpointer_(/*reader=*/nullptr, /*writer=*/nullptr) {
+  segments_.Publish(std::make_unique<Segments const>());
+}
+
+template<typename Frame>
+Displacement<Frame> ContinuousTrajectory<Frame>::Segment::Evaluate(
+    Instant const& time) const {
+  return DispatchOnDegree(
+      degree,
+      [this, &time](auto const degree_constant) -> Displacement<Frame> {
+        constexpr int d = std::decay_t<decltype(degree_constant)>::value;
+        if constexpr (d == 0) {
+          return polynomial->Evaluate(time);
+        } else {
+          using P = MonomialPolynomial<Frame, d>;
+          return static_cast<P const*>(polynomial)->P::Evaluate(time);
+        }
+      });
+}
 
 template<typename Frame>
-ContinuousTrajectory<Frame>::InstantPolynomialPair::InstantPolynomialPair(
-    Instant const t_max,
+Velocity<Frame> ContinuousTrajectory<Frame>::Segment::EvaluateDerivative(
+    Instant const& time) const {
+  return DispatchOnDegree(
+      degree,
+      [this, &time](auto const degree_constant) -> Velocity<Frame> {
+        constexpr int d = std::decay_t<decltype(degree_constant)>::value;
+        if constexpr (d == 0) {
+          return polynomial->EvaluateDerivative(time);
+        } else {
+          using P = MonomialPolynomial<Frame, d>;
+          return static_cast<P const*>(polynomial)->P::EvaluateDerivative(time);
+        }
+      });
+}
+
+template<typename Frame>
+ContinuousTrajectory<Frame>::Arena::Arena(std::int64_t const segment_capacity,
+                                          std::int64_t const byte_capacity)
+    : segments_(new Segment[segment_capacity]),
+      segment_capacity_(segment_capacity),
+      bytes_(new std::byte[byte_capacity]),
+      byte_capacity_(byte_capacity) {}
+
+template<typename Frame>
+ContinuousTrajectory<Frame>::Arena::~Arena() {
+  for (Segment const* it = begin(); it != end(); ++it) {
+    if (it->degree != 0) {
+      using P = Polynomial<Displacement<Frame>, Instant>;
+      it->polynomial->~P();
+    }
+  }
+}
+
+template<typename Frame>
+bool ContinuousTrajectory<Frame>::Arena::has_room() const {
+  return size_ < segment_capacity_ &&
+         bytes_size_ + footprint(Segment{Instant(), nullptr, max_degree}) <=
+             byte_capacity_;
+}
+
+template<typename Frame>
+typename ContinuousTrajectory<Frame>::Segment const*
+ContinuousTrajectory<Frame>::Arena::begin() const {
+  return segments_.get();
+}
+
+template<typename Frame>
+typename ContinuousTrajectory<Frame>::Segment const*
+ContinuousTrajectory<Frame>::Arena::end() const {
+  return segments_.get() + size_;
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::Arena::Append(
+    Instant const& t_max,
     not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
-        polynomial)
-    : t_max(t_max),
-      polynomial(std::move(polynomial)) {}
+        polynomial) {
+  CHECK_LT(size_, segment_capacity_);
+  Segment& segment = segments_[size_];
+  segment.t_max = t_max;
+  segment.degree = 0;
+  DispatchOnDegree(
+      polynomial->degree(),
+      [this, &polynomial, &segment](auto const degree_constant) {
+        constexpr int d = std::decay_t<decltype(degree_constant)>::value;
+        if constexpr (d != 0) {
+          using P = MonomialPolynomial<Frame, d>;
+          Polynomial<Displacement<Frame>, Instant> const& p = *polynomial;
+          if (typeid(p) == typeid(P)) {
+            segment.polynomial = Emplace(static_cast<P const&>(p));
+            segment.degree = d;
+          }
+        }
+      });
+  if (segment.degree == 0) {
+    Polynomial<Displacement<Frame>, Instant>* const released =
+        polynomial.release();
+    std::shared_ptr<Polynomial<Displacement<Frame>, Instant> const> foreign(
+        released);
+    segment.polynomial = released;
+    foreign_polynomials_.emplace(released, std::move(foreign));
+  }
+  ++size_;
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::Arena::Append(Segment const& segment,
+                                                Arena const& arena) {
+  CHECK_LT(size_, segment_capacity_);
+  Segment& copy = segments_[size_];
+  copy = segment;
+  DispatchOnDegree(
+      segment.degree,
+      [this, &arena, &copy](auto const degree_constant) {
+        constexpr int d = std::decay_t<decltype(degree_constant)>::value;
+        if constexpr (d == 0) {
+          foreign_polynomials_.emplace(
+              copy.polynomial, arena.foreign_polynomials_.at(copy.polynomial));
+        } else {
+          using P = MonomialPolynomial<Frame, d>;
+          copy.polynomial = Emplace(*static_cast<P const*>(copy.polynomial));
+        }
+      });
+  ++size_;
+}
+
+template<typename Frame>
+std::int64_t ContinuousTrajectory<Frame>::Arena::footprint(
+    Segment const& segment) {
+  return DispatchOnDegree(
+      segment.degree,
+      [](auto const degree_constant) -> std::int64_t {
+        constexpr int d = std::decay_t<decltype(degree_constant)>::value;
+        if constexpr (d == 0) {
+          return 0;
+        } else {
+          using P = MonomialPolynomial<Frame, d>;
+          // Account for the worst-case padding.
+          return sizeof(P) + alignof(P) - 1;
+        }
+      });
+}
+
+template<typename Frame>
+template<typename P>
+P const* ContinuousTrajectory<Frame>::Arena::Emplace(P const& polynomial) {
+  static_assert(alignof(P) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                "Insufficient alignment of the arena");
+  std::int64_t const offset =
+      (bytes_size_ + alignof(P) - 1) / alignof(P) * alignof(P);
+  CHECK_LE(offset + static_cast<std::int64_t>(sizeof(P)), byte_capacity_);
+  P const* const emplaced = new (&bytes_[offset]) P(polynomial);
+  bytes_size_ = offset + sizeof(P);
+  return emplaced;
+}
+
+template<typename Frame>
+bool ContinuousTrajectory<Frame>::Segments::empty() const {
+  return begin == end;
+}
+
+template<typename Frame>
+Instant ContinuousTrajectory<Frame>::Segments::t_min() const {
+  if (empty()) {
+    return astronomy::InfiniteFuture;
+  }
+  return first_time;
+}
+
+template<typename Frame>
+Instant ContinuousTrajectory<Frame>::Segments::t_max() const {
+  if (empty()) {
+    return astronomy::InfinitePast;
+  }
+  return std::prev(end)->t_max;
+}
 
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_min_locked() const {
 #if defined(_DEBUG)
   lock_.AssertReaderHeld();
 #endif
-  if (polynomials_.empty()) {
-    return astronomy::InfiniteFuture;
-  }
-  return *first_time_;
+  return segments_locked().t_min();
 }
 
 template<typename Frame>
@@ -369,10 +633,7 @@ Instant ContinuousTrajectory<Frame>::t_max_locked() const {
 #if defined(_DEBUG)
   lock_.AssertReaderHeld();
 #endif
-  if (polynomials_.empty()) {
-    return astronomy::InfinitePast;
-  }
-  return polynomials_.crbegin()->t_max;
+  return segments_locked().t_max();
 }
 
 template<typename Frame>
@@ -412,12 +673,12 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
 
   // Compute the approximation with the current degree.
   Displacement<Frame> displacement_error_estimate;
-  polynomials_.emplace_back(time,
-                            NewhallApproximationInMonomialBasis(
-                                degree_,
-                                q, v,
-                                last_points_.cbegin()->first, time,
-                                displacement_error_estimate));
+  not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
+      polynomial = NewhallApproximationInMonomialBasis(
+                       degree_,
+                       q, v,
+                       last_points_.cbegin()->first, time,
+                       displacement_error_estimate);
 
   // Estimate the error.  For initializing |previous_error_estimate|, any value
   // greater than |error_estimate| will do.
@@ -449,11 +710,11 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
     ++degree_;
     VLOG(1) << "Increasing degree for " << this << " to " <<degree_
             << " because error estimate was " << error_estimate;
-    polynomials_.back().polynomial = NewhallApproximationInMonomialBasis(
-                                         degree_,
-                                         q, v,
-                                         last_points_.cbegin()->first, time,
-                                         displacement_error_estimate);
+    polynomial = NewhallApproximationInMonomialBasis(
+                     degree_,
+                     q, v,
+                     last_points_.cbegin()->first, time,
+                     displacement_error_estimate);
     previous_error_estimate = error_estimate;
     error_estimate = displacement_error_estimate.Norm();
   }
@@ -478,6 +739,8 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
 
   ++degree_age_;
 
+  AppendSegment(time, std::move(polynomial));
+
   // Check that the tolerance did not explode.
   if (adjusted_tolerance_ < 1e6 * previous_adjusted_tolerance) {
     return Status::OK;
@@ -495,35 +758,108 @@ Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
 }
 
 template<typename Frame>
-typename ContinuousTrajectory<Frame>::InstantPolynomialPairs::const_iterator
-ContinuousTrajectory<Frame>::FindPolynomialForInstant(
-    Instant const& time) const {
-#if defined(_DEBUG)
-  lock_.AssertReaderHeld();
-#endif
-  // This returns the first polynomial |p| such that |time <= p.t_max|.
+void ContinuousTrajectory<Frame>::AppendSegment(
+    Instant const& t_max,
+    not_null<std::unique_ptr<Polynomial<Displacement<Frame>, Instant>>>
+        polynomial) {
+  lock_.AssertHeld();
+  Segments const& segments = segments_locked();
+  Segment const* begin = segments.begin;
+  if (arena_ == nullptr || !arena_->has_room()) {
+    begin = ReallocateArena(begin, segments.end);
+  }
+  arena_->Append(t_max, std::move(polynomial));
+  PublishSegments(begin);
+}
+
+template<typename Frame>
+typename ContinuousTrajectory<Frame>::Segment const*
+ContinuousTrajectory<Frame>::ReallocateArena(Segment const* const begin,
+                                             Segment const* const end) {
+  lock_.AssertHeld();
+  std::int64_t const size = end - begin;
+  std::int64_t footprint = 0;
+  for (Segment const* it = begin; it != end; ++it) {
+    footprint += Arena::footprint(*it);
+  }
+  // Leave as much room as we use, so that the cost of the copies is amortized.
+  auto const max_footprint =
+      Arena::footprint(Segment{Instant(), nullptr, max_degree});
+  auto arena = std::make_shared<Arena>(
+      /*segment_capacity=*/2 * size + min_arena_capacity,
+      /*byte_capacity=*/2 * footprint + min_arena_capacity * max_footprint);
+  for (Segment const* it = begin; it != end; ++it) {
+    arena->Append(*it, *arena_);
+  }
+  arena_ = std::move(arena);
+  return arena_->begin();
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::PublishSegments(Segment const* const begin) {
+  lock_.AssertHeld();
+  auto segments = std::make_unique<Segments>();
+  if (arena_ != nullptr && begin != arena_->end()) {
+    segments->arena = arena_;
+    segments->begin = begin;
+    segments->end = arena_->end();
+    segments->first_time = first_time_.value_or(Instant());
+  }
+  segments_.Publish(std::move(segments));
+}
+
+template<typename Frame>
+typename ContinuousTrajectory<Frame>::Segments const&
+ContinuousTrajectory<Frame>::segments_locked() const {
+  return *segments_.writer_get();
+}
+
+template<typename Frame>
+typename ContinuousTrajectory<Frame>::Segment const*
+ContinuousTrajectory<Frame>::FindSegmentForInstant(Segments const& segments,
+                                                   Instant const& time,
+                                                   std::int64_t& hint) {
+  // This returns the first segment |s| such that |time <= s.t_max|.
   {
-    auto const begin = polynomials_.begin();
-    auto const it = begin + last_accessed_polynomial_;
-    if (it != polynomials_.end() && time <= it->t_max &&
-        (it == begin || std::prev(it)->t_max < time)) {
-      return it;
+    if (0 <= hint && hint < segments.end - segments.begin) {
+      Segment const* const it = segments.begin + hint;
+      if (time <= it->t_max &&
+          (it == segments.begin || std::prev(it)->t_max < time)) {
+        return it;
+      }
     }
   }
   {
-    auto const it =
-        std::lower_bound(polynomials_.begin(),
-                         polynomials_.end(),
+    Segment const* const it =
+        std::lower_bound(segments.begin,
+                         segments.end,
                          time,
-                         [](InstantPolynomialPair const& left,
-                            Instant const& right) {
+                         [](Segment const& left, Instant const& right) {
                            return left.t_max < right;
                          });
-    last_accessed_polynomial_ = it - polynomials_.begin();
+    hint = it - segments.begin;
     return it;
   }
 }
 
+template<typename Frame>
+std::int64_t& ContinuousTrajectory<Frame>::this_thread_hint() const {
+  struct Hint {
+    ContinuousTrajectory const* trajectory = nullptr;
+    std::int64_t index = 0;
+  };
+  // A direct-mapped table indexed by the address of the trajectory.  A
+  // collision merely results in a lookup without a hint.
+  thread_local std::array<Hint, hints_size> hints;
+  Hint& hint = hints[std::hash<ContinuousTrajectory const*>()(this) %
+                     hints_size];
+  if (hint.trajectory != this) {
+    hint.trajectory = this;
+    hint.index = 0;
+  }
+  return hint.index;
+}
+
 }  // namespace internal_continuous_trajectory
 }  // namespace physics
 }  // namespace principia
@@ -2,9 +2,12 @@
 #include "physics/continuous_trajectory.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <limits>
+#include <random>
+#include <thread>
 #include <vector>
 
 #include "geometry/frame.hpp"
@@ -811,6 +814,198 @@ TEST_F(ContinuousTrajectoryTest, Checkpoint) {
   }
 }
 
+// Check that a snapshot writer is not affected by the changes made to the
+// trajectory after it was created.
+TEST_F(ContinuousTrajectoryTest, SnapshotWriter) {
+  int const number_of_steps1 = 30;
+  int const number_of_steps2 = 20;
+  Time const step = 0.01 * Second;
+  Length const tolerance = 0.1 * Metre;
+
+  auto position_function =
+      [this](Instant const t) {
+        return World::origin +
+            Displacement<World>({(t - t0_) * 3 * Metre / Second,
+                                 (t - t0_) * 5 * Metre / Second,
+                                 (t - t0_) * (-2) * Metre / Second});
+      };
+  auto velocity_function =
+      [](Instant const t) {
+        return Velocity<World>({3 * Metre / Second,
+                                5 * Metre / Second,
+                                -2 * Metre / Second});
+      };
+
+  auto trajectory = std::make_unique<ContinuousTrajectory<World>>(
+                        step, tolerance);
+  FillTrajectory(number_of_steps1,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 *trajectory);
+  trajectory->checkpointer().CreateUnconditionally(trajectory->t_max());
+
+  serialization::ContinuousTrajectory expected_message;
+  trajectory->WriteToMessage(&expected_message);
+  auto const writer =
+      trajectory->MakeSnapshotWriter(/*newest_checkpoint=*/false);
+
+  // Change the trajectory in all possible ways, and destroy it.
+  FillTrajectory(number_of_steps2,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_ + number_of_steps1 * step,
+                 *trajectory);
+  trajectory->checkpointer().CreateUnconditionally(trajectory->t_max());
+  trajectory->ForgetBefore(t0_ + number_of_steps1 * step);
+  trajectory.reset();
+
+  serialization::ContinuousTrajectory actual_message;
+  writer(&actual_message);
+  EXPECT_THAT(actual_message, EqualsProto(expected_message));
+}
+
+// Check that a snapshot may extend to the newest checkpoint, and that the
+// trajectory read from it doesn't need to be prolonged.
+TEST_F(ContinuousTrajectoryTest, NewestCheckpoint) {
+  int const number_of_steps1 = 30;
+  int const number_of_steps2 = 20;
+  Time const step = 0.01 * Second;
+  Length const tolerance = 0.1 * Metre;
+
+  auto position_function =
+      [this](Instant const t) {
+        return World::origin +
+            Displacement<World>({(t - t0_) * 3 * Metre / Second,
+                                 (t - t0_) * 5 * Metre / Second,
+                                 (t - t0_) * (-2) * Metre / Second});
+      };
+  auto velocity_function =
+      [](Instant const t) {
+        return Velocity<World>({3 * Metre / Second,
+                                5 * Metre / Second,
+                                -2 * Metre / Second});
+      };
+
+  auto const trajectory = std::make_unique<ContinuousTrajectory<World>>(
+                              step, tolerance);
+  FillTrajectory(number_of_steps1,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 *trajectory);
+  Instant const t1 = trajectory->t_max();
+  trajectory->checkpointer().CreateUnconditionally(t1);
+  FillTrajectory(number_of_steps2,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_ + number_of_steps1 * step,
+                 *trajectory);
+  Instant const t2 = trajectory->t_max();
+  trajectory->checkpointer().CreateUnconditionally(t2);
+
+  serialization::ContinuousTrajectory oldest_message;
+  trajectory->MakeSnapshotWriter(/*newest_checkpoint=*/false)(&oldest_message);
+  serialization::ContinuousTrajectory newest_message;
+  trajectory->MakeSnapshotWriter(/*newest_checkpoint=*/true)(&newest_message);
+  EXPECT_EQ(t1, Instant::ReadFromMessage(oldest_message.checkpoint_time()));
+  EXPECT_EQ(t2, Instant::ReadFromMessage(newest_message.checkpoint_time()));
+  EXPECT_LT(oldest_message.instant_polynomial_pair_size(),
+            newest_message.instant_polynomial_pair_size());
+
+  auto const oldest_trajectory =
+      ContinuousTrajectory<World>::ReadFromMessage(oldest_message);
+  EXPECT_EQ(t1, oldest_trajectory->t_max());
+  auto const newest_trajectory =
+      ContinuousTrajectory<World>::ReadFromMessage(newest_message);
+  EXPECT_EQ(t2, newest_trajectory->t_max());
+  EXPECT_EQ(trajectory->EvaluateDegreesOfFreedom(t2),
+            newest_trajectory->EvaluateDegreesOfFreedom(t2));
+}
+
+// Check that the trajectory may be evaluated without locking while another
+// thread appends to it and forgets its beginning, which moves the segments
+// around.
+TEST_F(ContinuousTrajectoryTest, ConcurrentEvaluation) {
+  int const number_of_steps = 20'000;
+  int const number_of_readers = 4;
+  Time const step = 0.01 * Second;
+  // The writer never forgets past this time.
+  Instant const safe_time = t0_ + (number_of_steps / 2) * step;
+
+  auto position_function =
+      [this](Instant const t) {
+        return World::origin +
+            Displacement<World>({(t - t0_) * 3 * Metre / Second,
+                                 (t - t0_) * 5 * Metre / Second,
+                                 (t - t0_) * (-2) * Metre / Second});
+      };
+  auto velocity_function =
+      [](Instant const t) {
+        return Velocity<World>({3 * Metre / Second,
+                                5 * Metre / Second,
+                                -2 * Metre / Second});
+      };
+
+  auto const trajectory = std::make_unique<ContinuousTrajectory<World>>(
+                              step,
+                              /*tolerance=*/0.1 * Metre);
+
+  std::atomic_bool done = false;
+  std::vector<Length> max_errors(number_of_readers);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < number_of_readers; ++i) {
+    readers.emplace_back([i,
+                          &done,
+                          &max_errors,
+                          &position_function,
+                          safe_time,
+                          &trajectory]() {
+      std::mt19937_64 random(i);
+      std::uniform_real_distribution<> distribution(0.0, 1.0);
+      while (!done) {
+        Instant const t_max = trajectory->t_max();
+        if (t_max < safe_time) {
+          continue;
+        }
+        Instant const time =
+            safe_time + distribution(random) * (t_max - safe_time);
+        max_errors[i] = std::max(
+            max_errors[i],
+            AbsoluteError(position_function(time),
+                          trajectory->EvaluatePosition(time)));
+      }
+    });
+  }
+
+  for (int i = 0; i < number_of_steps; ++i) {
+    Instant const ti = t0_ + (i + 1) * step;
+    trajectory->Append(ti,
+                       DegreesOfFreedom<World>(position_function(ti),
+                                               velocity_function(ti)));
+    Instant const forget_before_time = trajectory->t_max() - 100 * step;
+    if (forget_before_time < safe_time) {
+      trajectory->ForgetBefore(forget_before_time);
+    }
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  for (Length const& max_error : max_errors) {
+    EXPECT_LT(max_error, 1 * Milli(Metre));
+  }
+  EXPECT_LT(trajectory->t_min(), safe_time);
+  EXPECT_THAT(trajectory->EvaluatePosition(safe_time) - World::origin,
+              AlmostEquals(position_function(safe_time) - World::origin,
+                           0, 11));
+}
+
 }  // namespace internal_continuous_trajectory
 }  // namespace physics
 }  // namespace principia
@@ -3,7 +3,6 @@
 
 #include <functional>
 #include <list>
-#include <map>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -15,6 +14,7 @@
 #include "numerics/hermite3.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/forkable.hpp"
+#include "physics/timeline.hpp"
 #include "physics/trajectory.hpp"
 #include "quantities/named_quantities.hpp"
 #include "serialization/physics.pb.h"
@@ -33,8 +33,7 @@ using base::not_constructible;
 
 template<typename Frame>
 struct ForkableTraits<DiscreteTrajectory<Frame>> : not_constructible {
-  using TimelineConstIterator =
-      typename std::map<Instant, DegreesOfFreedom<Frame>>::const_iterator;
+  using TimelineConstIterator = typename Timeline<Frame>::const_iterator;
   static Instant const& time(TimelineConstIterator it);
 };
 
@@ -75,7 +74,7 @@ template<typename Frame>
 class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
                                            DiscreteTrajectoryIterator<Frame>>,
                            public Trajectory<Frame> {
-  using Timeline = std::map<Instant, DegreesOfFreedom<Frame>>;
+  using Timeline = physics::Timeline<Frame>;
   using TimelineConstIterator = typename Forkable<
       DiscreteTrajectory<Frame>,
       DiscreteTrajectoryIterator<Frame>>::TimelineConstIterator;
@@ -145,6 +144,11 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
   // trajectory are going to be retained.
   void ClearDownsampling();
 
+  // The points of this trajectory at or before the returned time are never
+  // removed by downsampling.  This is the time of the last point if the
+  // trajectory is not downsampling.  This trajectory must be a nonempty root.
+  Instant FirstDenseTime() const;
+
   // Implementation of the interface |Trajectory|.
 
   // The bounds are the times of |begin()| and |rbegin()| if this trajectory is
@@ -159,12 +163,35 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
 
   // End of the implementation of the interface.
 
+  // Starts maintaining the level of detail of the points of this trajectory
+  // and of its ancestors.  This costs memory and time on each insertion, so it
+  // should only be done for the trajectories that get plotted.  Forks created
+  // afterwards don't inherit the level of detail.
+  void EnableLevelOfDetail();
+
+  // Calls |f| on the points of a subsequence of the points of this trajectory
+  // whose times are in [first_time, last_time], chosen by
+  // |TrajectoryPyramid::ForEachPoint| with the given |acceptable| predicate.
+  // The points of the ancestors of this trajectory are included.  The cost is
+  // logarithmic in the number of points for each call to |f| on the
+  // trajectories for which the level of detail is enabled, so this is suitable
+  // for plotting long trajectories at a coarse resolution.  On the other
+  // trajectories, |f| is called on all the points.
+  template<typename Acceptable, typename F>
+  void ForEachLevelOfDetailPoint(Instant const& first_time,
+                                 Instant const& last_time,
+                                 Acceptable const& acceptable,
+                                 F const& f) const;
+
   // This trajectory must be a root.  Only the given |forks| are serialized.
   // They must be descended from this trajectory.  The pointers in |forks| may
-  // be null at entry.
+  // be null at entry.  If |only_last_point| is true, the timeline of this
+  // trajectory is reduced to its last point, but the forks and the
+  // downsampling state are written in full.
   void WriteToMessage(
       not_null<serialization::DiscreteTrajectory*> message,
-      std::vector<DiscreteTrajectory<Frame>*> const& forks) const;
+      std::vector<DiscreteTrajectory<Frame>*> const& forks,
+      bool only_last_point = false) const;
 
   // |forks| must have a size appropriate for the |message| being deserialized
   // and the orders of the |forks| must be consistent during serialization and
@@ -242,10 +269,12 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
     std::int64_t dense_intervals_;
   };
 
-  // This trajectory need not be a root.
+  // This trajectory need not be a root.  |only_last_point| only applies to
+  // the timeline of this trajectory, not to that of its descendants.
   void WriteSubTreeToMessage(
       not_null<serialization::DiscreteTrajectory*> message,
-      std::vector<DiscreteTrajectory<Frame>*>& forks) const;
+      std::vector<DiscreteTrajectory<Frame>*>& forks,
+      bool only_last_point) const;
 
   void FillSubTreeFromMessage(
       serialization::DiscreteTrajectory const& message,
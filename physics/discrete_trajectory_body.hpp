@@ -4,8 +4,8 @@
 #include "physics/discrete_trajectory.hpp"
 
 #include <algorithm>
+#include <iterator>
 #include <list>
-#include <map>
 #include <vector>
 
 #include "astronomy/epoch.hpp"
@@ -73,7 +73,9 @@ DiscreteTrajectory<Frame>::NewForkWithCopy(Instant const& time) {
 
   // Copy the tail of the trajectory in the child object.
   if (timeline_it != timeline_.end()) {
-    fork->timeline_.insert(++timeline_it, timeline_.end());
+    for (++timeline_it; timeline_it != timeline_.end(); ++timeline_it) {
+      fork->timeline_.emplace_back(timeline_it->first, timeline_it->second);
+    }
   }
   return fork;
 }
@@ -131,9 +133,8 @@ void DiscreteTrajectory<Frame>::AttachFork(
   // This ensures that |fork| and this trajectory start and end, respectively,
   // with points at the same time (but possibly distinct degrees of freedom).
   if (must_prepend) {
-    fork_timeline.emplace_hint(fork_timeline.begin(),
-                               this_last->time,
-                               this_last->degrees_of_freedom);
+    fork_timeline.emplace_front(this_last->time,
+                                this_last->degrees_of_freedom);
   }
 
   // Attach |fork| to this trajectory.
@@ -144,7 +145,7 @@ void DiscreteTrajectory<Frame>::AttachFork(
   // (because we "trust" this trajectory more than |fork|).  The children that
   // might have been forked at the deleted point were relocated by
   // AttachForkToCopiedBegin.
-  fork_timeline.erase(fork_timeline.begin());
+  fork_timeline.erase(fork_timeline.begin(), ++fork_timeline.begin());
 }
 
 template<typename Frame>
@@ -155,9 +156,7 @@ DiscreteTrajectory<Frame>::DetachFork() {
   // Insert a new point in the timeline for the fork time.  It should go at the
   // beginning of the timeline.
   auto const fork_it = this->Fork();
-  auto const begin_it = timeline_.emplace_hint(
-      timeline_.begin(), fork_it->time, fork_it->degrees_of_freedom);
-  CHECK(begin_it == timeline_.begin());
+  timeline_.emplace_front(fork_it->time, fork_it->degrees_of_freedom);
 
   // Detach this trajectory and tell the caller that it owns the pieces.
   return this->DetachForkWithCopiedBegin();
@@ -177,13 +176,11 @@ void DiscreteTrajectory<Frame>::Append(
                  << this->back().time << "]";
     return;
   }
-  auto it = timeline_.emplace_hint(timeline_.end(),
-                                   time,
-                                   degrees_of_freedom);
-  // Decrementing |end()| is much faster than incrementing |it|.  Don't ask.
-  CHECK(--timeline_.end() == it)
-      << "Append out of order at " << time << ", last time is "
-      << (--timeline_.end())->first;
+  if (!timeline_.empty() && timeline_.back().first == time) {
+    // Appending at the last time is a no-op.
+    return;
+  }
+  timeline_.emplace_back(time, degrees_of_freedom);
   if (downsampling_.has_value()) {
     if (timeline_.size() == 1) {
       downsampling_->SetStartOfDenseTimeline(timeline_.begin(), timeline_);
@@ -209,11 +206,31 @@ void DiscreteTrajectory<Frame>::Append(
         if (right_endpoints.empty()) {
           right_endpoints.push_back(dense_iterators.end() - 1);
         }
-        TimelineConstIterator left = downsampling_->start_of_dense_timeline();
-        for (const auto& it_in_dense_iterators : right_endpoints) {
-          TimelineConstIterator const right = *it_in_dense_iterators;
-          timeline_.erase(++left, right);
-          left = right;
+        // The timeline may only be erased at its ends, so we copy the points
+        // that we keep, i.e., the right endpoints and the points that follow
+        // the last of them, truncate the timeline after the start of the dense
+        // timeline, and append the copies.  No fork may reference the
+        // truncated points.
+        std::vector<typename Timeline::value_type> right_points;
+        std::vector<typename Timeline::value_type> trailing_points;
+        for (auto const& it_in_dense_iterators : right_endpoints) {
+          right_points.push_back(**it_in_dense_iterators);
+        }
+        for (auto it = std::next(right_endpoints.back());
+             it != dense_iterators.cend();
+             ++it) {
+          trailing_points.push_back(**it);
+        }
+        timeline_.erase(std::next(downsampling_->start_of_dense_timeline()),
+                        timeline_.end());
+        TimelineConstIterator left;
+        for (auto const& [right_time, right_degrees_of_freedom] :
+                 right_points) {
+          left = timeline_.emplace_back(right_time, right_degrees_of_freedom);
+        }
+        for (auto const& [trailing_time, trailing_degrees_of_freedom] :
+                 trailing_points) {
+          timeline_.emplace_back(trailing_time, trailing_degrees_of_freedom);
         }
         downsampling_->SetStartOfDenseTimeline(left, timeline_);
       }
@@ -281,6 +298,17 @@ void DiscreteTrajectory<Frame>::SetDownsampling(
   downsampling_.emplace(
       max_dense_intervals, tolerance, timeline_.begin(), timeline_);
 }
+template<typename Frame>
+Instant DiscreteTrajectory<Frame>::FirstDenseTime() const {
+  CHECK(this->is_root());
+  CHECK(!timeline_.empty());
+  if (downsampling_.has_value()) {
+    return downsampling_->first_dense_time();
+  } else {
+    return timeline_.back().first;
+  }
+}
+
 template<typename Frame>
 void DiscreteTrajectory<Frame>::ClearDownsampling() {
   downsampling_.reset();
@@ -315,15 +343,62 @@ DegreesOfFreedom<Frame> DiscreteTrajectory<Frame>::EvaluateDegreesOfFreedom(
   return {interpolation.Evaluate(time), interpolation.EvaluateDerivative(time)};
 }
 
+template<typename Frame>
+void DiscreteTrajectory<Frame>::EnableLevelOfDetail() {
+  for (DiscreteTrajectory* ancestor = this;; ancestor = ancestor->parent()) {
+    ancestor->timeline_.EnablePyramid();
+    if (ancestor->is_root()) {
+      break;
+    }
+  }
+}
+
+template<typename Frame>
+template<typename Acceptable, typename F>
+void DiscreteTrajectory<Frame>::ForEachLevelOfDetailPoint(
+    Instant const& first_time,
+    Instant const& last_time,
+    Acceptable const& acceptable,
+    F const& f) const {
+  std::vector<DiscreteTrajectory const*> ancestry;
+  for (DiscreteTrajectory const* ancestor = this;;
+       ancestor = ancestor->parent()) {
+    ancestry.push_back(ancestor);
+    if (ancestor->is_root()) {
+      break;
+    }
+  }
+  // The timeline of an ancestor contains the points after its own fork time;
+  // the points of its child come after the fork time of the child.
+  for (auto it = ancestry.rbegin(); it != ancestry.rend(); ++it) {
+    auto const child = std::next(it);
+    Instant const ancestor_last_time =
+        child == ancestry.rend() ? last_time
+                                 : std::min(last_time, (*child)->Fork()->time);
+    auto const* const pyramid = (*it)->timeline_.pyramid();
+    if (pyramid == nullptr) {
+      auto const& timeline = (*it)->timeline_;
+      for (auto point = timeline.lower_bound(first_time);
+           point != timeline.end() && point->first <= ancestor_last_time;
+           ++point) {
+        f(typename TrajectoryPyramid<Frame>::Point{
+            point->first, point->second.position()});
+      }
+    } else {
+      pyramid->ForEachPoint(first_time, ancestor_last_time, acceptable, f);
+    }
+  }
+}
+
 template<typename Frame>
 void DiscreteTrajectory<Frame>::WriteToMessage(
     not_null<serialization::DiscreteTrajectory*> const message,
-    std::vector<DiscreteTrajectory<Frame>*> const& forks)
-    const {
+    std::vector<DiscreteTrajectory<Frame>*> const& forks,
+    bool const only_last_point) const {
   CHECK(this->is_root());
 
   std::vector<DiscreteTrajectory<Frame>*> mutable_forks = forks;
-  WriteSubTreeToMessage(message, mutable_forks);
+  WriteSubTreeToMessage(message, mutable_forks, only_last_point);
   CHECK(std::all_of(mutable_forks.begin(),
                     mutable_forks.end(),
                     [](DiscreteTrajectory<Frame>* const fork) {
@@ -492,9 +567,14 @@ DiscreteTrajectory<Frame>::Downsampling::ReadFromMessage(
 template<typename Frame>
 void DiscreteTrajectory<Frame>::WriteSubTreeToMessage(
     not_null<serialization::DiscreteTrajectory*> const message,
-    std::vector<DiscreteTrajectory<Frame>*>& forks) const {
+    std::vector<DiscreteTrajectory<Frame>*>& forks,
+    bool const only_last_point) const {
   Forkable<DiscreteTrajectory, Iterator>::WriteSubTreeToMessage(message, forks);
-  for (auto const& [instant, degrees_of_freedom] : timeline_) {
+  auto const first_written =
+      only_last_point && !timeline_.empty() ? std::prev(timeline_.end())
+                                            : timeline_.begin();
+  for (auto it = first_written; it != timeline_.end(); ++it) {
+    auto const& [instant, degrees_of_freedom] = *it;
     auto const instantaneous_degrees_of_freedom = message->add_timeline();
     instant.WriteToMessage(instantaneous_degrees_of_freedom->mutable_instant());
     degrees_of_freedom.WriteToMessage(
@@ -775,6 +775,45 @@ TEST_F(DiscreteTrajectoryTest, TrajectorySerializationSuccess) {
       Eq(d4_));
 }
 
+TEST_F(DiscreteTrajectoryTest, TrajectorySerializationLastPoint) {
+  massive_trajectory_->SetDownsampling(/*max_dense_intervals=*/50,
+                                       /*tolerance=*/1 * Milli(Metre));
+  massive_trajectory_->Append(t1_, d1_);
+  massive_trajectory_->Append(t2_, d2_);
+  massive_trajectory_->Append(t3_, d3_);
+  not_null<DiscreteTrajectory<World>*> const fork =
+      massive_trajectory_->NewForkWithCopy(t3_);
+  fork->Append(t4_, d4_);
+  serialization::DiscreteTrajectory full_message;
+  serialization::DiscreteTrajectory message;
+  massive_trajectory_->WriteToMessage(&full_message, {fork});
+  massive_trajectory_->WriteToMessage(&message,
+                                      {fork},
+                                      /*only_last_point=*/true);
+
+  // Only the timeline of the root is truncated.
+  EXPECT_THAT(message.timeline_size(), Eq(1));
+  EXPECT_THAT(message.timeline(0), EqualsProto(full_message.timeline(2)));
+  EXPECT_THAT(message.downsampling(),
+              EqualsProto(full_message.downsampling()));
+  EXPECT_THAT(message.children_size(), Eq(1));
+  EXPECT_THAT(message.children(0), EqualsProto(full_message.children(0)));
+
+  // The dense timeline must start within the truncated timeline for the
+  // message to be readable.
+  *message.mutable_downsampling()->mutable_start_of_dense_timeline() =
+      message.timeline(0).instant();
+  DiscreteTrajectory<World>* deserialized_fork = nullptr;
+  not_null<std::unique_ptr<DiscreteTrajectory<World>>> const
+      deserialized_trajectory =
+          DiscreteTrajectory<World>::ReadFromMessage(message,
+                                                     {&deserialized_fork});
+  EXPECT_EQ(t3_, deserialized_trajectory->front().time);
+  EXPECT_EQ(t3_, deserialized_trajectory->back().time);
+  EXPECT_EQ(t3_, deserialized_fork->Fork()->time);
+  EXPECT_EQ(t4_, deserialized_fork->back().time);
+}
+
 TEST_F(DiscreteTrajectoryDeathTest, LastError) {
   EXPECT_DEATH({
     massive_trajectory_->back();
@@ -903,6 +942,18 @@ TEST_F(DiscreteTrajectoryTest, Downsampling) {
   EXPECT_THAT(errors, Each(Lt(1 * Milli(Metre))));
   EXPECT_THAT(errors, Contains(Gt(9 * Micro(Metre))))
       << *std::max_element(errors.begin(), errors.end());
+
+  // Only the points after the first dense time may still be downsampled.
+  EXPECT_EQ(circle.back().time, circle.FirstDenseTime());
+  Instant const first_dense_time = downsampled_circle.FirstDenseTime();
+  EXPECT_LT(downsampled_circle.front().time, first_dense_time);
+  int dense_points = 0;
+  for (auto it = downsampled_circle.Find(first_dense_time);
+       it != downsampled_circle.end();
+       ++it) {
+    ++dense_points;
+  }
+  EXPECT_LE(dense_points, 51);
 }
 
 TEST_F(DiscreteTrajectoryTest, DownsamplingSerialization) {
@@ -997,6 +1048,45 @@ TEST_F(DiscreteTrajectoryTest, DownsamplingForgetAfter) {
   EXPECT_THAT(errors, Each(Eq(0 * Metre)));
 }
 
+TEST_F(DiscreteTrajectoryTest, LevelOfDetail) {
+  massive_trajectory_->Append(t1_, d1_);
+  massive_trajectory_->Append(t2_, d2_);
+  massive_trajectory_->Append(t3_, d3_);
+  not_null<DiscreteTrajectory<World>*> const fork =
+      massive_trajectory_->NewForkWithoutCopy(t2_);
+  fork->Append(t4_, d4_);
+
+  // The times of the points returned by |ForEachLevelOfDetailPoint|, either
+  // accepting all the chords or none.
+  auto const times = [this](DiscreteTrajectory<World> const& trajectory,
+                            bool const accept) {
+    std::vector<Instant> result;
+    trajectory.ForEachLevelOfDetailPoint(
+        t0_,
+        t4_ + 1 * Second,
+        [accept](auto const&, auto const&, Length const&) {
+          return accept;
+        },
+        [&result](auto const& point) { result.push_back(point.time); });
+    return result;
+  };
+
+  // Without a level of detail, all the points are returned.
+  EXPECT_THAT(times(*massive_trajectory_, /*accept=*/true),
+              ElementsAre(t1_, t2_, t3_));
+  EXPECT_THAT(times(*fork, /*accept=*/true), ElementsAre(t1_, t2_, t4_));
+
+  // Enabling the level of detail of the fork enables it for its parent.
+  fork->EnableLevelOfDetail();
+  EXPECT_THAT(times(*massive_trajectory_, /*accept=*/false),
+              ElementsAre(t1_, t2_, t3_));
+  EXPECT_THAT(times(*massive_trajectory_, /*accept=*/true),
+              ElementsAre(t1_, t3_));
+  // The points of the root after the fork time are not part of the fork.
+  EXPECT_THAT(times(*fork, /*accept=*/false), ElementsAre(t1_, t2_, t4_));
+  EXPECT_THAT(times(*fork, /*accept=*/true), ElementsAre(t1_, t2_, t4_));
+}
+
 }  // namespace internal_discrete_trajectory
 }  // namespace physics
 }  // namespace principia
@@ -21,6 +21,7 @@
 #include "physics/discrete_trajectory.hpp"
 #include "physics/geopotential.hpp"
 #include "physics/massive_body.hpp"
+#include "physics/n_body_kernel.hpp"
 #include "physics/oblate_body.hpp"
 #include "physics/protector.hpp"
 #include "serialization/ksp_plugin.pb.h"
@@ -277,6 +278,11 @@ class Ephemeris {
 
   virtual void WriteToMessage(
       not_null<serialization::Ephemeris*> message) const EXCLUDES(lock_);
+  // Same as |WriteToMessage|, but the trajectories are written up to the newest
+  // checkpoint.  The message is larger, but an ephemeris read from it covers
+  // more time without being prolonged.  This is used to cache the ephemeris.
+  void WriteToMessageUpToNewestCheckpoint(
+      not_null<serialization::Ephemeris*> message) const EXCLUDES(lock_);
   template<typename F = Frame,
            typename = std::enable_if_t<base::is_serializable_v<F>>>
   static not_null<std::unique_ptr<Ephemeris>> ReadFromMessage(
@@ -308,6 +314,8 @@ class Ephemeris {
 
  private:
   // Checkpointing support.
+  void WriteToMessage(not_null<serialization::Ephemeris*> message,
+                      bool newest_checkpoint) const EXCLUDES(lock_);
   void WriteToCheckpoint(not_null<serialization::Ephemeris*> message);
   template<typename F = Frame,
            typename = std::enable_if_t<base::is_serializable_v<F>>>
@@ -424,6 +432,12 @@ class Ephemeris {
   int number_of_oblate_bodies_ = 0;
   int number_of_spherical_bodies_ = 0;
 
+  // The structure-of-arrays copy of the spherical bodies used by
+  // |ComputeMassiveBodiesGravitationalAccelerations|, sized at construction to
+  // avoid allocating for each evaluation.  It is only used by the integration
+  // of the massive bodies, which runs with |lock_| held exclusively.
+  mutable NBodyArrays n_body_arrays_{/*size=*/0};
+
   not_null<
       std::unique_ptr<Checkpointer<serialization::Ephemeris>>> checkpointer_;
   not_null<std::unique_ptr<Protector>> protector_;
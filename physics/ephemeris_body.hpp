@@ -53,6 +53,7 @@ using quantities::Abs;
 using quantities::Exponentiation;
 using quantities::GravitationalParameter;
 using quantities::Quotient;
+using quantities::SIUnit;
 using quantities::Sqrt;
 using quantities::Square;
 using quantities::Time;
@@ -295,6 +296,7 @@ Ephemeris<Frame>::Ephemeris(
       ++number_of_spherical_bodies_;
     }
   }
+  n_body_arrays_ = NBodyArrays(number_of_spherical_bodies_);
 
   absl::ReaderMutexLock l(&lock_);  // For locking checks.
   instance_ = fixed_step_parameters_.integrator_->NewInstance(
@@ -704,13 +706,44 @@ not_null<MassiveBody const*> Ephemeris<Frame>::body_for_serialization_index(
 template<typename Frame>
 void Ephemeris<Frame>::WriteToMessage(
     not_null<serialization::Ephemeris*> const message) const {
+  WriteToMessage(message, /*newest_checkpoint=*/false);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::WriteToMessageUpToNewestCheckpoint(
+    not_null<serialization::Ephemeris*> const message) const {
+  WriteToMessage(message, /*newest_checkpoint=*/true);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::WriteToMessage(
+    not_null<serialization::Ephemeris*> const message,
+    bool const newest_checkpoint) const {
   LOG(INFO) << __FUNCTION__;
-  absl::ReaderMutexLock l(&lock_);
 
-  // Make sure that a checkpoint exists, otherwise we would not serialize some
-  // parts of the state.
-  CreateCheckpointIfNeeded(instance_->time().value);
-  Instant const checkpoint_time = checkpointer_->WriteToMessage(message);
+  // The checkpoints and the snapshots of the trajectories are taken under the
+  // lock, so that they are consistent.  The trajectories, which are the bulk
+  // of the message, are written without holding the lock, so that we don't
+  // block |Prolong| for long.
+  Instant checkpoint_time;
+  std::vector<
+      std::function<void(not_null<serialization::ContinuousTrajectory*>)>>
+      trajectory_writers;
+  {
+    absl::ReaderMutexLock l(&lock_);
+
+    // Make sure that a checkpoint exists, otherwise we would not serialize some
+    // parts of the state.
+    CreateCheckpointIfNeeded(instance_->time().value);
+    // The trajectories have checkpoints at the same times as the ephemeris.
+    checkpoint_time = newest_checkpoint
+                          ? checkpointer_->WriteNewestToMessage(message)
+                          : checkpointer_->WriteToMessage(message);
+    for (auto const& trajectory : trajectories_) {
+      trajectory_writers.push_back(
+          trajectory->MakeSnapshotWriter(newest_checkpoint));
+    }
+  }
   checkpoint_time.WriteToMessage(message->mutable_checkpoint_time());
 
   // The bodies are serialized in the order in which they were given at
@@ -720,8 +753,8 @@ void Ephemeris<Frame>::WriteToMessage(
   }
   // The trajectories are serialized in the order resulting from the separation
   // between oblate and spherical bodies.
-  for (auto const& trajectory : trajectories_) {
-    trajectory->WriteToMessage(message->add_trajectory());
+  for (auto const& trajectory_writer : trajectory_writers) {
+    trajectory_writer(message->add_trajectory());
   }
   fixed_step_parameters_.WriteToMessage(
       message->mutable_fixed_step_parameters());
@@ -1103,20 +1136,36 @@ void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerations(
         /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
         positions, accelerations, geopotentials_);
   }
-  for (std::size_t b1 = number_of_oblate_bodies_;
-       b1 < number_of_oblate_bodies_ +
-            number_of_spherical_bodies_;
-       ++b1) {
-    MassiveBody const& body1 = *bodies_[b1];
-    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
-        /*body1_is_oblate=*/false,
-        /*body2_is_oblate=*/false>(
-        t,
-        body1, b1,
-        /*bodies2=*/bodies_,
-        /*b2_begin=*/b1 + 1,
-        /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
-        positions, accelerations, geopotentials_);
+
+  // The interactions between spherical bodies are purely Newtonian, so they
+  // are computed by a vectorized kernel working on a structure-of-arrays copy
+  // of the positions and accelerations of the spherical bodies.  The kernel
+  // gives the same results as
+  // |ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies|.
+  NBodyArrays& arrays = n_body_arrays_;
+  for (int i = 0; i < number_of_spherical_bodies_; ++i) {
+    int const b = number_of_oblate_bodies_ + i;
+    auto const position = (positions[b] - Frame::origin).coordinates();
+    auto const acceleration = accelerations[b].coordinates();
+    arrays.x[i] = position.x / Metre;
+    arrays.y[i] = position.y / Metre;
+    arrays.z[i] = position.z / Metre;
+    arrays.μ[i] = bodies_[b]->gravitational_parameter() /
+                  SIUnit<GravitationalParameter>();
+    arrays.ax[i] = acceleration.x / SIUnit<Acceleration>();
+    arrays.ay[i] = acceleration.y / SIUnit<Acceleration>();
+    arrays.az[i] = acceleration.z / SIUnit<Acceleration>();
+  }
+  AccumulateNewtonianAccelerations(/*b1_begin=*/0,
+                                   /*b_end=*/number_of_spherical_bodies_,
+                                   arrays,
+                                   FastestNBodyKernel());
+  for (int i = 0; i < number_of_spherical_bodies_; ++i) {
+    int const b = number_of_oblate_bodies_ + i;
+    accelerations[b] = Vector<Acceleration, Frame>(
+        {arrays.ax[i] * SIUnit<Acceleration>(),
+         arrays.ay[i] * SIUnit<Acceleration>(),
+         arrays.az[i] * SIUnit<Acceleration>()});
   }
 }
 
@@ -703,6 +703,51 @@ TEST_P(EphemerisTest, Serialization) {
   EXPECT_THAT(message, EqualsProto(second_message));
 }
 
+TEST_P(EphemerisTest, SerializationUpToNewestCheckpoint) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  MassiveBody const* const earth = bodies[0].get();
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/5 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+  // Long enough to have several checkpoints.
+  ephemeris.Prolong(t0_ + 10 * period);
+
+  serialization::Ephemeris oldest_message;
+  ephemeris.WriteToMessage(&oldest_message);
+  serialization::Ephemeris newest_message;
+  ephemeris.WriteToMessageUpToNewestCheckpoint(&newest_message);
+  Instant const oldest_checkpoint_time =
+      Instant::ReadFromMessage(oldest_message.checkpoint_time());
+  Instant const newest_checkpoint_time =
+      Instant::ReadFromMessage(newest_message.checkpoint_time());
+  EXPECT_LT(oldest_checkpoint_time, newest_checkpoint_time);
+
+  // The ephemeris read from the newest checkpoint covers that checkpoint
+  // without being prolonged, and it continues exactly like the original one.
+  auto const ephemeris_read = Ephemeris<ICRS>::ReadFromMessage(newest_message);
+  MassiveBody const* const earth_read = ephemeris_read->bodies()[0];
+  EXPECT_EQ(ephemeris.t_min(), ephemeris_read->t_min());
+  EXPECT_LE(newest_checkpoint_time, ephemeris_read->t_max());
+  ephemeris_read->Prolong(ephemeris.t_max());
+  for (Instant time = ephemeris.t_min();
+       time <= ephemeris.t_max();
+       time += (ephemeris.t_max() - ephemeris.t_min()) / 100) {
+    EXPECT_EQ(
+        ephemeris.trajectory(earth)->EvaluateDegreesOfFreedom(time),
+        ephemeris_read->trajectory(earth_read)->EvaluateDegreesOfFreedom(time));
+  }
+}
+
 // The gravitational acceleration on an elephant located at the pole.
 TEST_P(EphemerisTest, ComputeGravitationalAccelerationMasslessBody) {
   Time const duration = 1 * Second;
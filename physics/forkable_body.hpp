@@ -465,7 +465,9 @@ void Forkable<Tr4jectory, It3rator>::WriteSubTreeToMessage(
       litter = message->add_children();
       fork_time.WriteToMessage(litter->mutable_fork_time());
     }
-    child->WriteSubTreeToMessage(litter->add_trajectories(), forks);
+    child->WriteSubTreeToMessage(litter->add_trajectories(),
+                                 forks,
+                                 /*only_last_point=*/false);
   }
 }
 
@@ -118,6 +118,18 @@ class Geopotential {
   // Holds precomputed data for one evaluation of the acceleration.
   struct Precomputations;
 
+  // The space around the body is partitioned in spherical shells in which the
+  // same harmonics contribute to the acceleration.  A shell extends from the
+  // |outer_radius| of the previous shell (or 0) to its own |outer_radius|,
+  // excluded.  The acceleration in a shell is computed by the kernel
+  // specialized for |max_degree|, restricted to the zonal harmonics if
+  // |is_zonal|.
+  struct Shell {
+    Length outer_radius;
+    int max_degree;
+    bool is_zonal;
+  };
+
   // Helper templates for iterating over the degrees/orders of the geopotential.
   template<int degree, int order>
   struct DegreeNOrderM;
@@ -126,6 +138,9 @@ class Geopotential {
   template<typename>
   struct AllDegrees;
 
+  // The shell that contains the distance |r_norm|, which must not be NaN.
+  Shell const& FindShell(Length const& r_norm) const;
+
   // If z is a unit vector along the axis of rotation, and r a vector from the
   // center of |body_| to some point in space, the acceleration computed here
   // is:
@@ -160,6 +175,10 @@ class Geopotential {
   //   degree_damping[2] ≼ sectoral_damping_ ≼ degree_damping[3]
   // holds, where ≼ denotes the ordering of the thresholds.
   HarmonicDamping sectoral_damping_;
+
+  // The shells, sorted by increasing |outer_radius|.  The last one extends to
+  // infinity, and its |max_degree| is 1.
+  std::vector<Shell> shells_;
 };
 
 }  // namespace internal_geopotential
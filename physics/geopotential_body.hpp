@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <queue>
 #include <vector>
 
@@ -149,6 +150,7 @@ template<typename Frame>
 template<int... degrees>
 struct Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>> {
   static auto Acceleration(Geopotential<Frame> const& geopotential,
+                           Shell const& shell,
                            Instant const& t,
                            Displacement<Frame> const& r,
                            Length const& r_norm,
@@ -396,6 +398,7 @@ template<typename Frame>
 template<int... degrees>
 auto Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>>::
 Acceleration(Geopotential<Frame> const& geopotential,
+             Shell const& shell,
              Instant const& t,
              Displacement<Frame> const& r,
              Length const& r_norm,
@@ -404,9 +407,7 @@ Acceleration(Geopotential<Frame> const& geopotential,
     -> Vector<ReducedAcceleration, Frame> {
   constexpr int size = sizeof...(degrees);
   OblateBody<Frame> const& body = *geopotential.body_;
-  const bool is_zonal =
-      body.is_zonal() ||
-      r_norm > geopotential.sectoral_damping_.outer_threshold();
+  bool const is_zonal = shell.is_zonal;
 
   Precomputations precomputations;
 
@@ -439,7 +440,7 @@ Acceleration(Geopotential<Frame> const& geopotential,
     ŷ = body.biequatorial();
   } else {
     auto const from_surface_frame =
-      body.template FromSurfaceFrame<SurfaceFrame>(t);
+        body.template FromSurfaceFrame<SurfaceFrame>(t);
     x̂ = from_surface_frame(x_);
     ŷ = from_surface_frame(y_);
   }
@@ -568,6 +569,41 @@ Geopotential<Frame>::Geopotential(not_null<OblateBody<Frame> const*> body,
     }
     harmonic_thresholds.pop();
   }
+
+  // The boundaries of the shells are the outer thresholds.  Since the
+  // thresholds of degrees 0 and 1 are infinite, the last shell extends to
+  // infinity.
+  std::vector<Length> outer_radii;
+  for (auto const& damping : degree_damping_) {
+    outer_radii.push_back(damping.outer_threshold());
+  }
+  outer_radii.push_back(sectoral_damping_.outer_threshold());
+  std::sort(outer_radii.begin(), outer_radii.end());
+  outer_radii.erase(std::unique(outer_radii.begin(), outer_radii.end()),
+                    outer_radii.end());
+  Length inner_radius;
+  for (Length const& outer_radius : outer_radii) {
+    if (outer_radius == inner_radius) {
+      continue;
+    }
+    // The harmonics that contribute in the shell are those that contribute at
+    // its inner radius, since the thresholds are all outside of the shell.
+    int const limiting_degree =
+        std::partition_point(
+            degree_damping_.begin(),
+            degree_damping_.end(),
+            [&inner_radius](HarmonicDamping const& degree_damping) -> bool {
+              return inner_radius < degree_damping.outer_threshold();
+            }) - degree_damping_.begin();
+    shells_.push_back(
+        {outer_radius,
+         /*max_degree=*/limiting_degree - 1,
+         /*is_zonal=*/body_->is_zonal() ||
+             inner_radius >= sectoral_damping_.outer_threshold()});
+    inner_radius = outer_radius;
+  }
+  CHECK_EQ(Infinity<Length>(), shells_.back().outer_radius);
+  CHECK_EQ(1, shells_.back().max_degree);
 }
 
 template<typename Frame>
@@ -585,7 +621,7 @@ Geopotential<Frame>::SphericalHarmonicsAcceleration(
 #define PRINCIPIA_CASE_SPHERICAL_HARMONICS(d)                                  \
   case (d):                                                                    \
     return AllDegrees<std::make_integer_sequence<int, (d + 1)>>::Acceleration( \
-        *this, t, r, r_norm, r², one_over_r³)
+        *this, shell, t, r, r_norm, r², one_over_r³)
 
 template<typename Frame>
 Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
@@ -600,20 +636,8 @@ Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
     // |r_norm| when finding the partition point below.
     return NaN<ReducedAcceleration>() * Vector<double, Frame>{};
   }
-  // |limiting_degree| is the first degree such that
-  // |r_norm >= degree_damping_[limiting_degree].outer_threshold()|, or is
-  // |degree_damping_.size()| if |r_norm| is below all thresholds.
-  // Since |degree_damping_[0].outer_threshold()| and
-  // |degree_damping_[1].outer_threshold()| are infinite, |limiting_degree > 1|.
-  int const limiting_degree =
-      std::partition_point(
-          degree_damping_.begin(),
-          degree_damping_.end(),
-          [r_norm](HarmonicDamping const& degree_damping) -> bool {
-            return r_norm < degree_damping.outer_threshold();
-          }) - degree_damping_.begin();
-  // We have |max_degree > 0|.
-  int const max_degree = limiting_degree - 1;
+  Shell const& shell = FindShell(r_norm);
+  int const max_degree = shell.max_degree;
   switch (max_degree) {
     PRINCIPIA_CASE_SPHERICAL_HARMONICS(2);
     PRINCIPIA_CASE_SPHERICAL_HARMONICS(3);
@@ -687,6 +711,19 @@ HarmonicDamping const& Geopotential<Frame>::sectoral_damping() const {
   return sectoral_damping_;
 }
 
+template<typename Frame>
+auto Geopotential<Frame>::FindShell(Length const& r_norm) const
+    -> Shell const& {
+  // The last shell is excluded from the search so that an infinite |r_norm|
+  // ends up there.
+  return *std::partition_point(
+      shells_.begin(),
+      std::prev(shells_.end()),
+      [&r_norm](Shell const& shell) -> bool {
+        return shell.outer_radius <= r_norm;
+      });
+}
+
 template<typename Frame>
 Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
 Geopotential<Frame>::Degree2ZonalAcceleration(
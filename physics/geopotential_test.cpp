@@ -753,6 +753,14 @@ TEST_F(GeopotentialTest, DampedForces) {
   EXPECT_THAT(get_acceleration(earth_geopotential, 1'000'000 * Kilo(Metre)),
               Eq(get_acceleration(*geopotential_j2, 1'000'000 * Kilo(Metre))));
 
+  // Exactly at the outer threshold for C22 and S22, which is the boundary of a
+  // shell, only J2 contributes.
+  {
+    Length const s1 = earth_geopotential.sectoral_damping().outer_threshold();
+    EXPECT_THAT(get_acceleration(earth_geopotential, s1),
+                Eq(get_acceleration(*geopotential_j2, s1)));
+  }
+
   {
     // Inspect the C22 and S22 sigmoid.
     Length const s0 = earth_geopotential.sectoral_damping().inner_threshold();
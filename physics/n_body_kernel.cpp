@@ -0,0 +1,188 @@
+
+#include "physics/n_body_kernel.hpp"
+
+#include <immintrin.h>
+
+#include <cmath>
+
+#include "base/cpuid.hpp"
+#include "base/macros.hpp"
+#include "glog/logging.h"
+
+// The kernels must not contract multiplications and additions into fused
+// multiply-adds, lest they give results that differ from the scalar loop.
+#pragma STDC FP_CONTRACT OFF
+
+namespace principia {
+namespace physics {
+namespace internal_n_body_kernel {
+
+using base::HasAVX;
+
+namespace {
+
+// Accumulates the interaction between the body b1 at (x1, y1, z1) and the body
+// |b2|.  This performs exactly the operations of the scalar loop in
+// |Ephemeris|, in the same order.
+FORCE_INLINE(inline) void AccumulatePair(double const x1,
+                                         double const y1,
+                                         double const z1,
+                                         double const μ1,
+                                         int const b2,
+                                         NBodyArrays& arrays,
+                                         double& a1x,
+                                         double& a1y,
+                                         double& a1z) {
+  double const Δx = x1 - arrays.x[b2];
+  double const Δy = y1 - arrays.y[b2];
+  double const Δz = z1 - arrays.z[b2];
+
+  double const Δx² = Δx * Δx;
+  double const Δy² = Δy * Δy;
+  double const Δz² = Δz * Δz;
+  double const Δq² = Δx² + Δy² + Δz²;
+  double const Δq_norm = std::sqrt(Δq²);
+  double const Δq⁴ = Δq² * Δq²;
+  double const one_over_Δq³ = Δq_norm / Δq⁴;
+
+  double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+  double const action_x = Δx * μ1_over_Δq³;
+  double const action_y = Δy * μ1_over_Δq³;
+  double const action_z = Δz * μ1_over_Δq³;
+  arrays.ax[b2] += action_x;
+  arrays.ay[b2] += action_y;
+  arrays.az[b2] += action_z;
+
+  double const μ2_over_Δq³ = arrays.μ[b2] * one_over_Δq³;
+  double const reaction_x = Δx * μ2_over_Δq³;
+  double const reaction_y = Δy * μ2_over_Δq³;
+  double const reaction_z = Δz * μ2_over_Δq³;
+  a1x -= reaction_x;
+  a1y -= reaction_y;
+  a1z -= reaction_z;
+}
+
+void AccumulateScalar(int const b1_begin,
+                      int const b_end,
+                      NBodyArrays& arrays) {
+  for (int b1 = b1_begin; b1 < b_end; ++b1) {
+    double a1x = arrays.ax[b1];
+    double a1y = arrays.ay[b1];
+    double a1z = arrays.az[b1];
+    for (int b2 = b1 + 1; b2 < b_end; ++b2) {
+      AccumulatePair(arrays.x[b1], arrays.y[b1], arrays.z[b1], arrays.μ[b1],
+                     b2,
+                     arrays,
+                     a1x, a1y, a1z);
+    }
+    arrays.ax[b1] = a1x;
+    arrays.ay[b1] = a1y;
+    arrays.az[b1] = a1z;
+  }
+}
+
+PRINCIPIA_TARGET("avx")
+void AccumulateAVX(int const b1_begin,
+                   int const b_end,
+                   NBodyArrays& arrays) {
+  constexpr int lanes = 4;
+  double const* const x = arrays.x.data();
+  double const* const y = arrays.y.data();
+  double const* const z = arrays.z.data();
+  double const* const μ = arrays.μ.data();
+  double* const ax = arrays.ax.data();
+  double* const ay = arrays.ay.data();
+  double* const az = arrays.az.data();
+  alignas(32) double reaction_x[lanes];
+  alignas(32) double reaction_y[lanes];
+  alignas(32) double reaction_z[lanes];
+
+  for (int b1 = b1_begin; b1 < b_end; ++b1) {
+    double a1x = ax[b1];
+    double a1y = ay[b1];
+    double a1z = az[b1];
+    __m256d const x1 = _mm256_set1_pd(x[b1]);
+    __m256d const y1 = _mm256_set1_pd(y[b1]);
+    __m256d const z1 = _mm256_set1_pd(z[b1]);
+    __m256d const μ1 = _mm256_set1_pd(μ[b1]);
+
+    int b2 = b1 + 1;
+    for (; b2 + lanes <= b_end; b2 += lanes) {
+      __m256d const Δx = _mm256_sub_pd(x1, _mm256_loadu_pd(x + b2));
+      __m256d const Δy = _mm256_sub_pd(y1, _mm256_loadu_pd(y + b2));
+      __m256d const Δz = _mm256_sub_pd(z1, _mm256_loadu_pd(z + b2));
+
+      __m256d const Δq² = _mm256_add_pd(
+          _mm256_add_pd(_mm256_mul_pd(Δx, Δx), _mm256_mul_pd(Δy, Δy)),
+          _mm256_mul_pd(Δz, Δz));
+      __m256d const Δq_norm = _mm256_sqrt_pd(Δq²);
+      __m256d const one_over_Δq³ =
+          _mm256_div_pd(Δq_norm, _mm256_mul_pd(Δq², Δq²));
+
+      __m256d const μ1_over_Δq³ = _mm256_mul_pd(μ1, one_over_Δq³);
+      _mm256_storeu_pd(ax + b2,
+                       _mm256_add_pd(_mm256_loadu_pd(ax + b2),
+                                     _mm256_mul_pd(Δx, μ1_over_Δq³)));
+      _mm256_storeu_pd(ay + b2,
+                       _mm256_add_pd(_mm256_loadu_pd(ay + b2),
+                                     _mm256_mul_pd(Δy, μ1_over_Δq³)));
+      _mm256_storeu_pd(az + b2,
+                       _mm256_add_pd(_mm256_loadu_pd(az + b2),
+                                     _mm256_mul_pd(Δz, μ1_over_Δq³)));
+
+      __m256d const μ2_over_Δq³ =
+          _mm256_mul_pd(_mm256_loadu_pd(μ + b2), one_over_Δq³);
+      _mm256_store_pd(reaction_x, _mm256_mul_pd(Δx, μ2_over_Δq³));
+      _mm256_store_pd(reaction_y, _mm256_mul_pd(Δy, μ2_over_Δq³));
+      _mm256_store_pd(reaction_z, _mm256_mul_pd(Δz, μ2_over_Δq³));
+      // Sequential reduction, for reproducibility.
+      for (int i = 0; i < lanes; ++i) {
+        a1x -= reaction_x[i];
+        a1y -= reaction_y[i];
+        a1z -= reaction_z[i];
+      }
+    }
+    for (; b2 < b_end; ++b2) {
+      AccumulatePair(x[b1], y[b1], z[b1], μ[b1], b2, arrays, a1x, a1y, a1z);
+    }
+
+    ax[b1] = a1x;
+    ay[b1] = a1y;
+    az[b1] = a1z;
+  }
+}
+
+}  // namespace
+
+NBodyArrays::NBodyArrays(int const size)
+    : x(size), y(size), z(size), μ(size), ax(size), ay(size), az(size) {}
+
+NBodyKernel FastestNBodyKernel() {
+  // Note that there is no AVX-512 kernel: the throughput would be bounded by
+  // the sequential reduction of the accelerations on b1, and the 512-bit
+  // instructions lower the clock frequency.
+  static NBodyKernel const fastest_kernel =
+      HasAVX() ? NBodyKernel::AVX : NBodyKernel::Scalar;
+  return fastest_kernel;
+}
+
+void AccumulateNewtonianAccelerations(int const b1_begin,
+                                      int const b_end,
+                                      NBodyArrays& arrays,
+                                      NBodyKernel const kernel) {
+  DCHECK_LE(0, b1_begin);
+  DCHECK_LE(b_end, arrays.x.size());
+  switch (kernel) {
+    case NBodyKernel::Scalar:
+      return AccumulateScalar(b1_begin, b_end, arrays);
+    case NBodyKernel::AVX:
+      CHECK(HasAVX());
+      return AccumulateAVX(b1_begin, b_end, arrays);
+  }
+  LOG(FATAL) << "Unexpected kernel " << static_cast<int>(kernel);
+  base::noreturn();
+}
+
+}  // namespace internal_n_body_kernel
+}  // namespace physics
+}  // namespace principia
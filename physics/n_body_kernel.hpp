@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+namespace principia {
+namespace physics {
+namespace internal_n_body_kernel {
+
+// The positions, gravitational parameters and accelerations of a system of
+// massive bodies, stored as separate arrays of coordinates in SI units.  This
+// layout lets the vectorized kernels process several bodies per instruction.
+struct NBodyArrays final {
+  explicit NBodyArrays(int size);
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+  std::vector<double> μ;
+  std::vector<double> ax;
+  std::vector<double> ay;
+  std::vector<double> az;
+};
+
+enum class NBodyKernel {
+  Scalar,
+  AVX,
+};
+
+// Returns the fastest kernel supported by the processor on which we run.
+NBodyKernel FastestNBodyKernel();
+
+// For each body b1 in [b1_begin, b_end[, in increasing order, and for each body
+// b2 in ]b1, b_end[, adds to the acceleration of b2 the Newtonian attraction of
+// b1, and subtracts from the acceleration of b1 the Newtonian attraction of b2.
+// The AVX kernel processes 4 bodies b2 at a time, but it reduces the
+// accelerations on b1 in the same order as the scalar kernel, so both kernels
+// give bitwise identical results, and the integration of the solar system
+// doesn't depend on the processor.
+void AccumulateNewtonianAccelerations(int b1_begin,
+                                      int b_end,
+                                      NBodyArrays& arrays,
+                                      NBodyKernel kernel);
+
+}  // namespace internal_n_body_kernel
+
+using internal_n_body_kernel::AccumulateNewtonianAccelerations;
+using internal_n_body_kernel::FastestNBodyKernel;
+using internal_n_body_kernel::NBodyArrays;
+using internal_n_body_kernel::NBodyKernel;
+
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,78 @@
+#include "physics/n_body_kernel.hpp"
+
+#include <random>
+#include <vector>
+
+#include "base/cpuid.hpp"
+#include "glog/logging.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace physics {
+
+using base::HasAVX;
+using ::testing::ElementsAreArray;
+
+class NBodyKernelTest : public ::testing::Test {
+ protected:
+  static NBodyArrays RandomArrays(int const size) {
+    std::mt19937_64 random(size);
+    std::uniform_real_distribution<> position_distribution(-1e12, 1e12);
+    std::uniform_real_distribution<> μ_distribution(1e5, 1e20);
+    std::uniform_real_distribution<> acceleration_distribution(-1e-3, 1e-3);
+    NBodyArrays arrays(size);
+    for (int i = 0; i < size; ++i) {
+      arrays.x[i] = position_distribution(random);
+      arrays.y[i] = position_distribution(random);
+      arrays.z[i] = position_distribution(random);
+      arrays.μ[i] = μ_distribution(random);
+      arrays.ax[i] = acceleration_distribution(random);
+      arrays.ay[i] = acceleration_distribution(random);
+      arrays.az[i] = acceleration_distribution(random);
+    }
+    return arrays;
+  }
+
+  // Checks that |kernel| gives the same results as the scalar kernel, bit for
+  // bit, for a variety of sizes that exercise the remainder loops.
+  static void ExpectIdenticalToScalar(NBodyKernel const kernel) {
+    for (int size = 1; size <= 35; ++size) {
+      NBodyArrays expected = RandomArrays(size);
+      NBodyArrays actual = expected;
+      AccumulateNewtonianAccelerations(
+          size / 3, size, expected, NBodyKernel::Scalar);
+      AccumulateNewtonianAccelerations(size / 3, size, actual, kernel);
+      EXPECT_THAT(actual.ax, ElementsAreArray(expected.ax)) << size;
+      EXPECT_THAT(actual.ay, ElementsAreArray(expected.ay)) << size;
+      EXPECT_THAT(actual.az, ElementsAreArray(expected.az)) << size;
+    }
+  }
+};
+
+TEST_F(NBodyKernelTest, TwoBodies) {
+  NBodyArrays arrays(2);
+  arrays.x = {3, 0};
+  arrays.y = {0, 0};
+  arrays.z = {0, 4};
+  arrays.μ = {2, 5};
+  arrays.ax = {0, 0};
+  arrays.ay = {0, 0};
+  arrays.az = {0, 0};
+  AccumulateNewtonianAccelerations(0, 2, arrays, NBodyKernel::Scalar);
+  // The bodies are at a distance of 5.
+  EXPECT_THAT(arrays.ax, ElementsAreArray({-5.0 * 3 / 125, 2.0 * 3 / 125}));
+  EXPECT_THAT(arrays.ay, ElementsAreArray({0.0, 0.0}));
+  EXPECT_THAT(arrays.az, ElementsAreArray({5.0 * 4 / 125, -2.0 * 4 / 125}));
+}
+
+TEST_F(NBodyKernelTest, AVX) {
+  if (!HasAVX()) {
+    LOG(WARNING) << "AVX not supported, skipping test";
+    return;
+  }
+  ExpectIdenticalToScalar(NBodyKernel::AVX);
+}
+
+}  // namespace physics
+}  // namespace principia
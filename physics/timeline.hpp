@@ -0,0 +1,164 @@
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/trajectory_pyramid.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_timeline {
+
+using base::not_null;
+using geometry::Instant;
+
+// A sequence of degrees of freedom sorted by time, with the subset of the
+// interface of |std::map<Instant, DegreesOfFreedom<Frame>>| that is needed by
+// |DiscreteTrajectory|.  The points are stored contiguously in chunks whose
+// capacity grows with the size of the timeline, and the chunks are kept in a
+// sorted index that is used for searching.  This uses much less memory than a
+// map, and iterating doesn't chase pointers except at the end of a chunk.
+// Points may only be inserted and erased at either end of the timeline.
+// Iterators remain valid until the point that they designate is erased.  In
+// particular, |end()| is never invalidated and never designates a point, even
+// if points are inserted.
+// On request, the timeline also maintains a |TrajectoryPyramid| of its
+// positions, which is used to plot it at a given resolution.
+template<typename Frame>
+class Timeline final {
+  struct Chunk;
+
+ public:
+  using key_type = Instant;
+  using mapped_type = DegreesOfFreedom<Frame>;
+  using value_type = std::pair<Instant, DegreesOfFreedom<Frame>>;
+
+  class const_iterator final {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename Timeline::value_type;
+    using difference_type = std::int64_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    const_iterator() = default;
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    const_iterator& operator++();
+    const_iterator& operator--();
+    const_iterator operator++(int);
+    const_iterator operator--(int);
+
+    bool operator==(const_iterator const& right) const;
+    bool operator!=(const_iterator const& right) const;
+
+   private:
+    const_iterator(not_null<Timeline const*> timeline,
+                   Chunk const* chunk,
+                   value_type const* point);
+
+    Timeline const* timeline_ = nullptr;
+    // Both null at end.
+    Chunk const* chunk_ = nullptr;
+    value_type const* point_ = nullptr;
+
+    friend class Timeline;
+  };
+
+  Timeline() = default;
+
+  // Cannot be moved or copied because of the pointers in the iterators.
+  Timeline(Timeline const&) = delete;
+  Timeline(Timeline&&) = delete;
+  Timeline& operator=(Timeline const&) = delete;
+  Timeline& operator=(Timeline&&) = delete;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  bool empty() const;
+  std::int64_t size() const;
+
+  // The timeline must not be empty.
+  value_type const& front() const;
+  value_type const& back() const;
+
+  // Logarithmic in the size of the timeline.
+  const_iterator find(Instant const& time) const;
+  const_iterator lower_bound(Instant const& time) const;
+  const_iterator upper_bound(Instant const& time) const;
+
+  // Inserts a point at the end of the timeline.  |time| must be (strictly)
+  // after the last time of the timeline.
+  const_iterator emplace_back(
+      Instant const& time,
+      DegreesOfFreedom<Frame> const& degrees_of_freedom);
+
+  // Inserts a point at the beginning of the timeline.  |time| must be
+  // (strictly) before the first time of the timeline.
+  const_iterator emplace_front(
+      Instant const& time,
+      DegreesOfFreedom<Frame> const& degrees_of_freedom);
+
+  // Erases the points in [first, last[.  Either |first| must be |begin()| or
+  // |last| must be |end()|.
+  void erase(const_iterator first, const_iterator last);
+
+  // Builds a |TrajectoryPyramid| of the points of this timeline and maintains
+  // it as points are inserted and erased.  Linear in the size of the timeline
+  // the first time it is called, no-op afterwards.
+  void EnablePyramid();
+
+  // Null unless |EnablePyramid| has been called.
+  TrajectoryPyramid<Frame> const* pyramid() const;
+
+ private:
+  struct Chunk final {
+    explicit Chunk(std::int64_t capacity);
+
+    value_type const* live_begin() const;
+    value_type const* live_end() const;
+    bool full() const;
+
+    // Storage is reserved at construction and never reallocated, so the
+    // addresses of the points are stable.
+    std::vector<value_type> points;
+    // The points before this index have been erased.
+    std::int64_t first = 0;
+    // The neighbouring chunks in the timeline.
+    Chunk* previous = nullptr;
+    Chunk* next = nullptr;
+  };
+
+  // Returns an iterator to the first point for which |after(time, point)| is
+  // true, where |after| must be monotonic in the timeline.
+  template<typename After>
+  const_iterator Search(Instant const& time, After const& after) const;
+
+  // Sorted by time, no chunk is empty.
+  std::deque<std::unique_ptr<Chunk>> chunks_;
+  std::int64_t size_ = 0;
+  // Only built for the timelines that get plotted.
+  std::unique_ptr<TrajectoryPyramid<Frame>> pyramid_;
+};
+
+}  // namespace internal_timeline
+
+using internal_timeline::Timeline;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/timeline_body.hpp"
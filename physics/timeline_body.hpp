@@ -0,0 +1,329 @@
+#pragma once
+
+#include "physics/timeline.hpp"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace physics {
+namespace internal_timeline {
+
+// The capacity of a new chunk is the size of the timeline, clamped to this
+// interval.  Short timelines, of which there are many (e.g., forks), don't
+// waste memory, and long timelines have few chunks.
+constexpr std::int64_t min_chunk_capacity = 8;
+constexpr std::int64_t max_chunk_capacity = 4096;
+
+template<typename Frame>
+auto Timeline<Frame>::const_iterator::operator*() const -> reference {
+  DCHECK(point_ != nullptr);
+  return *point_;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::const_iterator::operator->() const -> pointer {
+  DCHECK(point_ != nullptr);
+  return point_;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::const_iterator::operator++() -> const_iterator& {
+  CHECK(chunk_ != nullptr);
+  ++point_;
+  if (point_ == chunk_->live_end()) {
+    chunk_ = chunk_->next;
+    point_ = chunk_ == nullptr ? nullptr : chunk_->live_begin();
+  }
+  return *this;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::const_iterator::operator--() -> const_iterator& {
+  if (chunk_ == nullptr) {
+    CHECK(!timeline_->empty());
+    chunk_ = timeline_->chunks_.back().get();
+    point_ = chunk_->live_end();
+  } else if (point_ == chunk_->live_begin()) {
+    chunk_ = chunk_->previous;
+    CHECK(chunk_ != nullptr);
+    point_ = chunk_->live_end();
+  }
+  --point_;
+  return *this;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::const_iterator::operator++(int) -> const_iterator {
+  const_iterator const initial = *this;
+  ++*this;
+  return initial;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::const_iterator::operator--(int) -> const_iterator {
+  const_iterator const initial = *this;
+  --*this;
+  return initial;
+}
+
+template<typename Frame>
+bool Timeline<Frame>::const_iterator::operator==(
+    const_iterator const& right) const {
+  return point_ == right.point_;
+}
+
+template<typename Frame>
+bool Timeline<Frame>::const_iterator::operator!=(
+    const_iterator const& right) const {
+  return point_ != right.point_;
+}
+
+template<typename Frame>
+Timeline<Frame>::const_iterator::const_iterator(
+    not_null<Timeline const*> const timeline,
+    Chunk const* const chunk,
+    value_type const* const point)
+    : timeline_(timeline),
+      chunk_(chunk),
+      point_(point) {}
+
+template<typename Frame>
+auto Timeline<Frame>::begin() const -> const_iterator {
+  if (chunks_.empty()) {
+    return end();
+  }
+  Chunk const* const chunk = chunks_.front().get();
+  return const_iterator(this, chunk, chunk->live_begin());
+}
+
+template<typename Frame>
+auto Timeline<Frame>::end() const -> const_iterator {
+  return const_iterator(this, /*chunk=*/nullptr, /*point=*/nullptr);
+}
+
+template<typename Frame>
+auto Timeline<Frame>::cbegin() const -> const_iterator {
+  return begin();
+}
+
+template<typename Frame>
+auto Timeline<Frame>::cend() const -> const_iterator {
+  return end();
+}
+
+template<typename Frame>
+bool Timeline<Frame>::empty() const {
+  return size_ == 0;
+}
+
+template<typename Frame>
+std::int64_t Timeline<Frame>::size() const {
+  return size_;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::front() const -> value_type const& {
+  CHECK(!empty());
+  return *chunks_.front()->live_begin();
+}
+
+template<typename Frame>
+auto Timeline<Frame>::back() const -> value_type const& {
+  CHECK(!empty());
+  return chunks_.back()->points.back();
+}
+
+template<typename Frame>
+auto Timeline<Frame>::find(Instant const& time) const -> const_iterator {
+  auto const it = lower_bound(time);
+  if (it == end() || it->first != time) {
+    return end();
+  }
+  return it;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::lower_bound(Instant const& time) const
+    -> const_iterator {
+  return Search(time, [](Instant const& t, value_type const& point) {
+    return point.first >= t;
+  });
+}
+
+template<typename Frame>
+auto Timeline<Frame>::upper_bound(Instant const& time) const
+    -> const_iterator {
+  return Search(time, [](Instant const& t, value_type const& point) {
+    return point.first > t;
+  });
+}
+
+template<typename Frame>
+auto Timeline<Frame>::emplace_back(
+    Instant const& time,
+    DegreesOfFreedom<Frame> const& degrees_of_freedom) -> const_iterator {
+  CHECK(empty() || back().first < time)
+      << "Append out of order at " << time << ", last time is "
+      << back().first;
+  if (chunks_.empty() || chunks_.back()->full()) {
+    auto chunk = std::make_unique<Chunk>(
+        std::clamp(size_, min_chunk_capacity, max_chunk_capacity));
+    if (!chunks_.empty()) {
+      chunk->previous = chunks_.back().get();
+      chunks_.back()->next = chunk.get();
+    }
+    chunks_.push_back(std::move(chunk));
+  }
+  Chunk& chunk = *chunks_.back();
+  chunk.points.emplace_back(time, degrees_of_freedom);
+  ++size_;
+  if (pyramid_ != nullptr) {
+    pyramid_->push_back(time, degrees_of_freedom.position());
+  }
+  return const_iterator(this, &chunk, &chunk.points.back());
+}
+
+template<typename Frame>
+auto Timeline<Frame>::emplace_front(
+    Instant const& time,
+    DegreesOfFreedom<Frame> const& degrees_of_freedom) -> const_iterator {
+  CHECK(empty() || time < front().first)
+      << "Prepend out of order at " << time << ", first time is "
+      << front().first;
+  // The vector of a chunk cannot grow at its front, so each point inserted
+  // here gets its own chunk.  This is fine as it only happens when attaching
+  // or detaching forks.
+  auto chunk = std::make_unique<Chunk>(/*capacity=*/1);
+  chunk->points.emplace_back(time, degrees_of_freedom);
+  if (!chunks_.empty()) {
+    chunk->next = chunks_.front().get();
+    chunks_.front()->previous = chunk.get();
+  }
+  chunks_.push_front(std::move(chunk));
+  ++size_;
+  if (pyramid_ != nullptr) {
+    pyramid_->push_front(time, degrees_of_freedom.position());
+  }
+  Chunk const* const front_chunk = chunks_.front().get();
+  return const_iterator(this, front_chunk, front_chunk->live_begin());
+}
+
+template<typename Frame>
+void Timeline<Frame>::erase(const_iterator const first,
+                            const_iterator const last) {
+  DCHECK_EQ(this, first.timeline_);
+  DCHECK_EQ(this, last.timeline_);
+  if (first == last) {
+    return;
+  }
+  std::int64_t const old_size = size_;
+  if (last == end()) {
+    // Erase a suffix.  Note that this takes care of the case where the entire
+    // timeline is erased.
+    while (chunks_.back().get() != first.chunk_) {
+      Chunk const& chunk = *chunks_.back();
+      size_ -= chunk.live_end() - chunk.live_begin();
+      chunks_.pop_back();
+    }
+    Chunk& chunk = *chunks_.back();
+    std::int64_t const kept = first.point_ - chunk.points.data();
+    size_ -= static_cast<std::int64_t>(chunk.points.size()) - kept;
+    while (static_cast<std::int64_t>(chunk.points.size()) > kept) {
+      chunk.points.pop_back();
+    }
+    if (chunk.live_begin() == chunk.live_end()) {
+      chunks_.pop_back();
+    }
+    if (!chunks_.empty()) {
+      chunks_.back()->next = nullptr;
+    }
+    if (pyramid_ != nullptr) {
+      pyramid_->erase_back(old_size - size_);
+    }
+  } else {
+    CHECK(first == begin()) << "Erasing in the middle of a timeline";
+    // Erase a prefix.  The erased points of the first remaining chunk are not
+    // destroyed until that chunk is.
+    while (chunks_.front().get() != last.chunk_) {
+      Chunk const& chunk = *chunks_.front();
+      size_ -= chunk.live_end() - chunk.live_begin();
+      chunks_.pop_front();
+    }
+    Chunk& chunk = *chunks_.front();
+    std::int64_t const first_kept = last.point_ - chunk.points.data();
+    size_ -= first_kept - chunk.first;
+    chunk.first = first_kept;
+    chunk.previous = nullptr;
+    if (pyramid_ != nullptr) {
+      pyramid_->erase_front(old_size - size_);
+    }
+  }
+}
+
+template<typename Frame>
+void Timeline<Frame>::EnablePyramid() {
+  if (pyramid_ != nullptr) {
+    return;
+  }
+  pyramid_ = std::make_unique<TrajectoryPyramid<Frame>>();
+  for (auto const& [time, degrees_of_freedom] : *this) {
+    pyramid_->push_back(time, degrees_of_freedom.position());
+  }
+}
+
+template<typename Frame>
+TrajectoryPyramid<Frame> const* Timeline<Frame>::pyramid() const {
+  return pyramid_.get();
+}
+
+template<typename Frame>
+Timeline<Frame>::Chunk::Chunk(std::int64_t const capacity) {
+  points.reserve(capacity);
+}
+
+template<typename Frame>
+auto Timeline<Frame>::Chunk::live_begin() const -> value_type const* {
+  return points.data() + first;
+}
+
+template<typename Frame>
+auto Timeline<Frame>::Chunk::live_end() const -> value_type const* {
+  return points.data() + points.size();
+}
+
+template<typename Frame>
+bool Timeline<Frame>::Chunk::full() const {
+  return points.size() == points.capacity();
+}
+
+template<typename Frame>
+template<typename After>
+auto Timeline<Frame>::Search(Instant const& time,
+                             After const& after) const -> const_iterator {
+  // Find the first chunk whose last point is after |time|.  The point we are
+  // looking for is in that chunk.
+  auto const chunk_it = std::partition_point(
+      chunks_.begin(),
+      chunks_.end(),
+      [&after, &time](std::unique_ptr<Chunk> const& chunk) {
+        return !after(time, chunk->points.back());
+      });
+  if (chunk_it == chunks_.end()) {
+    return end();
+  }
+  Chunk const* const chunk = chunk_it->get();
+  value_type const* const point = std::partition_point(
+      chunk->live_begin(),
+      chunk->live_end(),
+      [&after, &time](value_type const& point) {
+        return !after(time, point);
+      });
+  DCHECK(point != chunk->live_end());
+  return const_iterator(this, chunk, point);
+}
+
+}  // namespace internal_timeline
+}  // namespace physics
+}  // namespace principia
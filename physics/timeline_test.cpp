@@ -0,0 +1,202 @@
+
+#include "physics/timeline.hpp"
+
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_timeline {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using geometry::Velocity;
+using quantities::si::Metre;
+using quantities::si::Second;
+using ::testing::ElementsAre;
+
+class TimelineTest : public testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+
+  // Appends points at times t0_ + i s for i in [first, last[.
+  void Append(int const first, int const last) {
+    for (int i = first; i < last; ++i) {
+      timeline_.emplace_back(t(i), DegreesOfFreedomAt(i));
+    }
+  }
+
+  Instant t(int const i) const {
+    return t0_ + i * Second;
+  }
+
+  DegreesOfFreedom<World> DegreesOfFreedomAt(int const i) const {
+    return DegreesOfFreedom<World>(
+        World::origin + Displacement<World>({i * Metre, 0 * Metre, 0 * Metre}),
+        Velocity<World>());
+  }
+
+  std::vector<Instant> Times() const {
+    std::vector<Instant> result;
+    for (auto const& [time, _] : timeline_) {
+      result.push_back(time);
+    }
+    return result;
+  }
+
+  Instant const t0_;
+  Timeline<World> timeline_;
+};
+
+using TimelineDeathTest = TimelineTest;
+
+TEST_F(TimelineDeathTest, Errors) {
+  EXPECT_DEATH({
+    Append(0, 3);
+    timeline_.emplace_back(t(1), DegreesOfFreedomAt(1));
+  }, "out of order");
+  EXPECT_DEATH({
+    Append(0, 3);
+    timeline_.emplace_front(t(1), DegreesOfFreedomAt(1));
+  }, "out of order");
+  EXPECT_DEATH({
+    Append(0, 3);
+    timeline_.erase(timeline_.find(t(1)), timeline_.find(t(2)));
+  }, "middle");
+}
+
+TEST_F(TimelineTest, Empty) {
+  EXPECT_TRUE(timeline_.empty());
+  EXPECT_EQ(0, timeline_.size());
+  EXPECT_TRUE(timeline_.begin() == timeline_.end());
+  EXPECT_TRUE(timeline_.find(t0_) == timeline_.end());
+  EXPECT_TRUE(timeline_.lower_bound(t0_) == timeline_.end());
+  EXPECT_TRUE(timeline_.upper_bound(t0_) == timeline_.end());
+}
+
+TEST_F(TimelineTest, Iteration) {
+  // Enough points to fill many chunks.
+  constexpr int size = 10'000;
+  Append(0, size);
+  EXPECT_FALSE(timeline_.empty());
+  EXPECT_EQ(size, timeline_.size());
+  EXPECT_EQ(t(0), timeline_.front().first);
+  EXPECT_EQ(t(size - 1), timeline_.back().first);
+
+  int i = 0;
+  for (auto it = timeline_.begin(); it != timeline_.end(); ++it, ++i) {
+    EXPECT_EQ(t(i), it->first);
+    EXPECT_EQ(DegreesOfFreedomAt(i), it->second);
+  }
+  EXPECT_EQ(size, i);
+  for (auto it = timeline_.end(); it != timeline_.begin();) {
+    --it;
+    --i;
+    EXPECT_EQ(t(i), it->first);
+  }
+  EXPECT_EQ(0, i);
+}
+
+TEST_F(TimelineTest, Search) {
+  constexpr int size = 1000;
+  Append(0, size);
+  for (int i = 0; i < size; ++i) {
+    EXPECT_EQ(t(i), timeline_.find(t(i))->first);
+    EXPECT_TRUE(timeline_.find(t(i) + 0.5 * Second) == timeline_.end());
+    EXPECT_EQ(t(i), timeline_.lower_bound(t(i))->first);
+    EXPECT_EQ(t(i), timeline_.lower_bound(t(i) - 0.5 * Second)->first);
+    EXPECT_EQ(t(i), timeline_.upper_bound(t(i) - 0.5 * Second)->first);
+  }
+  EXPECT_TRUE(timeline_.lower_bound(t(size)) == timeline_.end());
+  EXPECT_TRUE(timeline_.upper_bound(t(size - 1)) == timeline_.end());
+  EXPECT_EQ(t(1), timeline_.upper_bound(t(0))->first);
+}
+
+TEST_F(TimelineTest, EmplaceFront) {
+  Append(2, 4);
+  timeline_.emplace_front(t(1), DegreesOfFreedomAt(1));
+  timeline_.emplace_front(t(0), DegreesOfFreedomAt(0));
+  EXPECT_EQ(4, timeline_.size());
+  EXPECT_THAT(Times(), ElementsAre(t(0), t(1), t(2), t(3)));
+  EXPECT_EQ(t(1), timeline_.find(t(1))->first);
+  EXPECT_EQ(t(2), (++timeline_.find(t(1)))->first);
+  EXPECT_EQ(t(1), (--timeline_.find(t(2)))->first);
+}
+
+TEST_F(TimelineTest, Erase) {
+  constexpr int size = 1000;
+  Append(0, size);
+  auto const it100 = timeline_.find(t(100));
+  auto const it900 = timeline_.find(t(900));
+  auto const end = timeline_.end();
+
+  timeline_.erase(timeline_.begin(), timeline_.find(t(50)));
+  timeline_.erase(timeline_.find(t(950)), timeline_.end());
+  EXPECT_EQ(900, timeline_.size());
+  EXPECT_EQ(t(50), timeline_.front().first);
+  EXPECT_EQ(t(949), timeline_.back().first);
+
+  // The iterators to the remaining points and the end are still valid.
+  EXPECT_EQ(t(100), it100->first);
+  EXPECT_EQ(t(900), it900->first);
+  EXPECT_TRUE(end == timeline_.end());
+
+  // Appending doesn't change the end.
+  Append(950, 2000);
+  EXPECT_TRUE(end == timeline_.end());
+  EXPECT_EQ(t(1999), (--timeline_.end())->first);
+  EXPECT_EQ(1950, timeline_.size());
+
+  timeline_.erase(timeline_.begin(), it100);
+  EXPECT_TRUE(it100 == timeline_.begin());
+  timeline_.erase(++timeline_.begin(), timeline_.end());
+  EXPECT_THAT(Times(), ElementsAre(t(100)));
+  timeline_.erase(timeline_.begin(), timeline_.end());
+  EXPECT_TRUE(timeline_.empty());
+  EXPECT_TRUE(timeline_.begin() == timeline_.end());
+
+  Append(0, 3);
+  EXPECT_THAT(Times(), ElementsAre(t(0), t(1), t(2)));
+}
+
+TEST_F(TimelineTest, Pyramid) {
+  Append(2, 500);
+  EXPECT_EQ(nullptr, timeline_.pyramid());
+
+  // The pyramid is built from the existing points and maintained afterwards.
+  timeline_.EnablePyramid();
+  Append(500, 1000);
+  timeline_.emplace_front(t(1), DegreesOfFreedomAt(1));
+  timeline_.erase(timeline_.begin(), timeline_.find(t(10)));
+  timeline_.erase(timeline_.find(t(900)), timeline_.end());
+  EXPECT_EQ(timeline_.size(), timeline_.pyramid()->size());
+
+  // The pyramid has the same points as the timeline.
+  std::vector<Instant> times;
+  timeline_.pyramid()->ForEachPoint(
+      t(0),
+      t(1000),
+      [](auto const&, auto const&, auto const&) { return false; },
+      [this, &times](auto const& point) {
+        int const i = static_cast<int>((point.time - t0_) / Second);
+        EXPECT_EQ(DegreesOfFreedomAt(i).position(), point.position);
+        times.push_back(point.time);
+      });
+  EXPECT_EQ(Times(), times);
+}
+
+}  // namespace internal_timeline
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "geometry/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_trajectory_pyramid {
+
+using geometry::Instant;
+using geometry::Position;
+using quantities::Length;
+
+// A multi-resolution representation of the positions of a sequence of points
+// sorted by time, used to plot long trajectories at a cost that depends on the
+// resolution of the plot rather than on the number of points.  Level 0
+// contains all the points.  Level k contains the chords between the points
+// whose index is a multiple of 2ᵏ, together with a bound on the distance
+// between the points of level 0 that each chord skips and the chord.  The
+// pyramid is maintained incrementally as points are inserted and erased at
+// either end, in amortized constant time per point.
+template<typename Frame>
+class TrajectoryPyramid final {
+ public:
+  struct Point final {
+    Instant time;
+    Position<Frame> position;
+  };
+
+  bool empty() const;
+  std::int64_t size() const;
+
+  // Inserts a point at the end (resp. the beginning) of the pyramid.  |time|
+  // must be (strictly) after (resp. before) the time of the last (resp. first)
+  // point.
+  void push_back(Instant const& time, Position<Frame> const& position);
+  void push_front(Instant const& time, Position<Frame> const& position);
+
+  // Erases the last (resp. first) |count| points.
+  void erase_back(std::int64_t count);
+  void erase_front(std::int64_t count);
+
+  // Calls |f| on a subsequence of the points whose times are in
+  // [first_time, last_time], which always includes the first and the last such
+  // points.  The subsequence is chosen greedily, preferring long chords: two
+  // consecutive points |p| and |q| of the subsequence are such that
+  // |acceptable(p, q, error)| is true, where |error| bounds the distance
+  // between the skipped points and the segment pq, or that there is no
+  // skipped point.  The cost is logarithmic in the number of points for each
+  // call to |f|.
+  template<typename Acceptable, typename F>
+  void ForEachPoint(Instant const& first_time,
+                    Instant const& last_time,
+                    Acceptable const& acceptable,
+                    F const& f) const;
+
+ private:
+  // The chords of some level k ≥ 1.  The chord j goes from the point of index
+  // j 2ᵏ to the point of index (j + 1) 2ᵏ.  The chords are contiguous and
+  // their endpoints are all in the pyramid.
+  struct Level final {
+    std::int64_t first_chord = 0;
+    std::deque<Length> errors;
+  };
+
+  // The points and chords are designated by indices that don't change when
+  // points are inserted or erased, so that the chords remain aligned.  Indices
+  // may be negative if points are inserted at the beginning.
+  Point const& point(std::int64_t index) const;
+  std::int64_t last_index() const;
+
+  // The error of the chord |chord| of |level|, which must exist.  Level 0 has
+  // no error since it doesn't skip any point.
+  Length error(int level, std::int64_t chord) const;
+
+  // Computes a bound of the error of the chord |chord| of |level| ≥ 1 from the
+  // errors of the two chords of |level - 1| that it covers.
+  Length ComputeError(int level, std::int64_t chord) const;
+
+  // The distance between |point| and the segment [|p|, |q|].
+  static Length DistanceToSegment(Position<Frame> const& point,
+                                  Position<Frame> const& p,
+                                  Position<Frame> const& q);
+
+  // The index of |points_.front()|.
+  std::int64_t first_index_ = 0;
+  std::deque<Point> points_;
+  // The level k is at index k - 1.
+  std::vector<Level> levels_;
+};
+
+}  // namespace internal_trajectory_pyramid
+
+using internal_trajectory_pyramid::TrajectoryPyramid;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/trajectory_pyramid_body.hpp"
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "physics/trajectory_pyramid.hpp"
+
+#include <algorithm>
+
+#include "geometry/grassmann.hpp"
+#include "glog/logging.h"
+#include "quantities/named_quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_trajectory_pyramid {
+
+using geometry::Displacement;
+using geometry::InnerProduct;
+using quantities::Square;
+
+template<typename Frame>
+bool TrajectoryPyramid<Frame>::empty() const {
+  return points_.empty();
+}
+
+template<typename Frame>
+std::int64_t TrajectoryPyramid<Frame>::size() const {
+  return points_.size();
+}
+
+template<typename Frame>
+void TrajectoryPyramid<Frame>::push_back(Instant const& time,
+                                         Position<Frame> const& position) {
+  CHECK(points_.empty() || points_.back().time < time)
+      << "Append out of order at " << time << ", last time is "
+      << points_.back().time;
+  points_.push_back({time, position});
+  std::int64_t const index = last_index();
+  // The new chords are the ones that end at |index|.
+  for (int level = 1;; ++level) {
+    std::int64_t const stride = std::int64_t{1} << level;
+    if (index % stride != 0 || index - stride < first_index_) {
+      break;
+    }
+    std::int64_t const chord = (index - stride) / stride;
+    if (static_cast<int>(levels_.size()) < level) {
+      levels_.emplace_back();
+    }
+    Length const chord_error = ComputeError(level, chord);
+    Level& chords = levels_[level - 1];
+    if (chords.errors.empty()) {
+      chords.first_chord = chord;
+    }
+    DCHECK_EQ(
+        chords.first_chord + static_cast<std::int64_t>(chords.errors.size()),
+        chord);
+    chords.errors.push_back(chord_error);
+  }
+}
+
+template<typename Frame>
+void TrajectoryPyramid<Frame>::push_front(Instant const& time,
+                                          Position<Frame> const& position) {
+  CHECK(points_.empty() || time < points_.front().time)
+      << "Prepend out of order at " << time << ", first time is "
+      << points_.front().time;
+  points_.push_front({time, position});
+  --first_index_;
+  std::int64_t const index = first_index_;
+  // The new chords are the ones that start at |index|.
+  for (int level = 1;; ++level) {
+    std::int64_t const stride = std::int64_t{1} << level;
+    if (index % stride != 0 || index + stride > last_index()) {
+      break;
+    }
+    std::int64_t const chord = index / stride;
+    if (static_cast<int>(levels_.size()) < level) {
+      levels_.emplace_back();
+    }
+    Length const chord_error = ComputeError(level, chord);
+    Level& chords = levels_[level - 1];
+    DCHECK(chords.errors.empty() || chords.first_chord - 1 == chord);
+    chords.first_chord = chord;
+    chords.errors.push_front(chord_error);
+  }
+}
+
+template<typename Frame>
+void TrajectoryPyramid<Frame>::erase_back(std::int64_t const count) {
+  CHECK_LE(count, size());
+  points_.erase(points_.end() - count, points_.end());
+  for (int level = 1; level <= static_cast<int>(levels_.size()); ++level) {
+    std::int64_t const stride = std::int64_t{1} << level;
+    Level& chords = levels_[level - 1];
+    while (!chords.errors.empty() &&
+           (chords.first_chord +
+            static_cast<std::int64_t>(chords.errors.size())) * stride >
+               last_index()) {
+      chords.errors.pop_back();
+    }
+  }
+}
+
+template<typename Frame>
+void TrajectoryPyramid<Frame>::erase_front(std::int64_t const count) {
+  CHECK_LE(count, size());
+  points_.erase(points_.begin(), points_.begin() + count);
+  first_index_ += count;
+  for (int level = 1; level <= static_cast<int>(levels_.size()); ++level) {
+    std::int64_t const stride = std::int64_t{1} << level;
+    Level& chords = levels_[level - 1];
+    while (!chords.errors.empty() &&
+           chords.first_chord * stride < first_index_) {
+      chords.errors.pop_front();
+      ++chords.first_chord;
+    }
+  }
+}
+
+template<typename Frame>
+template<typename Acceptable, typename F>
+void TrajectoryPyramid<Frame>::ForEachPoint(Instant const& first_time,
+                                            Instant const& last_time,
+                                            Acceptable const& acceptable,
+                                            F const& f) const {
+  auto const first = std::partition_point(
+      points_.begin(),
+      points_.end(),
+      [&first_time](Point const& point) { return point.time < first_time; });
+  auto const end = std::partition_point(
+      first,
+      points_.end(),
+      [&last_time](Point const& point) { return point.time <= last_time; });
+  if (first == end) {
+    return;
+  }
+  std::int64_t index = first_index_ + (first - points_.begin());
+  std::int64_t const last = first_index_ + (end - points_.begin()) - 1;
+  f(point(index));
+  while (index < last) {
+    // Find the coarsest chord that starts at |index| and doesn't extend beyond
+    // |last|, and refine it until it is acceptable.
+    int level = 0;
+    while (level < static_cast<int>(levels_.size())) {
+      std::int64_t const stride = std::int64_t{2} << level;
+      if (index % stride != 0 || index + stride > last) {
+        break;
+      }
+      ++level;
+    }
+    for (; level > 0; --level) {
+      std::int64_t const stride = std::int64_t{1} << level;
+      if (acceptable(point(index),
+                     point(index + stride),
+                     error(level, index / stride))) {
+        break;
+      }
+    }
+    index += std::int64_t{1} << level;
+    f(point(index));
+  }
+}
+
+template<typename Frame>
+typename TrajectoryPyramid<Frame>::Point const&
+TrajectoryPyramid<Frame>::point(std::int64_t const index) const {
+  DCHECK_LE(first_index_, index);
+  DCHECK_LE(index, last_index());
+  return points_[index - first_index_];
+}
+
+template<typename Frame>
+std::int64_t TrajectoryPyramid<Frame>::last_index() const {
+  return first_index_ + static_cast<std::int64_t>(points_.size()) - 1;
+}
+
+template<typename Frame>
+Length TrajectoryPyramid<Frame>::error(int const level,
+                                       std::int64_t const chord) const {
+  if (level == 0) {
+    return Length();
+  }
+  Level const& chords = levels_[level - 1];
+  DCHECK_LE(chords.first_chord, chord);
+  DCHECK_LT(chord - chords.first_chord, chords.errors.size());
+  return chords.errors[chord - chords.first_chord];
+}
+
+template<typename Frame>
+Length TrajectoryPyramid<Frame>::ComputeError(
+    int const level,
+    std::int64_t const chord) const {
+  // The points skipped by the chord are within the error of the two half-chords
+  // from the half-chords, and the half-chords are within the distance of their
+  // common point from the chord, since the distance to a segment is convex.
+  std::int64_t const stride = std::int64_t{1} << level;
+  std::int64_t const start = chord * stride;
+  return std::max(error(level - 1, 2 * chord),
+                  error(level - 1, 2 * chord + 1)) +
+         DistanceToSegment(point(start + stride / 2).position,
+                           point(start).position,
+                           point(start + stride).position);
+}
+
+template<typename Frame>
+Length TrajectoryPyramid<Frame>::DistanceToSegment(
+    Position<Frame> const& point,
+    Position<Frame> const& p,
+    Position<Frame> const& q) {
+  Displacement<Frame> const pq = q - p;
+  Displacement<Frame> const pm = point - p;
+  Square<Length> const pq² = pq.Norm²();
+  if (pq² == Square<Length>()) {
+    return pm.Norm();
+  }
+  double const λ = std::clamp(InnerProduct(pm, pq) / pq², 0.0, 1.0);
+  return (pm - λ * pq).Norm();
+}
+
+}  // namespace internal_trajectory_pyramid
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,166 @@
+#include "physics/trajectory_pyramid.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_trajectory_pyramid {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using quantities::Cos;
+using quantities::Sin;
+using quantities::Sqrt;
+using quantities::si::Metre;
+using quantities::si::Radian;
+using quantities::si::Second;
+using ::testing::ElementsAre;
+using ::testing::Lt;
+using ::testing::SizeIs;
+
+class TrajectoryPyramidTest : public testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+  using Point = TrajectoryPyramid<World>::Point;
+
+  // Appends points at times t0_ + i s for i in [first, last[.  The points are
+  // on a circle of radius 10 m, 1 mrad apart.
+  void Append(int const first, int const last) {
+    for (int i = first; i < last; ++i) {
+      pyramid_.push_back(t(i), PositionAt(i));
+    }
+  }
+
+  Instant t(int const i) const {
+    return t0_ + i * Second;
+  }
+
+  static Position<World> PositionAt(int const i) {
+    auto const θ = i * 1e-3 * Radian;
+    return World::origin + Displacement<World>({10 * Metre * Cos(θ),
+                                                10 * Metre * Sin(θ),
+                                                0 * Metre});
+  }
+
+  // The points returned by |ForEachPoint| with chords accepted if their error
+  // is less than |tolerance|.
+  std::vector<Point> Points(Instant const& first_time,
+                            Instant const& last_time,
+                            Length const& tolerance) const {
+    std::vector<Point> points;
+    pyramid_.ForEachPoint(
+        first_time,
+        last_time,
+        [&tolerance](Point const&, Point const&, Length const& error) {
+          return error <= tolerance;
+        },
+        [&points](Point const& point) { points.push_back(point); });
+    return points;
+  }
+
+  std::vector<Instant> Times(std::vector<Point> const& points) const {
+    std::vector<Instant> times;
+    for (auto const& point : points) {
+      times.push_back(point.time);
+    }
+    return times;
+  }
+
+  // Checks that the points of the circle skipped by |points| are within
+  // |tolerance| of the chords.  This uses the sagitta of the chords, which
+  // is exact for a circle.
+  void CheckTolerance(std::vector<Point> const& points,
+                      Length const& tolerance) const {
+    for (int i = 0; i + 1 < points.size(); ++i) {
+      auto const chord = points[i + 1].position - points[i].position;
+      auto const half_chord = 0.5 * chord.Norm();
+      Length const radius = 10 * Metre;
+      Length const sagitta =
+          radius - Sqrt(radius * radius - half_chord * half_chord);
+      EXPECT_THAT(sagitta, Lt(tolerance * (1 + 1e-9))) << i;
+    }
+  }
+
+  Instant const t0_;
+  TrajectoryPyramid<World> pyramid_;
+};
+
+TEST_F(TrajectoryPyramidTest, Empty) {
+  EXPECT_TRUE(pyramid_.empty());
+  EXPECT_EQ(0, pyramid_.size());
+  EXPECT_THAT(Points(t(0), t(10), 1 * Metre), SizeIs(0));
+}
+
+TEST_F(TrajectoryPyramidTest, AllPoints) {
+  Append(0, 10);
+  EXPECT_EQ(10, pyramid_.size());
+  EXPECT_THAT(Times(Points(t(2), t(5), 0 * Metre)),
+              ElementsAre(t(2), t(3), t(4), t(5)));
+  EXPECT_THAT(Times(Points(t(2) - 0.5 * Second, t(5) + 0.5 * Second,
+                           0 * Metre)),
+              ElementsAre(t(2), t(3), t(4), t(5)));
+  EXPECT_THAT(Times(Points(t(3) + 0.5 * Second, t(3) + 0.7 * Second,
+                           0 * Metre)),
+              SizeIs(0));
+}
+
+TEST_F(TrajectoryPyramidTest, Coarse) {
+  constexpr int size = 100'000;
+  Append(0, size);
+  // The points are 5 μm from the chords between their neighbours.
+  EXPECT_THAT(Points(t(0), t(size - 1), 1 * Metre / 1e6), SizeIs(size));
+  for (Length const tolerance :
+       {1 * Metre / 1e3, 1 * Metre / 1e2, 1 * Metre / 10}) {
+    auto const points = Points(t(0), t(size - 1), tolerance);
+    EXPECT_EQ(t(0), points.front().time);
+    EXPECT_EQ(t(size - 1), points.back().time);
+    EXPECT_THAT(points, SizeIs(Lt(size / 10)));
+    CheckTolerance(points, tolerance);
+  }
+
+  // Far fewer points are needed at a coarse tolerance.
+  EXPECT_THAT(Points(t(0), t(size - 1), 1 * Metre), SizeIs(Lt(1000)));
+}
+
+TEST_F(TrajectoryPyramidTest, Erase) {
+  constexpr int size = 10'000;
+  Append(0, size);
+  pyramid_.erase_front(1234);
+  pyramid_.erase_back(567);
+  EXPECT_EQ(size - 1234 - 567, pyramid_.size());
+  Append(size - 567, size + 1000);
+  for (int i = 1233; i >= 1000; --i) {
+    pyramid_.push_front(t(i), PositionAt(i));
+  }
+  EXPECT_EQ(size, pyramid_.size());
+
+  for (Length const tolerance : {1 * Metre / 1e3, 1 * Metre / 10}) {
+    auto const points = Points(t(0), t(size + 1000), tolerance);
+    EXPECT_EQ(t(1000), points.front().time);
+    EXPECT_EQ(t(size + 999), points.back().time);
+    CheckTolerance(points, tolerance);
+  }
+
+  pyramid_.erase_back(pyramid_.size());
+  EXPECT_TRUE(pyramid_.empty());
+  Append(0, 3);
+  EXPECT_THAT(Times(Points(t(0), t(2), 1 * Metre)), ElementsAre(t(0), t(2)));
+}
+
+}  // namespace internal_trajectory_pyramid
+}  // namespace physics
+}  // namespace principia